@@ -0,0 +1,300 @@
+/*
+ //  allocator.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the allocators for the matrix and vector storage and the buffer owning that storage
+ */
+#ifndef allocator_h
+#define allocator_h
+
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace assignment {
+
+/*! allocator handing out storage aligned to tpAlignment bytes (a cache line by default)
+ \tparam tpDataType element type
+ \tparam tpAlignment alignment in bytes; a power of two not smaller than alignof(tpDataType)
+ */
+template<typename tpDataType, std::size_t tpAlignment = 64>
+struct aligned_allocator {
+
+    static_assert(tpAlignment >= alignof(tpDataType) && (tpAlignment & (tpAlignment - 1)) == 0, "alignment must be a power of two");
+
+    using value_type = tpDataType;
+
+    static constexpr std::size_t alignment = tpAlignment;
+
+    template<typename tpOther>
+    struct rebind {
+        using other = aligned_allocator<tpOther, tpAlignment>;
+    };
+
+    aligned_allocator() noexcept = default;
+
+    template<typename tpOther>
+    aligned_allocator(aligned_allocator<tpOther, tpAlignment> const &) noexcept
+    {
+    }
+
+    /*! storage for xx_count elements; nullptr for zero elements
+     \throw std::bad_alloc
+     */
+    tpDataType * allocate(std::size_t const xx_count)
+    {
+        if (xx_count == 0)
+            return nullptr;
+        if (xx_count > std::numeric_limits<std::size_t>::max() / sizeof(tpDataType))
+            throw std::bad_array_new_length();
+        return static_cast<tpDataType *>(::operator new(xx_count * sizeof(tpDataType), std::align_val_t(tpAlignment)));
+    }
+
+    void deallocate(tpDataType * xx_ptr, std::size_t) noexcept
+    {
+        ::operator delete(xx_ptr, std::align_val_t(tpAlignment));
+    }
+};
+
+template<typename tpLeft, typename tpRight, std::size_t tpAlignment>
+bool operator==(aligned_allocator<tpLeft, tpAlignment> const &, aligned_allocator<tpRight, tpAlignment> const &) noexcept
+{
+    return true;
+}
+
+template<typename tpLeft, typename tpRight, std::size_t tpAlignment>
+bool operator!=(aligned_allocator<tpLeft, tpAlignment> const &, aligned_allocator<tpRight, tpAlignment> const &) noexcept
+{
+    return false;
+}
+
+namespace detail {
+
+/*! per-thread cache of released blocks, keyed by their size in bytes
+ \tparam tpAlignment alignment of the cached blocks
+ \note a block released on another thread than the one it came from simply joins the releasing thread's cache.
+ */
+template<std::size_t tpAlignment>
+class buffer_pool {
+public:
+
+    /*! number of blocks kept per size; blocks beyond that go back to the system
+     */
+    static constexpr std::size_t max_cached = 64;
+
+    buffer_pool() = default;
+    buffer_pool(buffer_pool const &) = delete;
+    buffer_pool & operator=(buffer_pool const &) = delete;
+
+    ~buffer_pool()
+    {
+        for (auto & size_class : m_free) {
+            for (void * block : size_class.second)
+                ::operator delete(block, std::align_val_t(tpAlignment));
+        }
+        destroyed() = true;
+    }
+
+    /*! pool of the calling thread, or nullptr while the thread is shutting down
+     */
+    static buffer_pool * local()
+    {
+        if (destroyed())
+            return nullptr;
+        thread_local buffer_pool pool;
+        return &pool;
+    }
+
+    void * acquire(std::size_t const xx_bytes)
+    {
+        auto const size_class = m_free.find(xx_bytes);
+        if (size_class != m_free.end() && !size_class->second.empty()) {
+            void * const block = size_class->second.back();
+            size_class->second.pop_back();
+            return block;
+        }
+        return ::operator new(xx_bytes, std::align_val_t(tpAlignment));
+    }
+
+    void release(void * xx_block, std::size_t const xx_bytes)
+    {
+        auto & size_class = m_free[xx_bytes];
+        if (size_class.size() < max_cached)
+            size_class.push_back(xx_block);
+        else
+            ::operator delete(xx_block, std::align_val_t(tpAlignment));
+    }
+
+private:
+
+    static bool & destroyed()
+    {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    std::unordered_map<std::size_t, std::vector<void *>> m_free;
+};
+
+}
+
+/*! aligned allocator recycling blocks of the same size through a per-thread pool
+ \tparam tpDataType element type
+ \tparam tpAlignment alignment in bytes
+ \note meant for workloads creating many short-lived matrices or vectors of the same shape; after warm-up they are served
+ from the pool without touching malloc.
+ */
+template<typename tpDataType, std::size_t tpAlignment = 64>
+struct pool_allocator {
+
+    static_assert(tpAlignment >= alignof(tpDataType) && (tpAlignment & (tpAlignment - 1)) == 0, "alignment must be a power of two");
+
+    using value_type = tpDataType;
+
+    static constexpr std::size_t alignment = tpAlignment;
+
+    template<typename tpOther>
+    struct rebind {
+        using other = pool_allocator<tpOther, tpAlignment>;
+    };
+
+    pool_allocator() noexcept = default;
+
+    template<typename tpOther>
+    pool_allocator(pool_allocator<tpOther, tpAlignment> const &) noexcept
+    {
+    }
+
+    /*! storage for xx_count elements; nullptr for zero elements
+     \throw std::bad_alloc
+     */
+    tpDataType * allocate(std::size_t const xx_count)
+    {
+        if (xx_count == 0)
+            return nullptr;
+        if (xx_count > std::numeric_limits<std::size_t>::max() / sizeof(tpDataType))
+            throw std::bad_array_new_length();
+
+        std::size_t const bytes = xx_count * sizeof(tpDataType);
+        auto * const pool = detail::buffer_pool<tpAlignment>::local();
+        void * const block = pool != nullptr ? pool->acquire(bytes) : ::operator new(bytes, std::align_val_t(tpAlignment));
+        return static_cast<tpDataType *>(block);
+    }
+
+    void deallocate(tpDataType * xx_ptr, std::size_t const xx_count) noexcept
+    {
+        if (xx_ptr == nullptr)
+            return;
+        auto * const pool = detail::buffer_pool<tpAlignment>::local();
+        if (pool != nullptr)
+            pool->release(xx_ptr, xx_count * sizeof(tpDataType));
+        else
+            ::operator delete(xx_ptr, std::align_val_t(tpAlignment));
+    }
+};
+
+template<typename tpLeft, typename tpRight, std::size_t tpAlignment>
+bool operator==(pool_allocator<tpLeft, tpAlignment> const &, pool_allocator<tpRight, tpAlignment> const &) noexcept
+{
+    return true;
+}
+
+template<typename tpLeft, typename tpRight, std::size_t tpAlignment>
+bool operator!=(pool_allocator<tpLeft, tpAlignment> const &, pool_allocator<tpRight, tpAlignment> const &) noexcept
+{
+    return false;
+}
+
+/*! owning, move-only array of default-initialised elements obtained from an allocator
+ \tparam tpDataType element type
+ \tparam tpAllocatorType allocator; aligned_allocator, pool_allocator or any standard conforming allocator
+ \note drop-in for the std::unique_ptr<tpDataType[]> the storage used to be
+ */
+template<typename tpDataType, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class buffer {
+public:
+
+    using allocator_type = tpAllocatorType;
+
+    explicit buffer(std::size_t const xx_count = 0, allocator_type const & xx_allocator = allocator_type()) :
+                    m_allocator(xx_allocator),
+                    m_count(xx_count),
+                    m_data(std::allocator_traits<allocator_type>::allocate(m_allocator, xx_count))
+    {
+        try {
+            std::uninitialized_default_construct_n(m_data, m_count);
+        } catch (...) {
+            std::allocator_traits<allocator_type>::deallocate(m_allocator, m_data, m_count);
+            throw;
+        }
+    }
+
+    buffer(buffer const &) = delete;
+    buffer & operator=(buffer const &) = delete;
+
+    buffer(buffer && xx_buffer) noexcept :
+                    m_allocator(std::move(xx_buffer.m_allocator)),
+                    m_count(xx_buffer.m_count),
+                    m_data(xx_buffer.m_data)
+    {
+        xx_buffer.m_count = 0;
+        xx_buffer.m_data = nullptr;
+    }
+
+    buffer & operator=(buffer && xx_buffer) noexcept
+    {
+        if (this != &xx_buffer) {
+            release();
+            m_allocator = std::move(xx_buffer.m_allocator);
+            m_count = xx_buffer.m_count;
+            m_data = xx_buffer.m_data;
+            xx_buffer.m_count = 0;
+            xx_buffer.m_data = nullptr;
+        }
+        return *this;
+    }
+
+    ~buffer()
+    {
+        release();
+    }
+
+    tpDataType * get() const noexcept
+    {
+        return m_data;
+    }
+
+    tpDataType & operator[](std::size_t const xx_idx) const noexcept
+    {
+        return m_data[xx_idx];
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+private:
+
+    void release() noexcept
+    {
+        if (m_data != nullptr) {
+            std::destroy_n(m_data, m_count);
+            std::allocator_traits<allocator_type>::deallocate(m_allocator, m_data, m_count);
+        }
+    }
+
+    allocator_type m_allocator;
+    std::size_t m_count;
+    tpDataType * m_data;
+};
+
+}
+
+#endif /* allocator_h */
@@ -0,0 +1,541 @@
+/*
+ //  batch.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the template for a batch of independent matrices of the same shape in one buffer.
+ Small matrices (Ex: 4x4 to 32x32) are too small for the packed GEMM and the SIMD kernels of assignment::matrix; in the
+ interleaved layout the kernels instead run across the batch, one matrix per SIMD lane.
+ */
+#ifndef batch_h
+#define batch_h
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace assignment {
+
+/*! storage order of a batch of matrices
+ */
+enum class batch_layout {
+    contiguous, //!< each matrix row-major, one after the other
+    interleaved //!< blocks of batch_lanes matrices; within a block element (R, C) of all the matrices is adjacent
+};
+
+namespace detail {
+
+/*! matrices per block of the interleaved layout; a row of the block fills whole cache lines and SIMD registers
+ */
+constexpr std::size_t batch_lanes = 16;
+
+/*! tile of C the interleaved kernel keeps in registers, in elements of every matrix of the block
+ */
+struct batch_blocking {
+    static constexpr std::size_t ROWS = 2;
+    static constexpr std::size_t COLS = 4;
+};
+
+/*! fewest operations a thread works on in a batch kernel; below this the threading overhead dominates
+ */
+constexpr std::size_t batch_min_chunk = std::size_t(1) << 15;
+
+/*! calls xx_function(first, last) for consecutive ranges covering [0, xx_count), on all threads of the pool if tpParallel
+ \param xx_work operations per item
+ */
+template<bool tpParallel, typename tpFunction>
+void for_each_chunk(std::size_t const xx_count, std::size_t const xx_work, tpFunction const & xx_function)
+{
+    std::size_t chunks = 1;
+    if (tpParallel && xx_count * xx_work >= 2 * batch_min_chunk)
+        chunks = std::min(xx_count, std::min(4 * pool_threads(), xx_count * xx_work / batch_min_chunk));
+    if (chunks == 1) {
+        xx_function(std::size_t(0), xx_count);
+        return;
+    }
+    parallel_for(chunks, [&](std::size_t const xx_chunk) {
+        xx_function(xx_count * xx_chunk / chunks, xx_count * (xx_chunk + 1) / chunks);
+    });
+}
+
+/*! sums for a tpRows x tpCols tile of C at (xx_i, xx_j), for one block of batch_lanes interleaved matrices
+ \param xx_right B of the block with its columns stored one after the other, so both operands are read contiguously in k
+ \note every element is summed in ascending k, like the matrix product; the lanes are independent products, so the lane
+ loops vectorize without reordering any sum. The tile stays in registers, and every load of A and B serves several of its
+ elements.
+ */
+template<std::size_t tpRows, std::size_t tpCols, typename tpDataType>
+void batch_multiply_tile(std::size_t const xx_i, std::size_t const xx_j, std::size_t const xx_N, std::size_t const xx_K,
+                         tpDataType const * xx_left, tpDataType const * xx_right, tpDataType * xx_result)
+{
+    constexpr std::size_t L = batch_lanes;
+    tpDataType sum[tpRows][tpCols][L] = {};
+    for (std::size_t k = 0; k < xx_K; ++k) {
+        for (std::size_t r = 0; r < tpRows; ++r) {
+            tpDataType const * const a = xx_left + ((xx_i + r) * xx_K + k) * L;
+            for (std::size_t c = 0; c < tpCols; ++c) {
+                tpDataType const * const b = xx_right + ((xx_j + c) * xx_K + k) * L;
+                for (std::size_t l = 0; l < L; ++l)
+                    sum[r][c][l] += a[l] * b[l];
+            }
+        }
+    }
+    for (std::size_t r = 0; r < tpRows; ++r)
+        std::copy_n(&sum[r][0][0], tpCols * L, xx_result + ((xx_i + r) * xx_N + xx_j) * L);
+}
+
+/*! C = A * B for the rows [xx_i, xx_i + tpRows) of one block of batch_lanes interleaved matrices
+ */
+template<std::size_t tpRows, typename tpDataType>
+void batch_multiply_rows(std::size_t const xx_i, std::size_t const xx_N, std::size_t const xx_K,
+                         tpDataType const * xx_left, tpDataType const * xx_right, tpDataType * xx_result)
+{
+    constexpr std::size_t COLS = batch_blocking::COLS;
+    std::size_t j = 0;
+    for (; j + COLS <= xx_N; j += COLS)
+        batch_multiply_tile<tpRows, COLS>(xx_i, j, xx_N, xx_K, xx_left, xx_right, xx_result);
+    for (; j < xx_N; ++j)
+        batch_multiply_tile<tpRows, 1>(xx_i, j, xx_N, xx_K, xx_left, xx_right, xx_result);
+}
+
+/*! C = A * B for one block of batch_lanes interleaved matrices, A being xx_M x xx_K and B xx_K x xx_N
+ \note B is first copied column by column into a buffer of the calling thread: read in place, successive k would be a whole
+ row of the block apart (4 KiB for 32 x 32 double matrices) and evict each other from L1.
+ */
+template<typename tpDataType>
+void batch_multiply_lanes(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+                          tpDataType const * xx_left, tpDataType const * xx_right, tpDataType * xx_result)
+{
+    constexpr std::size_t L = batch_lanes;
+    constexpr std::size_t ROWS = batch_blocking::ROWS;
+
+    thread_local std::vector<tpDataType> columns;
+    columns.resize(xx_K * xx_N * L);
+    for (std::size_t k = 0; k < xx_K; ++k) {
+        for (std::size_t j = 0; j < xx_N; ++j)
+            std::copy_n(xx_right + (k * xx_N + j) * L, L, columns.data() + (j * xx_K + k) * L);
+    }
+
+    std::size_t i = 0;
+    for (; i + ROWS <= xx_M; i += ROWS)
+        batch_multiply_rows<ROWS>(i, xx_N, xx_K, xx_left, columns.data(), xx_result);
+    for (; i < xx_M; ++i)
+        batch_multiply_rows<1>(i, xx_N, xx_K, xx_left, columns.data(), xx_result);
+}
+
+/*! C = A * B for one row-major matrix of a contiguous batch
+ \note C is built up a row of B at a time, so the innermost loop runs along the rows of B and C; each element is summed in
+ ascending k like the matrix product.
+ */
+template<typename tpDataType>
+void batch_multiply_single(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+                           tpDataType const * xx_left, tpDataType const * xx_right, tpDataType * xx_result)
+{
+    for (std::size_t i = 0; i < xx_M; ++i) {
+        tpDataType * const row = xx_result + i * xx_N;
+        std::fill(row, row + xx_N, static_cast<tpDataType>(0));
+        for (std::size_t k = 0; k < xx_K; ++k) {
+            tpDataType const a = xx_left[i * xx_K + k];
+            tpDataType const * const b = xx_right + k * xx_N;
+            for (std::size_t j = 0; j < xx_N; ++j)
+                row[j] += a * b[j];
+        }
+    }
+}
+
+}
+
+/*! batch of matrices of the same dimensions in a single buffer
+ \tparam tpDataType element type
+ \tparam tpLayout batch_layout::interleaved (the default, vectorized across the batch) or batch_layout::contiguous
+ \tparam tpPolicyType policy of the matrices; under Parallel the batch kernels split the batch over the thread pool
+ \tparam tpAllocatorType allocator of the storage
+ \note a batch of vectors is a batch of K x 1 matrices, so the batched matrix-vector product is operator* as well. The
+ interleaved layout pads the batch to a multiple of batch_lanes with zero matrices, which the kernels process along.
+ */
+template<typename tpDataType, batch_layout tpLayout = batch_layout::interleaved, template<typename > class tpPolicyType = NonParallel,
+                typename tpAllocatorType = aligned_allocator<tpDataType>>
+class batch_matrix {
+public:
+
+    /*! type for the elements of the matrices
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the batch
+     */
+    using size_type = std::size_t;
+
+    /*! type of a single matrix of the batch
+     */
+    using matrix_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    static constexpr batch_layout layout = tpLayout;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor
+     \param xx_count number of matrices
+     \param xx_dimR row dimension of every matrix
+     \param xx_dimC column dimension of every matrix
+     */
+    explicit batch_matrix(size_type const xx_count, size_type const xx_dimR, size_type const xx_dimC) :
+                    m_count(xx_count),
+                    m_dimR(xx_dimR),
+                    m_dimC(xx_dimC),
+                    m_data(padded(xx_count) * xx_dimR * xx_dimC)
+    {
+        clear_padding();
+    }
+
+    /*! constructor
+     \param xx_value value to be filled in every matrix
+     */
+    explicit batch_matrix(size_type const xx_count, size_type const xx_dimR, size_type const xx_dimC, tpDataType const xx_value) :
+                    batch_matrix(xx_count, xx_dimR, xx_dimC)
+    {
+        std::fill(m_data.get(), m_data.get() + storage(), xx_value);
+        clear_padding();
+    }
+
+    /*! constructor from separate matrices
+     \throw std::domain_error if the matrices have different dimensions
+     */
+    template<template<typename > class tpOtherPolicyType, typename tpOtherAllocatorType>
+    explicit batch_matrix(std::vector<matrix<tpDataType, tpOtherPolicyType, tpOtherAllocatorType>> const & xx_matrices) :
+                    batch_matrix(xx_matrices.size(), xx_matrices.empty() ? 0 : xx_matrices.front().dimR(),
+                                 xx_matrices.empty() ? 0 : xx_matrices.front().dimC())
+    {
+        for (size_type b = 0; b < m_count; ++b)
+            set(b, xx_matrices[b]);
+    }
+
+    /*! constructor from the other layout
+     */
+    template<batch_layout tpOtherLayout, typename std::enable_if<tpOtherLayout != tpLayout>::type* = nullptr>
+    explicit batch_matrix(batch_matrix<tpDataType, tpOtherLayout, tpPolicyType, tpAllocatorType> const & xx_batch) :
+                    batch_matrix(xx_batch.count(), xx_batch.dimR(), xx_batch.dimC())
+    {
+        for (size_type b = 0; b < m_count; ++b) {
+            for (size_type i = 0; i < size(); ++i)
+                m_data[index(b, i)] = xx_batch.data()[xx_batch.index(b, i)];
+        }
+    }
+
+    batch_matrix(batch_matrix const & xx_batch) :
+                    m_count(xx_batch.m_count),
+                    m_dimR(xx_batch.m_dimR),
+                    m_dimC(xx_batch.m_dimC),
+                    m_data(xx_batch.storage())
+    {
+        std::copy_n(xx_batch.m_data.get(), storage(), m_data.get());
+    }
+
+    batch_matrix(batch_matrix && xx_batch) noexcept :
+                    m_count(xx_batch.m_count),
+                    m_dimR(xx_batch.m_dimR),
+                    m_dimC(xx_batch.m_dimC),
+                    m_data(std::move(xx_batch.m_data))
+    {
+        xx_batch.m_count = 0;
+    }
+
+    batch_matrix & operator=(batch_matrix const & xx_batch)
+    {
+        if (this != &xx_batch) {
+            batch_matrix copy(xx_batch);
+            (*this) = std::move(copy);
+        }
+        return *this;
+    }
+
+    batch_matrix & operator=(batch_matrix && xx_batch) noexcept
+    {
+        m_count = xx_batch.m_count;
+        m_dimR = xx_batch.m_dimR;
+        m_dimC = xx_batch.m_dimC;
+        m_data = std::move(xx_batch.m_data);
+        xx_batch.m_count = 0;
+        return *this;
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    /*! \throw std::domain_error if the batches differ in count or dimensions
+     */
+    batch_matrix & operator+=(batch_matrix const & xx_batch)
+    {
+        check_same(xx_batch);
+        elementwise<detail::simd::op::add>(m_data.get(), m_data.get(), xx_batch.m_data.get(), storage());
+        return *this;
+    }
+
+    /*! \throw std::domain_error if the batches differ in count or dimensions
+     */
+    batch_matrix & operator-=(batch_matrix const & xx_batch)
+    {
+        check_same(xx_batch);
+        elementwise<detail::simd::op::sub>(m_data.get(), m_data.get(), xx_batch.m_data.get(), storage());
+        return *this;
+    }
+
+    batch_matrix & operator*=(tpDataType const & xx_scalar)
+    {
+        constexpr bool parallel = tpPolicyType<matrix_type>::is_parallel;
+        tpDataType * const data = m_data.get();
+        detail::for_each_chunk<parallel>(storage(), 1, [&](std::size_t const xx_first, std::size_t const xx_last) {
+            detail::simd::broadcast<detail::simd::op::mul>(data + xx_first, data + xx_first, xx_scalar, xx_last - xx_first);
+        });
+        return *this;
+    }
+
+    /*! element (R, C) of matrix xx_b
+     */
+    tpDataType const & operator()(size_type const xx_b, size_type const xx_R, size_type const xx_C) const
+    {
+        return m_data[index(xx_b, xx_R * m_dimC + xx_C)];
+    }
+
+    tpDataType & operator()(size_type const xx_b, size_type const xx_R, size_type const xx_C)
+    {
+        return m_data[index(xx_b, xx_R * m_dimC + xx_C)];
+    }
+
+    /*! copy of matrix xx_b
+     */
+    matrix_type get(size_type const xx_b) const
+    {
+        matrix_type result(m_dimR, m_dimC);
+        for (size_type i = 0; i < size(); ++i)
+            result.data()[i] = m_data[index(xx_b, i)];
+        return result;
+    }
+
+    /*! overwrites matrix xx_b
+     \throw std::domain_error if xx_matrix has other dimensions than the batch
+     */
+    template<template<typename > class tpOtherPolicyType, typename tpOtherAllocatorType>
+    void set(size_type const xx_b, matrix<tpDataType, tpOtherPolicyType, tpOtherAllocatorType> const & xx_matrix)
+    {
+        if (xx_matrix.dimR() != m_dimR || xx_matrix.dimC() != m_dimC)
+            throw std::domain_error("Dimensions of the matrices are not equal");
+        for (size_type i = 0; i < size(); ++i)
+            m_data[index(xx_b, i)] = xx_matrix.data()[i];
+    }
+
+    /* ==== g  e  t  t  e  r  s ==== */
+
+    /*! number of matrices
+     */
+    size_type count() const
+    {
+        return m_count;
+    }
+
+    size_type dimR() const
+    {
+        return m_dimR;
+    }
+
+    size_type dimC() const
+    {
+        return m_dimC;
+    }
+
+    /*! number of elements of each matrix
+     */
+    size_type size() const
+    {
+        return m_dimR * m_dimC;
+    }
+
+    /*! number of elements in the buffer, including the padding of the interleaved layout
+     */
+    size_type storage() const
+    {
+        return padded(m_count) * size();
+    }
+
+    /*! position in data() of element xx_i (row-major) of matrix xx_b
+     */
+    size_type index(size_type const xx_b, size_type const xx_i) const
+    {
+        if (tpLayout == batch_layout::contiguous)
+            return xx_b * size() + xx_i;
+        constexpr size_type L = detail::batch_lanes;
+        return ((xx_b / L) * size() + xx_i) * L + xx_b % L;
+    }
+
+    tpDataType const * data() const
+    {
+        return m_data.get();
+    }
+
+    tpDataType * data()
+    {
+        return m_data.get();
+    }
+
+    /*! \throw std::domain_error if xx_batch differs from (*this) in count or dimensions
+     */
+    void check_same(batch_matrix const & xx_batch) const
+    {
+        if (m_count != xx_batch.m_count || m_dimR != xx_batch.m_dimR || m_dimC != xx_batch.m_dimC)
+            throw std::domain_error("Dimensions of the batches are not equal");
+    }
+
+    /*! xx_out = xx_left (op) xx_right on xx_n elements, in chunks over the threads under Parallel
+     */
+    template<detail::simd::op tpOp>
+    static void elementwise(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const * xx_right, std::size_t const xx_n)
+    {
+        constexpr bool parallel = tpPolicyType<matrix_type>::is_parallel;
+        detail::for_each_chunk<parallel>(xx_n, 1, [&](std::size_t const xx_first, std::size_t const xx_last) {
+            detail::simd::binary<tpOp>(xx_out + xx_first, xx_left + xx_first, xx_right + xx_first, xx_last - xx_first);
+        });
+    }
+
+private:
+
+    /*! zeroes the unused lanes of the last interleaved block, so the kernels never see uninitialised values there
+     */
+    void clear_padding()
+    {
+        for (size_type b = m_count; b < padded(m_count); ++b) {
+            for (size_type i = 0; i < size(); ++i)
+                m_data[index(b, i)] = static_cast<tpDataType>(0);
+        }
+    }
+
+    /*! number of matrices the buffer holds
+     */
+    static size_type padded(size_type const xx_count)
+    {
+        if (tpLayout == batch_layout::contiguous)
+            return xx_count;
+        return (xx_count + detail::batch_lanes - 1) / detail::batch_lanes * detail::batch_lanes;
+    }
+
+    size_type m_count;
+    size_type m_dimR;
+    size_type m_dimC;
+    buffer<tpDataType, tpAllocatorType> m_data;
+};
+
+/* ==== f  r  e  e     o  p  e  r  a  t  o  r  s ==== */
+
+/*! \throw std::domain_error if the batches differ in count or dimensions
+ */
+template<typename tpDataType, batch_layout tpLayout, template<typename > class tpPolicyType, typename tpAllocatorType>
+batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> operator+(batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> const & xx_left,
+                                                                            batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> const & xx_right)
+{
+    using batch = batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType>;
+    xx_left.check_same(xx_right);
+    batch result(xx_left.count(), xx_left.dimR(), xx_left.dimC());
+    batch::template elementwise<detail::simd::op::add>(result.data(), xx_left.data(), xx_right.data(), result.storage());
+    return result;
+}
+
+/*! \throw std::domain_error if the batches differ in count or dimensions
+ */
+template<typename tpDataType, batch_layout tpLayout, template<typename > class tpPolicyType, typename tpAllocatorType>
+batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> operator-(batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> const & xx_left,
+                                                                            batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> const & xx_right)
+{
+    using batch = batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType>;
+    xx_left.check_same(xx_right);
+    batch result(xx_left.count(), xx_left.dimR(), xx_left.dimC());
+    batch::template elementwise<detail::simd::op::sub>(result.data(), xx_left.data(), xx_right.data(), result.storage());
+    return result;
+}
+
+template<typename tpDataType, batch_layout tpLayout, template<typename > class tpPolicyType, typename tpAllocatorType>
+batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> operator*(batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> xx_batch,
+                                                                            tpDataType const & xx_scalar)
+{
+    xx_batch *= xx_scalar;
+    return xx_batch;
+}
+
+template<typename tpDataType, batch_layout tpLayout, template<typename > class tpPolicyType, typename tpAllocatorType>
+batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> operator*(tpDataType const & xx_scalar,
+                                                                            batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> xx_batch)
+{
+    xx_batch *= xx_scalar;
+    return xx_batch;
+}
+
+/*! batched matrix multiplication: result b = left b * right b for every b
+ \note the interleaved layout multiplies batch_lanes matrices at once, one per SIMD lane; the contiguous layout multiplies
+ them one by one. Under Parallel the batch is split into chunks over the thread pool. Every result is identical to the
+ product of the single matrices with the NonParallel policy.
+ \throw std::domain_error if the batches differ in count or Number of columns_A != Number of rows_B
+ */
+template<typename tpDataType, batch_layout tpLayout, template<typename > class tpPolicyType, typename tpAllocatorType>
+batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> operator*(batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> const & xx_left,
+                                                                            batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> const & xx_right)
+{
+    using batch = batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType>;
+    if (xx_left.count() != xx_right.count())
+        throw std::domain_error("Number of matrices in the batches are not equal");
+    if (xx_left.dimC() != xx_right.dimR())
+        throw std::domain_error("Number of columns_A != Number of rows_B");
+
+    std::size_t const M = xx_left.dimR();
+    std::size_t const N = xx_right.dimC();
+    std::size_t const K = xx_left.dimC();
+    constexpr bool parallel = tpPolicyType<typename batch::matrix_type>::is_parallel;
+    constexpr std::size_t L = tpLayout == batch_layout::interleaved ? detail::batch_lanes : 1;
+
+    batch result(xx_left.count(), M, N);
+    tpDataType const * const A = xx_left.data();
+    tpDataType const * const B = xx_right.data();
+    tpDataType * const C = result.data();
+
+    // a unit is one block of interleaved matrices or one contiguous matrix
+    std::size_t const units = (xx_left.count() + L - 1) / L;
+    detail::for_each_chunk<parallel>(units, std::max<std::size_t>(1, M * N * K * L), [&](std::size_t const xx_first, std::size_t const xx_last) {
+        for (std::size_t u = xx_first; u < xx_last; ++u) {
+            if constexpr (tpLayout == batch_layout::interleaved)
+                detail::batch_multiply_lanes(M, N, K, A + u * M * K * L, B + u * K * N * L, C + u * M * N * L);
+            else
+                detail::batch_multiply_single(M, N, K, A + u * M * K, B + u * K * N, C + u * M * N);
+        }
+    });
+    return result;
+}
+
+/*! output batch to std::cout, one matrix after the other
+ */
+template<typename tpDataType, batch_layout tpLayout, template<typename > class tpPolicyType, typename tpAllocatorType>
+std::ostream& operator<<(std::ostream& os, batch_matrix<tpDataType, tpLayout, tpPolicyType, tpAllocatorType> const & xx_batch)
+{
+    for (std::size_t b = 0; b < xx_batch.count(); ++b) {
+        if (b > 0)
+            os << '\n';
+        os << '[';
+        for (std::size_t R = 0; R < xx_batch.dimR(); ++R) {
+            if (R > 0)
+                os << ",\n ";
+
+            for (std::size_t C = 0; C < xx_batch.dimC(); ++C)
+                os << xx_batch(b, R, C) << " ";
+        }
+        os << ']';
+    }
+    return os;
+}
+
+}
+
+#endif /* batch_h */
@@ -0,0 +1,639 @@
+/*
+//  benchmark.cpp
+//  Assignment
+//
+//  Created by Mohammed Afroze on 23.02.20.
+*/
+
+/*! Throughput benchmark of every matrix and vector operator, for int, float, double and std::complex<double>, with every
+ multiply policy where they apply.
+
+ Build and run:
+    g++ -std=c++17 -O3 -march=native -pthread benchmark.cpp -o benchmark
+    ./benchmark > results.csv
+
+ Options:
+    --min=N         smallest size (default 4)
+    --max=N         largest size (default 8192); sizes are the powers of two in [min, max]
+    --gemm-max=N    largest size for the O(N^3) operations (default 2048)
+    --mem=MB        skip cases whose operands need more than this much memory (default 1024)
+    --time=S        minimum measuring time per case in seconds (default 0.1)
+    --filter=TEXT   only run cases whose "op/type/policy" contains TEXT
+
+ Output is one CSV line per case on stdout, in a fixed order, so two runs can be diffed or joined on the first four columns:
+    op,type,policy,n,ns_per_op,gflops,gbytes_per_s,allocs_per_op,iterations
+ n is the vector length or the edge of the square matrices. gflops counts arithmetic operations (a complex multiply is six,
+ a complex add two, int operations count like floating point ones); gbytes_per_s counts the compulsory traffic of the operands
+ and the result. Skipped cases and progress go to stderr.
+
+ The planar cases of complex<double> count the flops of the interleaved product, so their ns_per_op and gflops compare
+ directly with matrix*matrix of the same policy; matrix->planar*planar->matrix includes the conversions.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "batch.hpp"
+#include "matrix.hpp"
+#include "matrix_helpers.hpp"
+#include "planar.hpp"
+#include "sparse.hpp"
+#include "vector_helpers.hpp"
+#include "view.hpp"
+
+/* ==== a  l  l  o  c  a  t  i  o  n     c  o  u  n  t  i  n  g ==== */
+
+namespace {
+std::atomic<std::size_t> g_allocations(0);
+
+void * counted_allocate(std::size_t const xx_bytes, std::size_t const xx_alignment)
+{
+    ++g_allocations;
+    std::size_t const alignment = std::max(xx_alignment, sizeof(void *));
+    void * block = nullptr;
+    if (posix_memalign(&block, alignment, xx_bytes == 0 ? 1 : xx_bytes) != 0)
+        throw std::bad_alloc();
+    return block;
+}
+}
+
+void * operator new(std::size_t xx_bytes)
+{
+    return counted_allocate(xx_bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void * operator new[](std::size_t xx_bytes)
+{
+    return counted_allocate(xx_bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void * operator new(std::size_t xx_bytes, std::align_val_t xx_alignment)
+{
+    return counted_allocate(xx_bytes, static_cast<std::size_t>(xx_alignment));
+}
+void * operator new[](std::size_t xx_bytes, std::align_val_t xx_alignment)
+{
+    return counted_allocate(xx_bytes, static_cast<std::size_t>(xx_alignment));
+}
+void operator delete(void * xx_block) noexcept
+{
+    std::free(xx_block);
+}
+void operator delete[](void * xx_block) noexcept
+{
+    std::free(xx_block);
+}
+void operator delete(void * xx_block, std::size_t) noexcept
+{
+    std::free(xx_block);
+}
+void operator delete[](void * xx_block, std::size_t) noexcept
+{
+    std::free(xx_block);
+}
+void operator delete(void * xx_block, std::align_val_t) noexcept
+{
+    std::free(xx_block);
+}
+void operator delete[](void * xx_block, std::align_val_t) noexcept
+{
+    std::free(xx_block);
+}
+void operator delete(void * xx_block, std::size_t, std::align_val_t) noexcept
+{
+    std::free(xx_block);
+}
+void operator delete[](void * xx_block, std::size_t, std::align_val_t) noexcept
+{
+    std::free(xx_block);
+}
+
+namespace {
+
+/* ==== s  e  t  t  i  n  g  s ==== */
+
+struct settings {
+    std::size_t min_size = 4;
+    std::size_t max_size = 8192;
+    std::size_t gemm_max = 2048;
+    std::size_t memory_mb = 1024;
+    double min_time = 0.1;
+    std::string filter;
+};
+
+/*! keeps the compiler from optimising the benchmarked work away
+ */
+template<typename tpType>
+void keep(tpType const & xx_value)
+{
+    asm volatile("" : : "r"(&xx_value) : "memory");
+}
+
+/* ==== t  y  p  e  s ==== */
+
+template<typename tpDataType>
+struct element_info;
+
+template<>
+struct element_info<int> {
+    static constexpr char const * name = "int";
+    static constexpr double add_flops = 1;
+    static constexpr double mul_flops = 1;
+};
+
+template<>
+struct element_info<float> {
+    static constexpr char const * name = "float";
+    static constexpr double add_flops = 1;
+    static constexpr double mul_flops = 1;
+};
+
+template<>
+struct element_info<double> {
+    static constexpr char const * name = "double";
+    static constexpr double add_flops = 1;
+    static constexpr double mul_flops = 1;
+};
+
+template<>
+struct element_info<std::complex<double>> {
+    static constexpr char const * name = "complex<double>";
+    static constexpr double add_flops = 2;
+    static constexpr double mul_flops = 6;
+};
+
+/*! small, exactly representable values, so integer products do not overflow and every type computes the same thing
+ */
+template<typename tpDataType>
+tpDataType sample(std::size_t const xx_idx)
+{
+    return static_cast<tpDataType>(static_cast<int>(1 + xx_idx % 3));
+}
+
+/*! right operand of an operation
+ \note compound assignments get the neutral element (0 for += and -=, 1 for *=), so repeating them millions of times neither
+ overflows nor drifts into denormals; the kernels have no data-dependent paths, so this does not change their cost.
+ */
+enum class operand {
+    samples,
+    zeros,
+    ones
+};
+
+template<typename tpContainer>
+void fill(tpContainer & xx_container, std::size_t const xx_count, operand const xx_fill = operand::samples)
+{
+    using value_type = typename tpContainer::value_type;
+    for (std::size_t i = 0; i < xx_count; ++i) {
+        xx_container.data()[i] = xx_fill == operand::samples ? sample<value_type>(i) : static_cast<value_type>(xx_fill == operand::ones ? 1 : 0);
+    }
+}
+
+/*! n x n CSR matrix with up to xx_per_row nonzeros per row, spread evenly over the columns
+ */
+template<typename tpDataType, template<typename > class tpPolicyType>
+assignment::csr_matrix<tpDataType, tpPolicyType> sparse_sample(std::size_t const xx_n, std::size_t const xx_per_row)
+{
+    std::size_t const per_row = std::min(xx_per_row, xx_n);
+    std::vector<assignment::triplet<tpDataType>> triplets;
+    triplets.reserve(xx_n * per_row);
+    for (std::size_t i = 0; i < xx_n; ++i) {
+        for (std::size_t k = 0; k < per_row; ++k)
+            triplets.push_back({i, (i + k * (xx_n / per_row)) % xx_n, sample<tpDataType>(i + k)});
+    }
+    return assignment::csr_matrix<tpDataType, tpPolicyType>(xx_n, xx_n, triplets);
+}
+
+/* ==== m  e  a  s  u  r  e  m  e  n  t ==== */
+
+struct measurement {
+    double ns_per_op;
+    double allocs_per_op;
+    std::size_t iterations;
+};
+
+/*! runs xx_operation until xx_min_time has passed, doubling the batch size, and reports the time per call of the last batch
+ \note one untimed call warms up caches, the thread-local GEMM panels and the pool allocators; the allocation count is
+ taken from a second single call.
+ */
+template<typename tpOperation>
+measurement measure(tpOperation && xx_operation, double const xx_min_time)
+{
+    using clock = std::chrono::steady_clock;
+
+    xx_operation();
+
+    std::size_t const before = g_allocations.load();
+    xx_operation();
+    double const allocations = static_cast<double>(g_allocations.load() - before);
+
+    for (std::size_t batch = 1;; batch *= 2) {
+        auto const start = clock::now();
+        for (std::size_t i = 0; i < batch; ++i)
+            xx_operation();
+        double const elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        if (elapsed >= xx_min_time || batch >= (std::size_t(1) << 40))
+            return {elapsed * 1e9 / static_cast<double>(batch), allocations, batch};
+    }
+}
+
+/*! a benchmark case: identity, cost model and a function setting up the operands and measuring the operation
+ */
+struct bench_case {
+    std::string op;
+    std::string type;
+    std::string policy;
+    std::size_t n;
+    double flops;
+    double bytes;
+    double footprint;
+    std::function<measurement(double)> run;
+};
+
+void report(bench_case const & xx_case, measurement const & xx_result)
+{
+    double const seconds = xx_result.ns_per_op * 1e-9;
+    std::printf("%s,%s,%s,%zu,%.1f,%.3f,%.3f,%.2f,%zu\n", xx_case.op.c_str(), xx_case.type.c_str(), xx_case.policy.c_str(), xx_case.n,
+                xx_result.ns_per_op, xx_case.flops / seconds * 1e-9, xx_case.bytes / seconds * 1e-9, xx_result.allocs_per_op, xx_result.iterations);
+    std::fflush(stdout);
+}
+
+/* ==== v  e  c  t  o  r     c  a  s  e  s ==== */
+
+template<typename tpDataType>
+void vector_cases(std::vector<bench_case> & xx_cases, std::size_t const xx_n)
+{
+    using vector = assignment::vector<tpDataType>;
+    using info = element_info<tpDataType>;
+
+    double const n = static_cast<double>(xx_n);
+    double const element = sizeof(tpDataType);
+
+    // name, flops, elements moved, operation on (result, a, b, scalar), right operand b
+    struct vector_op {
+        char const * name;
+        double flops;
+        double moved;
+        std::function<void(vector &, vector const &, vector const &, tpDataType)> apply;
+        operand right;
+    };
+
+    std::vector<vector_op> const ops = {
+        {"vector+vector", info::add_flops * n, 3 * n, [](vector & c, vector const & a, vector const & b, tpDataType) { c = a + b; }, operand::samples},
+        {"vector-vector", info::add_flops * n, 3 * n, [](vector & c, vector const & a, vector const & b, tpDataType) { c = a - b; }, operand::samples},
+        {"vector*vector", info::mul_flops * n, 3 * n, [](vector & c, vector const & a, vector const & b, tpDataType) { c = a * b; }, operand::samples},
+        {"vector*scalar", info::mul_flops * n, 2 * n, [](vector & c, vector const & a, vector const &, tpDataType s) { c = a * s; }, operand::samples},
+        {"scalar*vector", info::mul_flops * n, 2 * n, [](vector & c, vector const & a, vector const &, tpDataType s) { c = s * a; }, operand::samples},
+        {"vector+scalar", info::add_flops * n, 2 * n, [](vector & c, vector const & a, vector const &, tpDataType s) { c = a + s; }, operand::samples},
+        {"-vector", 0, 2 * n, [](vector & c, vector const & a, vector const &, tpDataType) { c = -a; }, operand::samples},
+        {"vector+=vector", info::add_flops * n, 3 * n, [](vector & c, vector const &, vector const & b, tpDataType) { c += b; }, operand::zeros},
+        {"vector-=vector", info::add_flops * n, 3 * n, [](vector & c, vector const &, vector const & b, tpDataType) { c -= b; }, operand::zeros},
+        {"vector*=vector", info::mul_flops * n, 3 * n, [](vector & c, vector const &, vector const & b, tpDataType) { c *= b; }, operand::ones},
+        {"vector*scalar+vector", (info::mul_flops + info::add_flops) * n, 3 * n,
+                        [](vector & c, vector const & a, vector const & b, tpDataType s) { c = a * s + b; }, operand::samples},
+        {"vector(vector+vector)", info::add_flops * n, 3 * n, [](vector &, vector const & a, vector const & b, tpDataType) {
+            vector const sum = a + b;
+            keep(sum);
+        }, operand::samples},
+    };
+
+    for (auto const & op : ops) {
+        auto const apply = op.apply;
+        auto const right = op.right;
+        xx_cases.push_back({op.name, info::name, "-", xx_n, op.flops, op.moved * element, 3 * n * element, [apply, right, xx_n](double const xx_time) {
+            vector a(xx_n), b(xx_n), c(xx_n);
+            fill(a, xx_n);
+            fill(b, xx_n, right);
+            fill(c, xx_n);
+            tpDataType const s = sample<tpDataType>(1);
+            return measure([&]() {
+                apply(c, a, b, s);
+                keep(c);
+            }, xx_time);
+        }});
+    }
+}
+
+/* ==== m  a  t  r  i  x     c  a  s  e  s ==== */
+
+template<typename tpDataType>
+void matrix_cases(std::vector<bench_case> & xx_cases, std::size_t const xx_n)
+{
+    using matrix = assignment::matrix<tpDataType>;
+    using vector = assignment::vector<tpDataType>;
+    using info = element_info<tpDataType>;
+
+    double const n = static_cast<double>(xx_n);
+    double const nn = n * n;
+    double const element = sizeof(tpDataType);
+
+    struct matrix_op {
+        char const * name;
+        double flops;
+        double moved;
+        std::function<void(matrix &, matrix const &, matrix const &, tpDataType)> apply;
+        operand right;
+    };
+
+    std::vector<matrix_op> const ops = {
+        {"matrix+matrix", info::add_flops * nn, 3 * nn, [](matrix & c, matrix const & a, matrix const & b, tpDataType) { c = a + b; }, operand::samples},
+        {"matrix-matrix", info::add_flops * nn, 3 * nn, [](matrix & c, matrix const & a, matrix const & b, tpDataType) { c = a - b; }, operand::samples},
+        {"matrix*scalar", info::mul_flops * nn, 2 * nn, [](matrix & c, matrix const & a, matrix const &, tpDataType s) { c = a * s; }, operand::samples},
+        {"scalar*matrix", info::mul_flops * nn, 2 * nn, [](matrix & c, matrix const & a, matrix const &, tpDataType s) { c = s * a; }, operand::samples},
+        {"-matrix", 0, 2 * nn, [](matrix & c, matrix const & a, matrix const &, tpDataType) { c = -a; }, operand::samples},
+        {"matrix+=matrix", info::add_flops * nn, 3 * nn, [](matrix & c, matrix const &, matrix const & b, tpDataType) { c += b; }, operand::zeros},
+        {"matrix-=matrix", info::add_flops * nn, 3 * nn, [](matrix & c, matrix const &, matrix const & b, tpDataType) { c -= b; }, operand::zeros},
+        {"matrix*scalar+matrix", (info::mul_flops + info::add_flops) * nn, 3 * nn,
+                        [](matrix & c, matrix const & a, matrix const & b, tpDataType s) { c = a * s + b; }, operand::samples},
+        {"matrix(matrix+matrix)", info::add_flops * nn, 3 * nn, [](matrix &, matrix const & a, matrix const & b, tpDataType) {
+            matrix const sum = a + b;
+            keep(sum);
+        }, operand::samples},
+        {"transpose(matrix)", 0, 2 * nn, [](matrix & c, matrix const & a, matrix const &, tpDataType) { c = assignment::transpose(a); }, operand::samples},
+    };
+
+    for (auto const & op : ops) {
+        auto const apply = op.apply;
+        auto const right = op.right;
+        xx_cases.push_back({op.name, info::name, "-", xx_n, op.flops, op.moved * element, 3 * nn * element, [apply, right, xx_n](double const xx_time) {
+            matrix a(xx_n, xx_n), b(xx_n, xx_n), c(xx_n, xx_n);
+            fill(a, xx_n * xx_n);
+            fill(b, xx_n * xx_n, right);
+            fill(c, xx_n * xx_n);
+            tpDataType const s = sample<tpDataType>(1);
+            return measure([&]() {
+                apply(c, a, b, s);
+                keep(c);
+            }, xx_time);
+        }});
+    }
+
+    xx_cases.push_back({"matrix+vector", info::name, "-", xx_n, info::add_flops * nn, (2 * nn + n) * element, (2 * nn + n) * element,
+                        [xx_n](double const xx_time) {
+                            matrix a(xx_n, xx_n);
+                            vector v(xx_n);
+                            fill(a, xx_n * xx_n);
+                            fill(v, xx_n);
+                            return measure([&]() {
+                                matrix const c = a + v;
+                                keep(c);
+                            }, xx_time);
+                        }});
+}
+
+/*! operations whose cost depends on the multiply policy
+ */
+template<typename tpDataType, template<typename > class tpPolicyType>
+void policy_cases(std::vector<bench_case> & xx_cases, std::size_t const xx_n, char const * xx_policy, bool const xx_cubic)
+{
+    using matrix = assignment::matrix<tpDataType, tpPolicyType>;
+    using vector = assignment::vector<tpDataType>;
+    using info = element_info<tpDataType>;
+
+    double const n = static_cast<double>(xx_n);
+    double const nn = n * n;
+    double const element = sizeof(tpDataType);
+    double const fma = info::mul_flops + info::add_flops;
+
+    xx_cases.push_back({"matrix*vector", info::name, xx_policy, xx_n, fma * nn, (nn + 2 * n) * element, (nn + 2 * n) * element,
+                        [xx_n](double const xx_time) {
+                            matrix a(xx_n, xx_n);
+                            vector v(xx_n);
+                            fill(a, xx_n * xx_n);
+                            fill(v, xx_n);
+                            return measure([&]() {
+                                vector const r = a * v;
+                                keep(r);
+                            }, xx_time);
+                        }});
+
+    // one matrix against a batch of vectors, which streams the matrix once
+    constexpr std::size_t batch = 8;
+    xx_cases.push_back({"matrix*vector[8]", info::name, xx_policy, xx_n, fma * nn * batch, (nn + 2 * n * batch) * element,
+                        (nn + 4 * n * batch) * element, [xx_n](double const xx_time) {
+                            matrix a(xx_n, xx_n);
+                            fill(a, xx_n * xx_n);
+                            std::vector<vector> vectors(batch, vector(xx_n));
+                            for (auto & v : vectors)
+                                fill(v, xx_n);
+                            return measure([&]() {
+                                auto const r = assignment::multiply(a, vectors);
+                                keep(r);
+                            }, xx_time);
+                        }});
+
+    // 16 nonzeros per row; an index costs 4 bytes next to each value
+    constexpr std::size_t per_row = 16;
+    double const nnz = n * static_cast<double>(std::min(per_row, xx_n));
+    xx_cases.push_back({"sparse*vector", info::name, xx_policy, xx_n, fma * nnz, nnz * (element + 4) + 2 * n * element,
+                        nnz * (element + 4) + 2 * n * element, [xx_n](double const xx_time) {
+                            auto const a = sparse_sample<tpDataType, tpPolicyType>(xx_n, per_row);
+                            vector v(xx_n);
+                            fill(v, xx_n);
+                            return measure([&]() {
+                                vector const r = a * v;
+                                keep(r);
+                            }, xx_time);
+                        }});
+
+    xx_cases.push_back({"sparse*matrix", info::name, xx_policy, xx_n, fma * nnz * n, nnz * (element + 4) + 2 * nn * element,
+                        nnz * (element + 4) + 2 * nn * element, [xx_n](double const xx_time) {
+                            auto const a = sparse_sample<tpDataType, tpPolicyType>(xx_n, per_row);
+                            matrix b(xx_n, xx_n);
+                            fill(b, xx_n * xx_n);
+                            return measure([&]() {
+                                matrix const c = a * b;
+                                keep(c);
+                            }, xx_time);
+                        }});
+
+    // many independent small products, one matrix per SIMD lane
+    constexpr std::size_t count = 1024;
+    if (xx_n <= 32) {
+        using batch = assignment::batch_matrix<tpDataType, assignment::batch_layout::interleaved, tpPolicyType>;
+        xx_cases.push_back({"batch*batch[1024]", info::name, xx_policy, xx_n, fma * nn * n * count, 3 * nn * element * count,
+                            3 * nn * element * count, [xx_n](double const xx_time) {
+                                batch a(count, xx_n, xx_n), b(count, xx_n, xx_n);
+                                fill(a, a.storage());
+                                fill(b, b.storage());
+                                return measure([&]() {
+                                    batch const c = a * b;
+                                    keep(c);
+                                }, xx_time);
+                            }});
+
+        xx_cases.push_back({"batch*vector[1024]", info::name, xx_policy, xx_n, fma * nn * count, (nn + 2 * n) * element * count,
+                            (nn + 2 * n) * element * count, [xx_n](double const xx_time) {
+                                batch a(count, xx_n, xx_n), v(count, xx_n, 1);
+                                fill(a, a.storage());
+                                fill(v, v.storage());
+                                return measure([&]() {
+                                    batch const r = a * v;
+                                    keep(r);
+                                }, xx_time);
+                            }});
+    }
+
+    if (!xx_cubic)
+        return;
+
+    xx_cases.push_back({"matrix*matrix", info::name, xx_policy, xx_n, fma * nn * n, 3 * nn * element, 3 * nn * element,
+                        [xx_n](double const xx_time) {
+                            matrix a(xx_n, xx_n), b(xx_n, xx_n);
+                            fill(a, xx_n * xx_n);
+                            fill(b, xx_n * xx_n);
+                            return measure([&]() {
+                                matrix const c = a * b;
+                                keep(c);
+                            }, xx_time);
+                        }});
+
+    xx_cases.push_back({"matrix*=matrix", info::name, xx_policy, xx_n, fma * nn * n, 3 * nn * element, 3 * nn * element,
+                        [xx_n](double const xx_time) {
+                            // multiplying by the identity keeps the repeated products from overflowing
+                            matrix a(xx_n, xx_n), b(xx_n, xx_n, static_cast<tpDataType>(0));
+                            fill(a, xx_n * xx_n);
+                            for (std::size_t i = 0; i < xx_n; ++i)
+                                b(i, i) = static_cast<tpDataType>(1);
+                            return measure([&]() {
+                                a *= b;
+                                keep(a);
+                            }, xx_time);
+                        }});
+
+    xx_cases.push_back({"transpose(matrix)*matrix", info::name, xx_policy, xx_n, fma * nn * n, 3 * nn * element, 3 * nn * element,
+                        [xx_n](double const xx_time) {
+                            matrix a(xx_n, xx_n), b(xx_n, xx_n);
+                            fill(a, xx_n * xx_n);
+                            fill(b, xx_n * xx_n);
+                            return measure([&]() {
+                                matrix const c = assignment::transpose(a) * b;
+                                keep(c);
+                            }, xx_time);
+                        }});
+
+    // the same product on int8_t operands with int32_t sums, reported under int
+    if constexpr (std::is_same<tpDataType, int>::value) {
+        using quantized = assignment::matrix<std::int8_t, tpPolicyType>;
+        xx_cases.push_back({"int8*int8", info::name, xx_policy, xx_n, fma * nn * n, 2 * nn + 4 * nn, 2 * nn + 4 * nn,
+                            [xx_n](double const xx_time) {
+                                quantized a(xx_n, xx_n), b(xx_n, xx_n);
+                                fill(a, xx_n * xx_n);
+                                fill(b, xx_n * xx_n);
+                                return measure([&]() {
+                                    auto const c = assignment::multiply<std::int32_t>(a, b);
+                                    keep(c);
+                                }, xx_time);
+                            }});
+    }
+
+    // the same product on split real and imaginary planes
+    if constexpr (std::is_same<tpDataType, std::complex<double>>::value) {
+        using planar = assignment::planar_matrix<double, tpPolicyType>;
+        xx_cases.push_back({"planar*planar", info::name, xx_policy, xx_n, fma * nn * n, 3 * nn * element, 7 * nn * element,
+                            [xx_n](double const xx_time) {
+                                matrix a(xx_n, xx_n), b(xx_n, xx_n);
+                                fill(a, xx_n * xx_n);
+                                fill(b, xx_n * xx_n);
+                                planar const pa(a), pb(b);
+                                return measure([&]() {
+                                    planar const c = pa * pb;
+                                    keep(c);
+                                }, xx_time);
+                            }});
+
+        // the same again from and back to interleaved storage, against matrix*matrix of the same type and policy
+        xx_cases.push_back({"matrix->planar*planar->matrix", info::name, xx_policy, xx_n, fma * nn * n, 3 * nn * element,
+                            7 * nn * element, [xx_n](double const xx_time) {
+                                matrix a(xx_n, xx_n), b(xx_n, xx_n);
+                                fill(a, xx_n * xx_n);
+                                fill(b, xx_n * xx_n);
+                                return measure([&]() {
+                                    matrix const c = planar(a) * planar(b);
+                                    keep(c);
+                                }, xx_time);
+                            }});
+    }
+}
+
+template<typename tpDataType>
+void type_cases(std::vector<bench_case> & xx_cases, std::size_t const xx_n, settings const & xx_settings)
+{
+    bool const cubic = xx_n <= xx_settings.gemm_max;
+    vector_cases<tpDataType>(xx_cases, xx_n);
+    matrix_cases<tpDataType>(xx_cases, xx_n);
+    policy_cases<tpDataType, assignment::NonParallel>(xx_cases, xx_n, "NonParallel", cubic);
+    policy_cases<tpDataType, assignment::Parallel>(xx_cases, xx_n, "Parallel", cubic);
+    policy_cases<tpDataType, assignment::Strassen>(xx_cases, xx_n, "Strassen", cubic);
+}
+
+bool parse(settings & xx_settings, char const * xx_argument)
+{
+    std::string const argument = xx_argument;
+    auto const value = [&](char const * xx_name) -> char const * {
+        std::size_t const length = std::strlen(xx_name);
+        return argument.compare(0, length, xx_name) == 0 ? xx_argument + length : nullptr;
+    };
+
+    if (char const * v = value("--min="))
+        xx_settings.min_size = std::strtoull(v, nullptr, 10);
+    else if (char const * v = value("--max="))
+        xx_settings.max_size = std::strtoull(v, nullptr, 10);
+    else if (char const * v = value("--gemm-max="))
+        xx_settings.gemm_max = std::strtoull(v, nullptr, 10);
+    else if (char const * v = value("--mem="))
+        xx_settings.memory_mb = std::strtoull(v, nullptr, 10);
+    else if (char const * v = value("--time="))
+        xx_settings.min_time = std::strtod(v, nullptr);
+    else if (char const * v = value("--filter="))
+        xx_settings.filter = v;
+    else
+        return false;
+    return true;
+}
+
+}
+
+int main(int argc, const char * argv[])
+{
+    settings config;
+    for (int i = 1; i < argc; ++i) {
+        if (!parse(config, argv[i])) {
+            std::cerr << "unknown option " << argv[i] << "; see the comment at the top of benchmark.cpp" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<bench_case> cases;
+    for (std::size_t n = 1; n <= config.max_size; n *= 2) {
+        if (n < config.min_size)
+            continue;
+        type_cases<int>(cases, n, config);
+        type_cases<float>(cases, n, config);
+        type_cases<double>(cases, n, config);
+        type_cases<std::complex<double>>(cases, n, config);
+    }
+
+    std::printf("op,type,policy,n,ns_per_op,gflops,gbytes_per_s,allocs_per_op,iterations\n");
+    for (auto const & test : cases) {
+        std::string const id = test.op + "/" + test.type + "/" + test.policy;
+        if (!config.filter.empty() && id.find(config.filter) == std::string::npos)
+            continue;
+        if (test.footprint > static_cast<double>(config.memory_mb) * 1024 * 1024) {
+            std::cerr << "skipped " << id << " n=" << test.n << ": operands exceed --mem" << std::endl;
+            continue;
+        }
+        std::cerr << id << " n=" << test.n << std::endl;
+        report(test, test.run(config.min_time));
+    }
+
+    return 0;
+}
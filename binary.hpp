@@ -0,0 +1,777 @@
+/*
+ //  binary.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the binary file format of the matrices: a 64 byte header giving the shape, element type and
+ storage order, followed by the raw elements. A file is loaded into an assignment::matrix with a single read, or mapped
+ into memory by assignment::mapped_matrix, whose view() borrows the mapping without copying anything. It is written in
+ one call from a matrix expression, or row by row through assignment::binary_writer without holding the whole matrix.
+ Matrices larger than the memory are kept in tiled files, which assignment::tiled_file reads and writes a tile at a time.
+ \note the elements are stored in the byte order of the machine writing them; a file of the other byte order is rejected.
+ */
+#ifndef binary_h
+#define binary_h
+
+#include <algorithm>
+#include <cerrno>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "expression.hpp"
+#include "matrix.hpp"
+#include "view.hpp"
+
+namespace assignment {
+
+/*! order of the elements following the header of a binary file
+ */
+enum class storage_order : std::uint32_t {
+    row_major = 0, //!< element (R, C) at R * dimC + C
+    col_major = 1, //!< element (R, C) at C * dimR + R
+    tiled = 2      //!< tileR x tileC tiles in row-major order, each row-major; tiles at the edges are padded to full size
+};
+
+namespace detail {
+
+/*! header at the start of a binary file
+ \note the elements start at offset, 64 bytes into the file, so a page aligned mapping keeps them cache line aligned.
+ */
+struct binary_header {
+    char magic[8];          //!< "ASGNMTX" followed by a NUL
+    std::uint32_t version;  //!< format version, binary_version
+    std::uint32_t endian;   //!< binary_endian as written by the machine that wrote the file
+    std::uint32_t type;     //!< element type code, binary_type<tpDataType>::value
+    std::uint32_t size;     //!< size of one element in bytes
+    std::uint32_t order;    //!< storage_order of the elements
+    std::uint32_t tileR;    //!< row dimension of a tile for storage_order::tiled, zero otherwise
+    std::uint64_t dimR;     //!< row dimension
+    std::uint64_t dimC;     //!< column dimension
+    std::uint64_t offset;   //!< position of the first element in the file
+    std::uint32_t tileC;    //!< column dimension of a tile for storage_order::tiled, zero otherwise
+    std::uint32_t reserved; //!< zero
+};
+
+static_assert(sizeof(binary_header) == 64, "binary header must fill one cache line");
+
+constexpr char binary_magic[8] = {'A', 'S', 'G', 'N', 'M', 'T', 'X', '\0'};
+constexpr std::uint32_t binary_version = 1;
+constexpr std::uint32_t binary_endian = 0x01020304;
+
+/*! element type code stored in the header; only these element types can be written or read
+ */
+template<typename tpDataType>
+struct binary_type;
+
+template<> struct binary_type<float> : std::integral_constant<std::uint32_t, 1> {};
+template<> struct binary_type<double> : std::integral_constant<std::uint32_t, 2> {};
+template<> struct binary_type<std::int8_t> : std::integral_constant<std::uint32_t, 3> {};
+template<> struct binary_type<std::int16_t> : std::integral_constant<std::uint32_t, 4> {};
+template<> struct binary_type<std::int32_t> : std::integral_constant<std::uint32_t, 5> {};
+template<> struct binary_type<std::int64_t> : std::integral_constant<std::uint32_t, 6> {};
+template<> struct binary_type<std::uint8_t> : std::integral_constant<std::uint32_t, 7> {};
+template<> struct binary_type<std::uint16_t> : std::integral_constant<std::uint32_t, 8> {};
+template<> struct binary_type<std::uint32_t> : std::integral_constant<std::uint32_t, 9> {};
+template<> struct binary_type<std::uint64_t> : std::integral_constant<std::uint32_t, 10> {};
+template<> struct binary_type<std::complex<float>> : std::integral_constant<std::uint32_t, 11> {};
+template<> struct binary_type<std::complex<double>> : std::integral_constant<std::uint32_t, 12> {};
+
+/*! file descriptor closed when it goes out of scope
+ */
+class binary_file {
+public:
+
+    binary_file(std::string const & xx_path, int const xx_flags) :
+                    m_fd(::open(xx_path.c_str(), xx_flags | O_CLOEXEC, 0644))
+    {
+        if (m_fd < 0)
+            throw std::system_error(errno, std::generic_category(), "Cannot open " + xx_path);
+    }
+
+    binary_file(binary_file const &) = delete;
+    binary_file & operator=(binary_file const &) = delete;
+
+    ~binary_file()
+    {
+        if (m_fd >= 0)
+            ::close(m_fd);
+    }
+
+    int fd() const
+    {
+        return m_fd;
+    }
+
+    /*! closes the descriptor, reporting the error of a deferred write
+     \throw std::system_error if closing fails
+     */
+    void close()
+    {
+        int const fd = m_fd;
+        m_fd = -1;
+        if (::close(fd) != 0)
+            throw std::system_error(errno, std::generic_category(), "Cannot close file");
+    }
+
+    /*! size of the file in bytes
+     \throw std::system_error if the file cannot be queried
+     */
+    std::uint64_t size() const
+    {
+        struct stat status;
+        if (::fstat(m_fd, &status) != 0)
+            throw std::system_error(errno, std::generic_category(), "Cannot query file size");
+        return static_cast<std::uint64_t>(status.st_size);
+    }
+
+    /*! reads xx_bytes bytes at position xx_offset into xx_out
+     \throw std::system_error if reading fails, std::runtime_error if the file ends before
+     */
+    void read(void * xx_out, std::size_t xx_bytes, std::uint64_t xx_offset) const
+    {
+        char * out = static_cast<char *>(xx_out);
+        while (xx_bytes > 0) {
+            ssize_t const done = ::pread(m_fd, out, xx_bytes, static_cast<off_t>(xx_offset));
+            if (done < 0 && errno == EINTR)
+                continue;
+            if (done < 0)
+                throw std::system_error(errno, std::generic_category(), "Cannot read file");
+            if (done == 0)
+                throw std::runtime_error("Binary matrix file is truncated");
+            out += done;
+            xx_bytes -= static_cast<std::size_t>(done);
+            xx_offset += static_cast<std::uint64_t>(done);
+        }
+    }
+
+    /*! writes xx_bytes bytes of xx_in at position xx_offset
+     \throw std::system_error if writing fails
+     */
+    void write(void const * xx_in, std::size_t xx_bytes, std::uint64_t xx_offset) const
+    {
+        char const * in = static_cast<char const *>(xx_in);
+        while (xx_bytes > 0) {
+            ssize_t const done = ::pwrite(m_fd, in, xx_bytes, static_cast<off_t>(xx_offset));
+            if (done < 0 && errno == EINTR)
+                continue;
+            if (done < 0)
+                throw std::system_error(errno, std::generic_category(), "Cannot write file");
+            in += done;
+            xx_bytes -= static_cast<std::size_t>(done);
+            xx_offset += static_cast<std::uint64_t>(done);
+        }
+    }
+
+private:
+
+    int m_fd;
+};
+
+/*! header of an xx_dimR x xx_dimC matrix of tpDataType in xx_order, cut into xx_tileR x xx_tileC tiles if tiled
+ */
+template<typename tpDataType>
+binary_header make_header(std::uint64_t const xx_dimR, std::uint64_t const xx_dimC, storage_order const xx_order,
+                          std::uint32_t const xx_tileR = 0, std::uint32_t const xx_tileC = 0)
+{
+    binary_header header = {};
+    std::memcpy(header.magic, binary_magic, sizeof(header.magic));
+    header.version = binary_version;
+    header.endian = binary_endian;
+    header.type = binary_type<tpDataType>::value;
+    header.size = sizeof(tpDataType);
+    header.order = static_cast<std::uint32_t>(xx_order);
+    header.dimR = xx_dimR;
+    header.dimC = xx_dimC;
+    header.offset = sizeof(binary_header);
+    header.tileR = xx_tileR;
+    header.tileC = xx_tileC;
+    return header;
+}
+
+/*! validates the header of a file of xx_file_size bytes holding tpDataType elements
+ \throw std::runtime_error if it is not a binary matrix file, was written with another byte order, holds another
+        element type or is shorter than its elements
+ */
+template<typename tpDataType>
+void check_header(binary_header const & xx_header, std::uint64_t const xx_file_size)
+{
+    if (std::memcmp(xx_header.magic, binary_magic, sizeof(binary_magic)) != 0 || xx_header.version != binary_version)
+        throw std::runtime_error("Not a binary matrix file");
+    if (xx_header.endian != binary_endian)
+        throw std::runtime_error("Binary matrix file has another byte order");
+    if (xx_header.type != binary_type<tpDataType>::value || xx_header.size != sizeof(tpDataType))
+        throw std::runtime_error("Binary matrix file holds another element type");
+    bool const tiled = xx_header.order == static_cast<std::uint32_t>(storage_order::tiled);
+    if (xx_header.order > static_cast<std::uint32_t>(storage_order::tiled) || xx_header.offset < sizeof(binary_header)
+        || xx_header.offset % alignof(tpDataType) != 0 || (tiled && (xx_header.tileR == 0 || xx_header.tileC == 0)))
+        throw std::runtime_error("Binary matrix file has an invalid header");
+
+    // a tiled file stores whole tiles; count the padding of the edge tiles
+    std::uint64_t const rows = tiled ? (xx_header.dimR + xx_header.tileR - 1) / xx_header.tileR * xx_header.tileR : xx_header.dimR;
+    std::uint64_t const cols = tiled ? (xx_header.dimC + xx_header.tileC - 1) / xx_header.tileC * xx_header.tileC : xx_header.dimC;
+    std::uint64_t const limit = std::numeric_limits<std::size_t>::max() / sizeof(tpDataType);
+    if (rows < xx_header.dimR || cols < xx_header.dimC || (cols != 0 && rows > limit / cols))
+        throw std::runtime_error("Binary matrix file is too large");
+    std::uint64_t const bytes = rows * cols * sizeof(tpDataType);
+    if (xx_file_size < xx_header.offset || xx_file_size - xx_header.offset < bytes)
+        throw std::runtime_error("Binary matrix file is truncated");
+}
+
+} // namespace detail
+
+/*! writes a matrix to a binary file one line at a time, so a matrix larger than the memory can be produced
+ \tparam tpDataType element type
+ \note the number of lines is not known beforehand; it is written into the header by close().
+ */
+template<typename tpDataType>
+class binary_writer {
+public:
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! creates (or truncates) the file xx_path
+     \param xx_length elements per line: the column dimension for storage_order::row_major, the row dimension otherwise
+     \param xx_order whether a line is a row or a column of the matrix
+     \throw std::domain_error for storage_order::tiled, see tiled_file; std::system_error if the file cannot be created
+     */
+    binary_writer(std::string const & xx_path, size_type const xx_length, storage_order const xx_order = storage_order::row_major) :
+                    m_file(xx_path, O_WRONLY | O_CREAT | O_TRUNC),
+                    m_length(xx_length),
+                    m_order(xx_order),
+                    m_count(0),
+                    m_position(sizeof(detail::binary_header))
+    {
+        if (m_order == storage_order::tiled)
+            throw std::domain_error("Tiled files are written tile by tile through tiled_file");
+        m_buffer.reserve(buffer_size);
+        detail::binary_header const header = detail::make_header<tpDataType>(0, 0, m_order);
+        m_file.write(&header, sizeof(header), 0);
+    }
+
+    binary_writer(binary_writer const &) = delete;
+    binary_writer & operator=(binary_writer const &) = delete;
+
+    /*! closes the file if close() was not called
+     \note errors are lost here; call close() to see them.
+     */
+    ~binary_writer()
+    {
+        if (m_file.fd() >= 0) {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! appends xx_n elements; they may end in the middle of a line
+     \throw std::system_error if writing fails
+     */
+    void append(tpDataType const * xx_data, size_type const xx_n)
+    {
+        size_type const bytes = xx_n * sizeof(tpDataType);
+        if (m_buffer.size() + bytes > buffer_size)
+            flush();
+        if (bytes >= buffer_size) {
+            m_file.write(xx_data, bytes, m_position);
+            m_position += bytes;
+        } else {
+            char const * const first = reinterpret_cast<char const *>(xx_data);
+            m_buffer.insert(m_buffer.end(), first, first + bytes);
+        }
+        m_count += xx_n;
+    }
+
+    /*! appends a row (column for storage_order::col_major) given as a vector, view or vector expression
+     \throw std::domain_error if its dimension is not the line length
+     */
+    template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+    void append(tpExpression const & xx_line)
+    {
+        if (detail::size(xx_line) != m_length)
+            throw std::domain_error("Line should have the dimension given to the writer");
+        if constexpr (!detail::is_node<tpExpression>::value) {
+            if (tpDataType const * const first = detail::contiguous(xx_line, 0, m_length)) {
+                append(first, m_length);
+                return;
+            }
+        }
+        m_line.resize(m_length);
+        detail::evaluate_range(m_line.data(), xx_line, 0, m_length);
+        append(m_line.data(), m_length);
+    }
+
+    /*! number of complete lines appended so far
+     */
+    size_type lines() const
+    {
+        return m_length > 0 ? m_count / m_length : 0;
+    }
+
+    /*! writes the buffered elements and the final header, then closes the file
+     \throw std::domain_error if the elements appended do not fill the last line; std::system_error if writing fails
+     */
+    void close()
+    {
+        flush();
+        if (m_length > 0 ? m_count % m_length != 0 : m_count != 0)
+            throw std::domain_error("Appended elements do not fill the last line");
+        size_type const lines = this->lines();
+        detail::binary_header const header = m_order == storage_order::row_major
+                        ? detail::make_header<tpDataType>(lines, m_length, m_order)
+                        : detail::make_header<tpDataType>(m_length, lines, m_order);
+        m_file.write(&header, sizeof(header), 0);
+        m_file.close();
+    }
+
+private:
+
+    static constexpr size_type buffer_size = size_type(1) << 20;
+
+    void flush()
+    {
+        m_file.write(m_buffer.data(), m_buffer.size(), m_position);
+        m_position += m_buffer.size();
+        m_buffer.clear();
+    }
+
+    detail::binary_file m_file;
+    size_type m_length;
+    storage_order m_order;
+    size_type m_count;
+    std::uint64_t m_position;
+    std::vector<char> m_buffer;
+    std::vector<tpDataType> m_line;
+};
+
+/*! binary matrix file mapped into memory; the elements are used in place and loaded by the operating system on access
+ \tparam tpDataType element type; const for a read-only mapping, otherwise changes are written back to the file
+ \note the mapping stays valid until the mapped_matrix is destroyed; views taken from it must not outlive it.
+ */
+template<typename tpDataType>
+class mapped_matrix {
+public:
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = typename std::remove_const<tpDataType>::type;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! maps the file xx_path
+     \throw std::system_error if the file cannot be opened or mapped, std::runtime_error if it is not a row-major or
+            column-major binary matrix file of value_type
+     */
+    explicit mapped_matrix(std::string const & xx_path)
+    {
+        constexpr bool writable = !std::is_const<tpDataType>::value;
+        detail::binary_file const file(xx_path, writable ? O_RDWR : O_RDONLY);
+        std::uint64_t const size = file.size();
+        if (size < sizeof(detail::binary_header))
+            throw std::runtime_error("Not a binary matrix file");
+
+        m_length = static_cast<size_type>(size);
+        m_map = ::mmap(nullptr, m_length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file.fd(), 0);
+        if (m_map == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "Cannot map " + xx_path);
+
+        detail::binary_header header;
+        std::memcpy(&header, m_map, sizeof(header));
+        try {
+            detail::check_header<value_type>(header, size);
+            if (header.order == static_cast<std::uint32_t>(storage_order::tiled))
+                throw std::runtime_error("Tiled binary matrix files are read through tiled_file");
+        } catch (...) {
+            ::munmap(m_map, m_length);
+            throw;
+        }
+        m_data = reinterpret_cast<tpDataType *>(static_cast<char *>(m_map) + header.offset);
+        m_dimR = static_cast<size_type>(header.dimR);
+        m_dimC = static_cast<size_type>(header.dimC);
+        m_order = static_cast<storage_order>(header.order);
+    }
+
+    mapped_matrix(mapped_matrix const &) = delete;
+    mapped_matrix & operator=(mapped_matrix const &) = delete;
+
+    mapped_matrix(mapped_matrix && xx_mapped) noexcept :
+                    m_map(std::exchange(xx_mapped.m_map, nullptr)),
+                    m_length(std::exchange(xx_mapped.m_length, 0)),
+                    m_data(std::exchange(xx_mapped.m_data, nullptr)),
+                    m_dimR(std::exchange(xx_mapped.m_dimR, 0)),
+                    m_dimC(std::exchange(xx_mapped.m_dimC, 0)),
+                    m_order(xx_mapped.m_order)
+    {
+    }
+
+    mapped_matrix & operator=(mapped_matrix && xx_mapped) noexcept
+    {
+        if (this != &xx_mapped) {
+            unmap();
+            m_map = std::exchange(xx_mapped.m_map, nullptr);
+            m_length = std::exchange(xx_mapped.m_length, 0);
+            m_data = std::exchange(xx_mapped.m_data, nullptr);
+            m_dimR = std::exchange(xx_mapped.m_dimR, 0);
+            m_dimC = std::exchange(xx_mapped.m_dimC, 0);
+            m_order = xx_mapped.m_order;
+        }
+        return *this;
+    }
+
+    ~mapped_matrix()
+    {
+        unmap();
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    /*! ()operator overload for indexing
+     * \note No bounds checking is done; the caller must pass valid indices.
+     */
+    tpDataType & operator()(size_type const dimR, size_type const dimC) const
+    {
+        return m_order == storage_order::row_major ? m_data[dimR * m_dimC + dimC] : m_data[dimC * m_dimR + dimR];
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! Get the row dimension of the matrix
+     */
+    size_type dimR() const
+    {
+        return m_dimR;
+    }
+
+    /*! Get the coloumn dimension of the matrix
+     */
+    size_type dimC() const
+    {
+        return m_dimC;
+    }
+
+    storage_order order() const
+    {
+        return m_order;
+    }
+
+    /*! pointer to the first element in the mapping
+     */
+    tpDataType * data() const
+    {
+        return m_data;
+    }
+
+    /*! view on the mapped elements; it is an operand of the expressions and multiply policies like any other view
+     \note a column-major file gives a view with unit row stride, as transpose() of a row-major one would.
+     */
+    matrix_view<tpDataType> view() const
+    {
+        if (m_order == storage_order::row_major)
+            return matrix_view<tpDataType>(m_data, m_dimR, m_dimC, static_cast<std::ptrdiff_t>(m_dimC), 1);
+        return matrix_view<tpDataType>(m_data, m_dimR, m_dimC, 1, static_cast<std::ptrdiff_t>(m_dimR));
+    }
+
+private:
+
+    void unmap()
+    {
+        if (m_map != nullptr)
+            ::munmap(m_map, m_length);
+        m_map = nullptr;
+    }
+
+    void * m_map = nullptr;
+    size_type m_length = 0;
+    tpDataType * m_data = nullptr;
+    size_type m_dimR = 0;
+    size_type m_dimC = 0;
+    storage_order m_order = storage_order::row_major;
+};
+
+/*! binary matrix file cut into tiles, read and written one whole tile at a time (Ex: by the out-of-core multiply)
+ \tparam tpDataType element type
+ \note a tile is tileR() x tileC() row-major elements. The parts of the edge tiles beyond the matrix are padding, zero
+       in a file created by tiled_file.
+ */
+template<typename tpDataType>
+class tiled_file {
+public:
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! opens the tiled file xx_path for reading
+     \throw std::system_error if the file cannot be read, std::runtime_error if it is not a tiled binary matrix file of
+            tpDataType
+     */
+    explicit tiled_file(std::string const & xx_path) :
+                    m_file(xx_path, O_RDONLY)
+    {
+        std::uint64_t const size = m_file.size();
+        if (size < sizeof(detail::binary_header))
+            throw std::runtime_error("Not a binary matrix file");
+
+        detail::binary_header header;
+        m_file.read(&header, sizeof(header), 0);
+        detail::check_header<tpDataType>(header, size);
+        if (header.order != static_cast<std::uint32_t>(storage_order::tiled))
+            throw std::runtime_error("Binary matrix file is not tiled");
+        m_dimR = static_cast<size_type>(header.dimR);
+        m_dimC = static_cast<size_type>(header.dimC);
+        m_tileR = header.tileR;
+        m_tileC = header.tileC;
+        m_offset = header.offset;
+    }
+
+    /*! creates (or truncates) the file xx_path holding an xx_dimR x xx_dimC matrix of zeros in xx_tileR x xx_tileC tiles
+     \throw std::domain_error if a tile dimension is zero or exceeds 2^32 - 1; std::system_error if the file cannot be
+            created
+     */
+    tiled_file(std::string const & xx_path, size_type const xx_dimR, size_type const xx_dimC, size_type const xx_tileR, size_type const xx_tileC) :
+                    m_file(check_tile(xx_path, xx_tileR, xx_tileC), O_RDWR | O_CREAT | O_TRUNC),
+                    m_dimR(xx_dimR),
+                    m_dimC(xx_dimC),
+                    m_tileR(xx_tileR),
+                    m_tileC(xx_tileC),
+                    m_offset(sizeof(detail::binary_header))
+    {
+        detail::binary_header const header = detail::make_header<tpDataType>(m_dimR, m_dimC, storage_order::tiled,
+                                                                             static_cast<std::uint32_t>(m_tileR),
+                                                                             static_cast<std::uint32_t>(m_tileC));
+        m_file.write(&header, sizeof(header), 0);
+        if (::ftruncate(m_file.fd(), static_cast<off_t>(position(tilesR(), 0))) != 0)
+            throw std::system_error(errno, std::generic_category(), "Cannot resize " + xx_path);
+    }
+
+    tiled_file(tiled_file const &) = delete;
+    tiled_file & operator=(tiled_file const &) = delete;
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! Get the row dimension of the matrix
+     */
+    size_type dimR() const
+    {
+        return m_dimR;
+    }
+
+    /*! Get the coloumn dimension of the matrix
+     */
+    size_type dimC() const
+    {
+        return m_dimC;
+    }
+
+    size_type tileR() const
+    {
+        return m_tileR;
+    }
+
+    size_type tileC() const
+    {
+        return m_tileC;
+    }
+
+    /*! number of tile rows
+     */
+    size_type tilesR() const
+    {
+        return (m_dimR + m_tileR - 1) / m_tileR;
+    }
+
+    /*! number of tile columns
+     */
+    size_type tilesC() const
+    {
+        return (m_dimC + m_tileC - 1) / m_tileC;
+    }
+
+    /*! rows of the tiles in tile row xx_I that lie inside the matrix
+     */
+    size_type rows(size_type const xx_I) const
+    {
+        return std::min(m_tileR, m_dimR - xx_I * m_tileR);
+    }
+
+    /*! columns of the tiles in tile column xx_J that lie inside the matrix
+     */
+    size_type cols(size_type const xx_J) const
+    {
+        return std::min(m_tileC, m_dimC - xx_J * m_tileC);
+    }
+
+    /*! reads tile (xx_I, xx_J), padding included, into the tileR() x tileC() elements at xx_out
+     \throw std::system_error if reading fails
+     */
+    void read_tile(size_type const xx_I, size_type const xx_J, tpDataType * xx_out) const
+    {
+        m_file.read(xx_out, m_tileR * m_tileC * sizeof(tpDataType), position(xx_I, xx_J));
+    }
+
+    /*! writes the tileR() x tileC() elements at xx_in to tile (xx_I, xx_J)
+     \note distinct tiles may be written from different threads at the same time.
+     \throw std::system_error if writing fails
+     */
+    void write_tile(size_type const xx_I, size_type const xx_J, tpDataType const * xx_in) const
+    {
+        m_file.write(xx_in, m_tileR * m_tileC * sizeof(tpDataType), position(xx_I, xx_J));
+    }
+
+private:
+
+    /*! xx_path, once the tile dimensions are known to fit into the header
+     */
+    static std::string const & check_tile(std::string const & xx_path, size_type const xx_tileR, size_type const xx_tileC)
+    {
+        constexpr size_type limit = std::numeric_limits<std::uint32_t>::max();
+        if (xx_tileR == 0 || xx_tileC == 0 || xx_tileR > limit || xx_tileC > limit)
+            throw std::domain_error("Tile dimensions should be positive and below 2^32");
+        return xx_path;
+    }
+
+    std::uint64_t position(size_type const xx_I, size_type const xx_J) const
+    {
+        return m_offset + (static_cast<std::uint64_t>(xx_I) * tilesC() + xx_J) * m_tileR * m_tileC * sizeof(tpDataType);
+    }
+
+    detail::binary_file m_file;
+    size_type m_dimR;
+    size_type m_dimC;
+    size_type m_tileR;
+    size_type m_tileC;
+    std::uint64_t m_offset;
+};
+
+/*! writes a matrix, view or matrix expression to the binary file xx_path in row-major order
+ \throw std::system_error if the file cannot be written
+ */
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+void write_binary(std::string const & xx_path, tpExpression const & xx_matrix)
+{
+    using value_type = typename detail::traits<tpExpression>::value_type;
+    std::size_t const dimR = xx_matrix.dimR();
+    std::size_t const dimC = xx_matrix.dimC();
+
+    binary_writer<value_type> writer(xx_path, dimC);
+    if constexpr (!detail::is_node<tpExpression>::value && !detail::is_view<tpExpression>::value) {
+        writer.append(xx_matrix.data(), dimR * dimC);
+    } else {
+        std::vector<value_type> row(dimC);
+        for (std::size_t R = 0; R < dimR; ++R) {
+            value_type const * first = nullptr;
+            if constexpr (detail::is_view<tpExpression>::value)
+                first = detail::contiguous(xx_matrix, R * dimC, dimC);
+            if (first == nullptr) {
+                detail::evaluate_range(row.data(), xx_matrix, R * dimC, dimC);
+                first = row.data();
+            }
+            writer.append(first, dimC);
+        }
+    }
+    writer.close();
+}
+
+/*! writes a matrix, view or matrix expression to the binary file xx_path in xx_tileR x xx_tileC tiles
+ \note evaluates one tile at a time, so the view of a mapped_matrix larger than the memory can be converted.
+ \throw std::domain_error if a tile dimension is zero; std::system_error if the file cannot be written
+ */
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+void write_tiled(std::string const & xx_path, tpExpression const & xx_matrix, std::size_t const xx_tileR, std::size_t const xx_tileC)
+{
+    using value_type = typename detail::traits<tpExpression>::value_type;
+    std::size_t const dimC = xx_matrix.dimC();
+
+    tiled_file<value_type> const file(xx_path, xx_matrix.dimR(), dimC, xx_tileR, xx_tileC);
+    std::vector<value_type> tile(xx_tileR * xx_tileC);
+    for (std::size_t I = 0; I < file.tilesR(); ++I) {
+        for (std::size_t J = 0; J < file.tilesC(); ++J) {
+            if (file.rows(I) < xx_tileR || file.cols(J) < xx_tileC)
+                std::fill(tile.begin(), tile.end(), value_type(0));
+            for (std::size_t r = 0; r < file.rows(I); ++r)
+                detail::evaluate_range(tile.data() + r * xx_tileC, xx_matrix, (I * xx_tileR + r) * dimC + J * xx_tileC, file.cols(J));
+            file.write_tile(I, J, tile.data());
+        }
+    }
+}
+
+/*! reads the binary file xx_path into a new matrix
+ \tparam tpDataType element type stored in the file
+ \note the elements are read straight into the matrix storage; a column-major file is transposed after reading and a
+       tiled one is read tile by tile.
+ \throw std::system_error if the file cannot be read, std::runtime_error if it is not a binary matrix file of tpDataType
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+matrix<tpDataType, tpPolicyType> read_binary(std::string const & xx_path)
+{
+    detail::binary_file const file(xx_path, O_RDONLY);
+    std::uint64_t const size = file.size();
+    if (size < sizeof(detail::binary_header))
+        throw std::runtime_error("Not a binary matrix file");
+
+    detail::binary_header header;
+    file.read(&header, sizeof(header), 0);
+    detail::check_header<tpDataType>(header, size);
+
+    std::size_t const dimR = static_cast<std::size_t>(header.dimR);
+    std::size_t const dimC = static_cast<std::size_t>(header.dimC);
+    if (static_cast<storage_order>(header.order) == storage_order::row_major) {
+        matrix<tpDataType, tpPolicyType> result(dimR, dimC);
+        file.read(result.data(), dimR * dimC * sizeof(tpDataType), header.offset);
+        return result;
+    }
+    if (static_cast<storage_order>(header.order) == storage_order::tiled) {
+        tiled_file<tpDataType> const tiles(xx_path);
+        matrix<tpDataType, tpPolicyType> result(dimR, dimC);
+        std::vector<tpDataType> tile(tiles.tileR() * tiles.tileC());
+        for (std::size_t I = 0; I < tiles.tilesR(); ++I) {
+            for (std::size_t J = 0; J < tiles.tilesC(); ++J) {
+                tiles.read_tile(I, J, tile.data());
+                for (std::size_t r = 0; r < tiles.rows(I); ++r)
+                    std::copy_n(tile.data() + r * tiles.tileC(), tiles.cols(J), result.data() + (I * tiles.tileR() + r) * dimC + J * tiles.tileC());
+            }
+        }
+        return result;
+    }
+    matrix<tpDataType, tpPolicyType> columns(dimC, dimR);
+    file.read(columns.data(), dimR * dimC * sizeof(tpDataType), header.offset);
+    return matrix<tpDataType, tpPolicyType>(matrix_view<tpDataType const>(columns.data(), dimR, dimC, 1, static_cast<std::ptrdiff_t>(dimR)));
+}
+
+}
+#endif /* binary_h */
@@ -0,0 +1,217 @@
+/*
+ //  cholesky.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the Cholesky factorization A = L * L^T of a symmetric positive definite assignment::matrix and
+ the solves, determinant and inverse built on it. It takes half the work of the LU factorization and needs no pivoting.
+ The factorization is blocked and right-looking like the LU: a panel of columns is computed row by row, and the lower
+ triangle of the trailing matrix is updated by products of the multiply policy, so Parallel speeds it up as well.
+ */
+#ifndef cholesky_h
+#define cholesky_h
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "triangular.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+
+/*! Cholesky factorization A = L * L^T of a symmetric positive definite matrix
+ \tparam tpDataType element type; floating point
+ \tparam tpPolicyType multiply policy of the trailing updates and of the solves
+ \note only the lower triangle of the factored matrix is read. Factor once, then solve() any number of right-hand sides.
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class cholesky_factorization {
+public:
+
+    static_assert(std::is_floating_point<tpDataType>::value, "Cholesky factorization needs a floating point element type");
+
+    /*! type of the factored and solved matrices
+     */
+    using matrix_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! factors xx_matrix; pass an rvalue to factor in its storage without a copy
+     \throw std::domain_error if the matrix is not square or not positive definite
+     */
+    explicit cholesky_factorization(matrix_type xx_matrix) :
+                    m_factor(std::move(xx_matrix))
+    {
+        if (m_factor.dimR() != m_factor.dimC())
+            throw std::domain_error("Matrix should be square");
+        factor();
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! get dimension of the factored matrix
+     */
+    size_type dim() const
+    {
+        return m_factor.dimR();
+    }
+
+    /*! the lower triangular factor L; its upper triangle is zero
+     */
+    matrix_type const & factor_lower() const
+    {
+        return m_factor;
+    }
+
+    /*! determinant of the factored matrix: the square of the product of the diagonal of L
+     */
+    tpDataType determinant() const
+    {
+        tpDataType result = tpDataType(1);
+        for (size_type i = 0; i < dim(); ++i)
+            result *= m_factor(i, i);
+        return result * result;
+    }
+
+    /*! solves A * x = xx_rhs as L * y = xx_rhs, then L^T * x = y
+     \throw std::domain_error if the dimension of xx_rhs differs
+     */
+    template<typename tpVectorAllocator>
+    vector<tpDataType, tpVectorAllocator> solve(vector<tpDataType, tpVectorAllocator> xx_rhs) const
+    {
+        if (xx_rhs.dim() != dim())
+            throw std::domain_error("Vector should have the dimension of the matrix");
+
+        using policy = typename matrix_type::policy_type;
+        std::ptrdiff_t const rs = static_cast<std::ptrdiff_t>(dim());
+        std::vector<tpDataType> temp;
+        detail::solve_vector<policy>(dim(), m_factor.data(), rs, 1, triangle::lower, false, xx_rhs.data(), temp);
+        detail::solve_vector<policy>(dim(), m_factor.data(), 1, rs, triangle::upper, false, xx_rhs.data(), temp);
+        return xx_rhs;
+    }
+
+    /*! solves A * X = xx_rhs for all columns of xx_rhs at once
+     \throw std::domain_error if the row dimension of xx_rhs differs
+     */
+    matrix_type solve(matrix_type xx_rhs) const
+    {
+        if (xx_rhs.dimR() != dim())
+            throw std::domain_error("Matrix should have the row dimension of the factored matrix");
+
+        using policy = typename matrix_type::policy_type;
+        std::ptrdiff_t const rs = static_cast<std::ptrdiff_t>(dim());
+        std::ptrdiff_t const rsB = static_cast<std::ptrdiff_t>(xx_rhs.dimC());
+        std::vector<tpDataType> temp;
+        detail::solve_blocked<policy>(dim(), xx_rhs.dimC(), m_factor.data(), rs, 1, triangle::lower, false, xx_rhs.data(), rsB, temp);
+        detail::solve_blocked<policy>(dim(), xx_rhs.dimC(), m_factor.data(), 1, rs, triangle::upper, false, xx_rhs.data(), rsB, temp);
+        return xx_rhs;
+    }
+
+    /*! inverse of the factored matrix, solved for the identity
+     */
+    matrix_type inverse() const
+    {
+        matrix_type identity(dim(), dim(), tpDataType(0));
+        for (size_type i = 0; i < dim(); ++i)
+            identity(i, i) = tpDataType(1);
+        return solve(std::move(identity));
+    }
+
+private:
+
+    /*! right-looking blocked factorization of the lower triangle in place
+     */
+    void factor()
+    {
+        using policy = typename matrix_type::policy_type;
+        constexpr size_type NB = detail::factor_blocking::NB;
+        constexpr size_type NC = detail::factor_blocking::NC;
+        size_type const n = dim();
+        std::ptrdiff_t const rs = static_cast<std::ptrdiff_t>(n);
+        tpDataType * const a = m_factor.data();
+        std::vector<tpDataType> temp;
+
+        for (size_type k = 0; k < n; k += NB) {
+            size_type const b = std::min(NB, n - k);
+
+            // L11 row by row, then the rows of L21 = A21 * L11^-T, which are independent of each other
+            factor_rows(k, b, k, k + b);
+            size_type const rest = n - k - b;
+            if (policy::is_parallel && rest * b * b >= 2 * detail::factor_min_chunk)
+                thread_pool::current().parallel_for(k + b, n, std::max<size_type>(1, detail::factor_min_chunk / (b * b)),
+                                                    [&](size_type const xx_first, size_type const xx_last) { factor_rows(k, b, xx_first, xx_last); });
+            else
+                factor_rows(k, b, k + b, n);
+
+            // A22 -= L21 * L21^T on and below the diagonal, a strip of columns at a time
+            for (size_type C = k + b; C < n; C += NC) {
+                size_type const width = std::min(NC, n - C);
+                detail::subtract_product<policy>(n - C, width, b, a + C * n + k, rs, 1, a + C * n + k, 1, rs, a + C * n + C, rs, temp);
+            }
+        }
+
+        for (size_type i = 0; i < n; ++i)
+            std::fill(a + i * n + i + 1, a + (i + 1) * n, tpDataType(0));
+    }
+
+    /*! computes columns xx_k ... xx_k + xx_b - 1 of the rows xx_first ... xx_last - 1 of L
+     \note every element is its entry of A minus the dot product of the two rows of L left of it within the panel; the
+     columns left of the panel were subtracted by the trailing updates already.
+     \throw std::domain_error if a diagonal element is not positive
+     */
+    void factor_rows(size_type const xx_k, size_type const xx_b, size_type const xx_first, size_type const xx_last)
+    {
+        size_type const n = dim();
+        tpDataType * const a = m_factor.data();
+        for (size_type i = xx_first; i < xx_last; ++i) {
+            tpDataType * const row = a + i * n + xx_k;
+            size_type const last = std::min(i - xx_k + 1, xx_b);
+            for (size_type j = 0; j < last; ++j) {
+                tpDataType const * const pivot_row = a + (xx_k + j) * n + xx_k;
+                tpDataType sum = tpDataType(0);
+                detail::simd::dot<1>(&sum, &pivot_row, row, j);
+                tpDataType const value = row[j] - sum;
+                if (xx_k + j == i) {
+                    if (!(value > tpDataType(0)))
+                        throw std::domain_error("Matrix is not positive definite");
+                    row[j] = std::sqrt(value);
+                } else {
+                    row[j] = value / pivot_row[j];
+                }
+            }
+        }
+    }
+
+    matrix_type m_factor;
+};
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! lower triangular factor L of a symmetric positive definite matrix, A = L * L^T
+ \throw std::domain_error if the matrix is not square or not positive definite
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> cholesky(matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_matrix)
+{
+    return cholesky_factorization<tpDataType, tpPolicyType, tpAllocatorType>(std::move(xx_matrix)).factor_lower();
+}
+
+}
+#endif /* cholesky_h */
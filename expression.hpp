@@ -0,0 +1,693 @@
+/*
+ //  expression.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the lazy expression objects built by the element-wise matrix and vector operators.
+ An expression like v1 + v2 * 3 only records its operands; the elements are computed in one fused pass when it is
+ assigned to (or used to construct) a matrix or vector, so no intermediate is allocated.
+ */
+#ifndef expression_h
+#define expression_h
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+
+namespace assignment {
+
+/*! kind of an expression; only expressions of the same kind can be combined element-wise
+ */
+struct vector_kind {
+};
+struct matrix_kind {
+};
+
+/*! base of all expression nodes
+ */
+struct expression_node {
+};
+
+/*! base of the non-owning, strided views on matrix and vector storage
+ \note views are leaves of expressions, but their elements are not necessarily contiguous.
+ */
+struct view_node {
+};
+
+/*! describes a type taking part in an expression
+ \note specialised next to matrix and vector for the leaves; nodes describe themselves.
+ */
+template<typename tpType, typename = void>
+struct expression_traits {
+    static constexpr bool is_expression = false;
+    static constexpr bool is_leaf = false;
+};
+
+template<typename tpType>
+struct expression_traits<tpType, typename std::enable_if<std::is_base_of<expression_node, tpType>::value>::type> {
+    static constexpr bool is_expression = true;
+    static constexpr bool is_leaf = false;
+    using kind = typename tpType::kind;
+    using value_type = typename tpType::value_type;
+    using result_type = typename tpType::result_type;
+
+    static std::size_t size(tpType const & xx_expression)
+    {
+        return xx_expression.size();
+    }
+};
+
+namespace detail {
+
+template<typename tpType>
+using traits = expression_traits<typename std::decay<tpType>::type>;
+
+/*! true if tpType is an expression of kind tpKind
+ */
+template<typename tpType, typename tpKind, typename = void>
+struct is_kind : std::false_type {
+};
+
+template<typename tpType, typename tpKind>
+struct is_kind<tpType, tpKind, typename std::enable_if<traits<tpType>::is_expression>::type> : std::is_same<typename traits<tpType>::kind, tpKind> {
+};
+
+/*! true if tpType is an expression node, i.e. not a plain matrix or vector
+ */
+template<typename tpType>
+struct is_node : std::is_base_of<expression_node, typename std::decay<tpType>::type> {
+};
+
+/*! true if tpType is a view on matrix or vector storage
+ */
+template<typename tpType>
+struct is_view : std::is_base_of<view_node, typename std::decay<tpType>::type> {
+};
+
+/*! true if a view takes part in the expression
+ \note matrix expressions containing a view are evaluated row by row, as a view's rows need not be adjacent.
+ */
+template<typename tpType, typename = void>
+struct has_view : is_view<tpType> {
+};
+
+template<typename tpType>
+struct has_view<tpType, typename std::enable_if<is_node<tpType>::value>::type> : std::integral_constant<bool, std::decay<tpType>::type::has_view> {
+};
+
+/*! true if both operands are expressions of the same kind and element type
+ */
+template<typename tpLeft, typename tpRight, typename = void>
+struct are_compatible : std::false_type {
+};
+
+template<typename tpLeft, typename tpRight>
+struct are_compatible<tpLeft, tpRight, typename std::enable_if<traits<tpLeft>::is_expression && traits<tpRight>::is_expression>::type> : std::integral_constant<bool,
+                std::is_same<typename traits<tpLeft>::kind, typename traits<tpRight>::kind>::value
+                                && std::is_same<typename traits<tpLeft>::value_type, typename traits<tpRight>::value_type>::value> {
+};
+
+/*! true if tpType is an expression node or a view of kind tpKind with elements of type tpValue
+ \note used to enable construction and assignment of a matrix or vector from an expression
+ */
+template<typename tpType, typename tpKind, typename tpValue, typename = void>
+struct is_node_of : std::false_type {
+};
+
+template<typename tpType, typename tpKind, typename tpValue>
+struct is_node_of<tpType, tpKind, tpValue, typename std::enable_if<is_node<tpType>::value || is_view<tpType>::value>::type> : std::integral_constant<bool,
+                std::is_same<typename traits<tpType>::kind, tpKind>::value && std::is_same<typename traits<tpType>::value_type, tpValue>::value> {
+};
+
+/*! how an operand is held by a node: lvalue leaves by reference, everything else by value
+ \note temporaries are moved into the node, so an expression never refers to a dead matrix or vector.
+ */
+template<typename tpType>
+using operand_t = typename std::conditional<std::is_lvalue_reference<tpType>::value && traits<tpType>::is_leaf,
+                typename std::decay<tpType>::type const &, typename std::decay<tpType>::type>::type;
+
+/*! total number of elements of an expression
+ */
+template<typename tpExpression>
+std::size_t size(tpExpression const & xx_expression)
+{
+    return traits<tpExpression>::size(xx_expression);
+}
+
+/*! number of leading elements for which every operand of the expression has a value
+ \note vector operands shorter than the left-most one only take part in their leading elements.
+ */
+template<typename tpExpression>
+std::size_t overlap(tpExpression const & xx_expression)
+{
+    if constexpr (is_node<tpExpression>::value)
+        return xx_expression.overlap();
+    else
+        return detail::size(xx_expression);
+}
+
+/*! element xx_idx of an expression; valid for xx_idx < overlap()
+ */
+template<typename tpExpression>
+typename traits<tpExpression>::value_type element(tpExpression const & xx_expression, std::size_t const xx_idx)
+{
+    if constexpr (is_node<tpExpression>::value)
+        return xx_expression[xx_idx];
+    else if constexpr (is_view<tpExpression>::value)
+        return xx_expression.at(xx_idx);
+    else
+        return xx_expression.data()[xx_idx];
+}
+
+/*! element xx_idx of an expression; valid for xx_idx < size()
+ */
+template<typename tpExpression>
+typename traits<tpExpression>::value_type element_at(tpExpression const & xx_expression, std::size_t const xx_idx)
+{
+    if constexpr (is_node<tpExpression>::value || is_view<tpExpression>::value)
+        return xx_expression.at(xx_idx);
+    else
+        return xx_expression.data()[xx_idx];
+}
+
+/*! pointer to the elements xx_first ... xx_first + xx_n - 1 of a leaf if they are adjacent in memory, nullptr otherwise
+ */
+template<typename tpExpression>
+typename traits<tpExpression>::value_type const * contiguous(tpExpression const & xx_expression, std::size_t const xx_first, std::size_t const xx_n)
+{
+    if constexpr (is_view<tpExpression>::value)
+        return xx_expression.contiguous(xx_first, xx_n);
+    else
+        return xx_expression.data() + xx_first;
+}
+
+/*! writes the elements xx_first ... xx_first + xx_n - 1 (all below overlap()) of an expression to xx_out
+ \note for a matrix expression containing a view the range must not cross the end of a row.
+ */
+template<typename tpExpression>
+void evaluate_range(typename traits<tpExpression>::value_type * xx_out, tpExpression const & xx_expression, std::size_t const xx_first, std::size_t const xx_n)
+{
+    if constexpr (is_node<tpExpression>::value) {
+        xx_expression.evaluate(xx_out, xx_first, xx_n);
+    } else if constexpr (is_view<tpExpression>::value) {
+        xx_expression.gather(xx_out, xx_first, xx_n);
+    } else {
+        std::copy(xx_expression.data() + xx_first, xx_expression.data() + xx_first + xx_n, xx_out);
+    }
+}
+
+/*! true if xx_predicate holds for any leaf of the expression
+ \note used to find operands sharing storage with the destination of an assignment.
+ */
+template<typename tpExpression, typename tpPredicate>
+bool any_leaf(tpExpression const & xx_expression, tpPredicate const & xx_predicate)
+{
+    if constexpr (is_node<tpExpression>::value)
+        return xx_expression.any_leaf(xx_predicate);
+    else
+        return xx_predicate(xx_expression);
+}
+
+/*! memory layout of a leaf: element (R, C) at data[R * rs + C * cs], element i of a vector at data[i * rs]
+ \note first and last are the lowest and highest address touched, nullptr for an empty leaf.
+ */
+template<typename tpDataType>
+struct layout {
+    tpDataType const * data;
+    std::ptrdiff_t rs;
+    std::ptrdiff_t cs;
+    tpDataType const * first;
+    tpDataType const * last;
+};
+
+template<typename tpLeaf>
+layout<typename traits<tpLeaf>::value_type> layout_of(tpLeaf const & xx_leaf)
+{
+    if constexpr (is_view<tpLeaf>::value) {
+        return xx_leaf.layout();
+    } else {
+        auto const * const data = xx_leaf.data();
+        std::size_t const n = size(xx_leaf);
+        if constexpr (std::is_same<typename traits<tpLeaf>::kind, matrix_kind>::value)
+            return {data, static_cast<std::ptrdiff_t>(xx_leaf.dimC()), 1, n > 0 ? data : nullptr, n > 0 ? data + n - 1 : nullptr};
+        else
+            return {data, 1, 0, n > 0 ? data : nullptr, n > 0 ? data + n - 1 : nullptr};
+    }
+}
+
+/*! true if the address ranges of two layouts intersect
+ */
+template<typename tpDataType>
+bool overlaps(layout<tpDataType> const & xx_left, layout<tpDataType> const & xx_right)
+{
+    std::less<tpDataType const *> const less;
+    return xx_left.first != nullptr && xx_right.first != nullptr && !less(xx_left.last, xx_right.first) && !less(xx_right.last, xx_left.first);
+}
+
+/*! true if evaluating an expression element by element into the storage xx_out could read an element after it was overwritten
+ \note an operand with exactly the layout of the destination is harmless, as every element only depends on the operands'
+ element at the same index; only views (Ex: a transpose or a shifted block of the destination) can alias otherwise.
+ */
+template<typename tpExpression, typename tpDataType>
+bool aliases(tpExpression const & xx_expression, layout<tpDataType> const & xx_out)
+{
+    if constexpr (!has_view<tpExpression>::value) {
+        return false;
+    } else {
+        return any_leaf(xx_expression, [&](auto const & xx_leaf) {
+            auto const in = layout_of(xx_leaf);
+            return overlaps(in, xx_out) && (in.data != xx_out.data || in.rs != xx_out.rs || in.cs != xx_out.cs);
+        });
+    }
+}
+
+/*! plain operand owned by an expression node that can hold its result, or nullptr
+ \tparam tpResult type of the matrix or vector to be built
+ \tparam tpOperand type the operand is held as; lvalue leaves are held by reference and never given away
+ \param xx_size number of elements of the result
+ */
+template<typename tpResult, typename tpOperand>
+tpResult * donor(typename std::remove_reference<tpOperand>::type & xx_operand, std::size_t const xx_size)
+{
+    if constexpr (is_node<tpOperand>::value) {
+        tpResult * const candidate = xx_operand.template donor<tpResult>();
+        return candidate != nullptr && detail::size(*candidate) == xx_size ? candidate : nullptr;
+    } else if constexpr (!std::is_reference<tpOperand>::value && std::is_same<tpOperand, tpResult>::value) {
+        return detail::size(xx_operand) == xx_size ? &xx_operand : nullptr;
+    } else {
+        return nullptr;
+    }
+}
+
+/*! writes every element of an expression to xx_out in a single pass
+ \note xx_out may be the storage of one of the operands, as each element only depends on the operands' element at the same index.
+ */
+template<typename tpExpression>
+void evaluate(typename traits<tpExpression>::value_type * xx_out, tpExpression const & xx_expression)
+{
+    if constexpr (is_view<tpExpression>::value) {
+        xx_expression.copy_to(xx_out);
+        return;
+    }
+
+    if constexpr (has_view<tpExpression>::value && std::is_same<typename traits<tpExpression>::kind, matrix_kind>::value) {
+        std::size_t const dimC = xx_expression.dimC();
+        for (std::size_t R = 0; R < xx_expression.dimR(); ++R)
+            evaluate_range(xx_out + R * dimC, xx_expression, R * dimC, dimC);
+        return;
+    }
+
+    std::size_t const common = overlap(xx_expression);
+    std::size_t const total = detail::size(xx_expression);
+
+    evaluate_range(xx_out, xx_expression, 0, common);
+    for (std::size_t i = common; i < total; ++i)
+        xx_out[i] = element_at(xx_expression, i);
+}
+
+/*! evaluates an expression into a new matrix or vector of type tpResult
+ \note a temporary expression owning a plain operand of the result's shape (Ex: the product in m1 * m2 + m3) is evaluated
+ in place into that operand, whose storage is then moved into the result instead of allocating.
+ */
+template<typename tpResult, typename tpExpression>
+tpResult materialize(tpExpression && xx_expression)
+{
+    if constexpr (!std::is_lvalue_reference<tpExpression>::value && is_node<tpExpression>::value) {
+        tpResult * const storage = xx_expression.template donor<tpResult>();
+        if (storage != nullptr) {
+            evaluate(storage->data(), xx_expression);
+            return std::move(*storage);
+        }
+    }
+
+    if constexpr (std::is_same<typename traits<tpExpression>::kind, matrix_kind>::value) {
+        tpResult result(xx_expression.dimR(), xx_expression.dimC());
+        evaluate(result.data(), xx_expression);
+        return result;
+    } else {
+        tpResult result(detail::size(xx_expression));
+        evaluate(result.data(), xx_expression);
+        return result;
+    }
+}
+
+}
+
+/* ==== n  o  d  e  s ==== */
+
+/*! shape of an expression, taken from its left-most operand
+ \tparam tpLeft (possibly reference) type of the left-most operand
+ */
+template<typename tpLeft>
+class expression_shape : public expression_node {
+public:
+    using kind = typename detail::traits<tpLeft>::kind;
+    using value_type = typename detail::traits<tpLeft>::value_type;
+    using result_type = typename detail::traits<tpLeft>::result_type;
+    using size_type = std::size_t;
+
+    explicit expression_shape(typename std::remove_reference<tpLeft>::type const & xx_left) :
+                    m_size(detail::size(xx_left))
+    {
+    }
+
+    /*! total number of elements
+     */
+    size_type size() const
+    {
+        return m_size;
+    }
+
+private:
+    size_type m_size;
+};
+
+/*! element-wise combination of two expressions
+ \tparam tpOp operation
+ \tparam tpLeft left operand; a const reference for lvalue leaves, a value otherwise
+ \tparam tpRight right operand; a const reference for lvalue leaves, a value otherwise
+ */
+template<detail::simd::op tpOp, typename tpLeft, typename tpRight>
+class binary_expression : public expression_shape<tpLeft> {
+public:
+    using typename expression_shape<tpLeft>::value_type;
+    using typename expression_shape<tpLeft>::size_type;
+
+    static constexpr bool has_view = detail::has_view<tpLeft>::value || detail::has_view<tpRight>::value;
+
+    /*! constructor
+     \throw std::domain_error if two matrix operands do not have the same dimensions
+     */
+    template<typename tpLeftArg, typename tpRightArg>
+    binary_expression(tpLeftArg && xx_left, tpRightArg && xx_right) :
+                    expression_shape<tpLeft>(xx_left),
+                    m_left(std::forward<tpLeftArg>(xx_left)),
+                    m_right(std::forward<tpRightArg>(xx_right))
+    {
+        if constexpr (std::is_same<typename expression_shape<tpLeft>::kind, matrix_kind>::value) {
+            if (m_left.dimR() != m_right.dimR() || m_left.dimC() != m_right.dimC())
+                throw std::domain_error("Matrices should have same dimension");
+        }
+    }
+
+    size_type overlap() const
+    {
+        return std::min(detail::overlap(m_left), detail::overlap(m_right));
+    }
+
+    value_type operator[](size_type const xx_idx) const
+    {
+        return detail::simd::apply<tpOp>(detail::element(m_left, xx_idx), detail::element(m_right, xx_idx));
+    }
+
+    /*! checked element access; past the end of the right operand the left element is passed through
+     */
+    value_type at(size_type const xx_idx) const
+    {
+        if (xx_idx < detail::size(m_right))
+            return detail::simd::apply<tpOp>(detail::element_at(m_left, xx_idx), detail::element_at(m_right, xx_idx));
+        return detail::element_at(m_left, xx_idx);
+    }
+
+    /*! writes the elements xx_first ... xx_first + xx_n - 1; two operands with contiguous elements go through the SIMD kernels
+     */
+    void evaluate(value_type * xx_out, size_type const xx_first, size_type const xx_n) const
+    {
+        if constexpr (!detail::is_node<tpLeft>::value && !detail::is_node<tpRight>::value) {
+            value_type const * const left = detail::contiguous(m_left, xx_first, xx_n);
+            value_type const * const right = detail::contiguous(m_right, xx_first, xx_n);
+            if (left != nullptr && right != nullptr) {
+                detail::simd::binary<tpOp>(xx_out, left, right, xx_n);
+                return;
+            }
+        }
+        for (size_type i = 0; i < xx_n; ++i)
+            xx_out[i] = (*this)[xx_first + i];
+    }
+
+    template<typename tpPredicate>
+    bool any_leaf(tpPredicate const & xx_predicate) const
+    {
+        return detail::any_leaf(m_left, xx_predicate) || detail::any_leaf(m_right, xx_predicate);
+    }
+
+    /*! an owned plain operand with the shape of the result, if any
+     */
+    template<typename tpResult>
+    tpResult * donor()
+    {
+        tpResult * const left = detail::donor<tpResult, tpLeft>(m_left, this->size());
+        return left != nullptr ? left : detail::donor<tpResult, tpRight>(m_right, this->size());
+    }
+
+    size_type dim() const
+    {
+        return m_left.dim();
+    }
+
+    size_type dimR() const
+    {
+        return m_left.dimR();
+    }
+
+    size_type dimC() const
+    {
+        return m_left.dimC();
+    }
+
+private:
+    tpLeft m_left;
+    tpRight m_right;
+};
+
+/*! element-wise combination of an expression with a scalar on the right
+ \tparam tpOp operation
+ \tparam tpLeft expression operand; a const reference for lvalue leaves, a value otherwise
+ */
+template<detail::simd::op tpOp, typename tpLeft>
+class scalar_expression : public expression_shape<tpLeft> {
+public:
+    using typename expression_shape<tpLeft>::value_type;
+    using typename expression_shape<tpLeft>::size_type;
+
+    static constexpr bool has_view = detail::has_view<tpLeft>::value;
+
+    template<typename tpLeftArg>
+    scalar_expression(tpLeftArg && xx_left, value_type const & xx_scalar) :
+                    expression_shape<tpLeft>(xx_left),
+                    m_left(std::forward<tpLeftArg>(xx_left)),
+                    m_scalar(xx_scalar)
+    {
+    }
+
+    size_type overlap() const
+    {
+        return detail::overlap(m_left);
+    }
+
+    value_type operator[](size_type const xx_idx) const
+    {
+        return detail::simd::apply<tpOp>(detail::element(m_left, xx_idx), m_scalar);
+    }
+
+    value_type at(size_type const xx_idx) const
+    {
+        return detail::simd::apply<tpOp>(detail::element_at(m_left, xx_idx), m_scalar);
+    }
+
+    /*! writes the elements xx_first ... xx_first + xx_n - 1; an operand with contiguous elements goes through the SIMD kernels
+     */
+    void evaluate(value_type * xx_out, size_type const xx_first, size_type const xx_n) const
+    {
+        if constexpr (!detail::is_node<tpLeft>::value) {
+            value_type const * const left = detail::contiguous(m_left, xx_first, xx_n);
+            if (left != nullptr) {
+                detail::simd::broadcast<tpOp>(xx_out, left, m_scalar, xx_n);
+                return;
+            }
+        }
+        for (size_type i = 0; i < xx_n; ++i)
+            xx_out[i] = (*this)[xx_first + i];
+    }
+
+    template<typename tpPredicate>
+    bool any_leaf(tpPredicate const & xx_predicate) const
+    {
+        return detail::any_leaf(m_left, xx_predicate);
+    }
+
+    /*! an owned plain operand with the shape of the result, if any
+     */
+    template<typename tpResult>
+    tpResult * donor()
+    {
+        return detail::donor<tpResult, tpLeft>(m_left, this->size());
+    }
+
+    size_type dim() const
+    {
+        return m_left.dim();
+    }
+
+    size_type dimR() const
+    {
+        return m_left.dimR();
+    }
+
+    size_type dimC() const
+    {
+        return m_left.dimC();
+    }
+
+private:
+    tpLeft m_left;
+    value_type m_scalar;
+};
+
+/*! element-wise negation of an expression
+ \tparam tpOperand operand; a const reference for lvalue leaves, a value otherwise
+ */
+template<typename tpOperand>
+class negate_expression : public expression_shape<tpOperand> {
+public:
+    using typename expression_shape<tpOperand>::value_type;
+    using typename expression_shape<tpOperand>::size_type;
+
+    static constexpr bool has_view = detail::has_view<tpOperand>::value;
+
+    template<typename tpOperandArg>
+    explicit negate_expression(tpOperandArg && xx_operand) :
+                    expression_shape<tpOperand>(xx_operand),
+                    m_operand(std::forward<tpOperandArg>(xx_operand))
+    {
+    }
+
+    size_type overlap() const
+    {
+        return detail::overlap(m_operand);
+    }
+
+    value_type operator[](size_type const xx_idx) const
+    {
+        return -detail::element(m_operand, xx_idx);
+    }
+
+    value_type at(size_type const xx_idx) const
+    {
+        return -detail::element_at(m_operand, xx_idx);
+    }
+
+    void evaluate(value_type * xx_out, size_type const xx_first, size_type const xx_n) const
+    {
+        for (size_type i = 0; i < xx_n; ++i)
+            xx_out[i] = (*this)[xx_first + i];
+    }
+
+    template<typename tpPredicate>
+    bool any_leaf(tpPredicate const & xx_predicate) const
+    {
+        return detail::any_leaf(m_operand, xx_predicate);
+    }
+
+    /*! an owned plain operand with the shape of the result, if any
+     */
+    template<typename tpResult>
+    tpResult * donor()
+    {
+        return detail::donor<tpResult, tpOperand>(m_operand, this->size());
+    }
+
+    size_type dim() const
+    {
+        return m_operand.dim();
+    }
+
+    size_type dimR() const
+    {
+        return m_operand.dimR();
+    }
+
+    size_type dimC() const
+    {
+        return m_operand.dimC();
+    }
+
+private:
+    tpOperand m_operand;
+};
+
+/* ==== f  r  e  e     o  p  e  r  a  t  o  r  s ==== */
+
+/*! + operator: lazy element-wise sum of two matrices or two vectors
+ \throw std::domain_error if two matrices do not have the same dimensions
+ \note a shorter right vector only adds to the leading elements
+ */
+template<typename tpLeft, typename tpRight, typename std::enable_if<detail::are_compatible<tpLeft, tpRight>::value>::type* = nullptr>
+binary_expression<detail::simd::op::add, detail::operand_t<tpLeft>, detail::operand_t<tpRight>> operator+(tpLeft && xx_left, tpRight && xx_right)
+{
+    return {std::forward<tpLeft>(xx_left), std::forward<tpRight>(xx_right)};
+}
+
+/*! - operator: lazy element-wise difference of two matrices or two vectors
+ \throw std::domain_error if two matrices do not have the same dimensions
+ */
+template<typename tpLeft, typename tpRight, typename std::enable_if<detail::are_compatible<tpLeft, tpRight>::value>::type* = nullptr>
+binary_expression<detail::simd::op::sub, detail::operand_t<tpLeft>, detail::operand_t<tpRight>> operator-(tpLeft && xx_left, tpRight && xx_right)
+{
+    return {std::forward<tpLeft>(xx_left), std::forward<tpRight>(xx_right)};
+}
+
+/*! * operator: lazy element-wise product of two vectors
+ \note matrix * matrix is the policy matrix multiplication and is evaluated right away
+ */
+template<typename tpLeft, typename tpRight,
+                typename std::enable_if<detail::are_compatible<tpLeft, tpRight>::value && detail::is_kind<tpLeft, vector_kind>::value>::type* = nullptr>
+binary_expression<detail::simd::op::mul, detail::operand_t<tpLeft>, detail::operand_t<tpRight>> operator*(tpLeft && xx_left, tpRight && xx_right)
+{
+    return {std::forward<tpLeft>(xx_left), std::forward<tpRight>(xx_right)};
+}
+
+/*! + operator with a scalar value
+ */
+template<typename tpLeft, typename std::enable_if<detail::traits<tpLeft>::is_expression>::type* = nullptr>
+scalar_expression<detail::simd::op::add, detail::operand_t<tpLeft>> operator+(tpLeft && xx_left, typename detail::traits<tpLeft>::value_type const & xx_scalar)
+{
+    return {std::forward<tpLeft>(xx_left), xx_scalar};
+}
+
+/*! - operator with a scalar value
+ */
+template<typename tpLeft, typename std::enable_if<detail::traits<tpLeft>::is_expression>::type* = nullptr>
+scalar_expression<detail::simd::op::sub, detail::operand_t<tpLeft>> operator-(tpLeft && xx_left, typename detail::traits<tpLeft>::value_type const & xx_scalar)
+{
+    return {std::forward<tpLeft>(xx_left), xx_scalar};
+}
+
+/*! * operator with a scalar value => element-wise multiplication
+ */
+template<typename tpLeft, typename std::enable_if<detail::traits<tpLeft>::is_expression>::type* = nullptr>
+scalar_expression<detail::simd::op::mul, detail::operand_t<tpLeft>> operator*(tpLeft && xx_left, typename detail::traits<tpLeft>::value_type const & xx_scalar)
+{
+    return {std::forward<tpLeft>(xx_left), xx_scalar};
+}
+
+/*! * operator with a std::size_t scalar
+ \note enabled only when non-integral data-type is used (Ex: std::complex)
+ */
+template<typename tpLeft, typename std::enable_if<detail::traits<tpLeft>::is_expression
+                && !std::is_integral<typename detail::traits<tpLeft>::value_type>::value>::type* = nullptr>
+scalar_expression<detail::simd::op::mul, detail::operand_t<tpLeft>> operator*(tpLeft && xx_left, std::size_t const xx_scalar)
+{
+    return {std::forward<tpLeft>(xx_left), static_cast<typename detail::traits<tpLeft>::value_type>(xx_scalar)};
+}
+
+}
+
+#endif /* expression_h */
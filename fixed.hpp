@@ -0,0 +1,517 @@
+/*
+ //  fixed.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the templates for matrices and vectors whose dimensions are known at compile time.
+ The elements live inline (on the stack for locals), every kernel is unrolled over the compile-time dimensions and
+ mismatching dimensions fail to compile. They convert to and from the dynamic assignment::matrix and assignment::vector.
+ */
+#ifndef fixed_h
+#define fixed_h
+
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "matrix.hpp"
+
+namespace assignment {
+
+namespace detail {
+
+/*! calls xx_function(std::integral_constant<std::size_t, I>) for I = 0 ... N-1, unrolled
+ */
+template<typename tpFunction, std::size_t ... tpIdx>
+inline void unroll(tpFunction && xx_function, std::index_sequence<tpIdx...>)
+{
+    (xx_function(std::integral_constant<std::size_t, tpIdx>()), ...);
+}
+
+template<std::size_t tpCount, typename tpFunction>
+inline void unroll(tpFunction && xx_function)
+{
+    unroll(std::forward<tpFunction>(xx_function), std::make_index_sequence<tpCount>());
+}
+
+}
+
+/*! vector with a compile-time dimension and inline storage
+ \tparam tpDataType element type
+ \tparam tpDim number of elements
+ */
+template<typename tpDataType, std::size_t tpDim>
+class fixed_vector {
+public:
+
+    /*! type for the elements of the vector
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the vector
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor; elements are value-initialised (zero for arithmetic types)
+     */
+    fixed_vector() :
+                    m_data()
+    {
+    }
+
+    /*! constructor
+     \param xx_value value to be filled in with
+     */
+    explicit fixed_vector(tpDataType const xx_value)
+    {
+        detail::unroll<tpDim>([&](auto i) {
+            m_data[i] = xx_value;
+        });
+    }
+
+    /*! constructor
+     \param xx_list elements; missing ones are filled with zeros, extra ones are ignored
+     */
+    fixed_vector(std::initializer_list<tpDataType> xx_list) :
+                    m_data()
+    {
+        std::copy_n(xx_list.begin(), std::min(tpDim, xx_list.size()), m_data);
+    }
+
+    /*! constructor from a dynamic vector
+     \throw std::domain_error if the dimension is not tpDim
+     */
+    template<typename tpAllocatorType>
+    explicit fixed_vector(assignment::vector<tpDataType, tpAllocatorType> const & xx_vector)
+    {
+        if (xx_vector.dim() != tpDim)
+            throw std::domain_error("Vector dimension does not match the fixed dimension");
+        std::copy_n(xx_vector.data(), tpDim, m_data);
+    }
+
+    /*! conversion to a dynamic vector
+     */
+    template<typename tpAllocatorType>
+    operator assignment::vector<tpDataType, tpAllocatorType>() const
+    {
+        return assignment::vector<tpDataType, tpAllocatorType>(tpDim, m_data);
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    fixed_vector & operator+=(fixed_vector const & xx_vector)
+    {
+        detail::unroll<tpDim>([&](auto i) {
+            m_data[i] += xx_vector.m_data[i];
+        });
+        return *this;
+    }
+
+    fixed_vector & operator-=(fixed_vector const & xx_vector)
+    {
+        detail::unroll<tpDim>([&](auto i) {
+            m_data[i] -= xx_vector.m_data[i];
+        });
+        return *this;
+    }
+
+    /*! element-wise multiplication
+     */
+    fixed_vector & operator*=(fixed_vector const & xx_vector)
+    {
+        detail::unroll<tpDim>([&](auto i) {
+            m_data[i] *= xx_vector.m_data[i];
+        });
+        return *this;
+    }
+
+    fixed_vector & operator*=(tpDataType const & xx_scalar)
+    {
+        detail::unroll<tpDim>([&](auto i) {
+            m_data[i] *= xx_scalar;
+        });
+        return *this;
+    }
+
+    tpDataType const & operator[](size_type const xx_idx) const
+    {
+        return m_data[xx_idx];
+    }
+
+    tpDataType & operator[](size_type const xx_idx)
+    {
+        return m_data[xx_idx];
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! get dimension of the vector
+     */
+    static constexpr size_type dim()
+    {
+        return tpDim;
+    }
+
+    tpDataType const * data() const
+    {
+        return m_data;
+    }
+
+    tpDataType * data()
+    {
+        return m_data;
+    }
+
+private:
+
+    tpDataType m_data[tpDim];
+};
+
+/*! matrix with compile-time dimensions and inline row-major storage
+ \tparam tpDataType element type
+ \tparam tpDimR number of rows
+ \tparam tpDimC number of columns
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC>
+class fixed_matrix {
+public:
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor; elements are value-initialised (zero for arithmetic types)
+     */
+    fixed_matrix() :
+                    m_data()
+    {
+    }
+
+    /*! constructor
+     \param xx_value Value to be filled in the matrix
+     */
+    explicit fixed_matrix(tpDataType const xx_value)
+    {
+        detail::unroll<tpDimR * tpDimC>([&](auto i) {
+            m_data[i] = xx_value;
+        });
+    }
+
+    /*! constructor
+     \param xx_list row-major elements; missing ones are filled with zeros, extra ones are ignored
+     */
+    fixed_matrix(std::initializer_list<tpDataType> xx_list) :
+                    m_data()
+    {
+        std::copy_n(xx_list.begin(), std::min(tpDimR * tpDimC, xx_list.size()), m_data);
+    }
+
+    /*! constructor from a dynamic matrix
+     \throw std::domain_error if the dimensions are not tpDimR x tpDimC
+     */
+    template<template<typename > class tpPolicyType, typename tpAllocatorType>
+    explicit fixed_matrix(assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix)
+    {
+        if (xx_matrix.dimR() != tpDimR || xx_matrix.dimC() != tpDimC)
+            throw std::domain_error("Matrix dimensions do not match the fixed dimensions");
+        std::copy_n(xx_matrix.data(), tpDimR * tpDimC, m_data);
+    }
+
+    /*! conversion to a dynamic matrix
+     */
+    template<template<typename > class tpPolicyType, typename tpAllocatorType>
+    operator assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>() const
+    {
+        assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType> result(tpDimR, tpDimC);
+        std::copy_n(m_data, tpDimR * tpDimC, result.data());
+        return result;
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    fixed_matrix & operator+=(fixed_matrix const & xx_matrix)
+    {
+        detail::unroll<tpDimR * tpDimC>([&](auto i) {
+            m_data[i] += xx_matrix.m_data[i];
+        });
+        return *this;
+    }
+
+    fixed_matrix & operator-=(fixed_matrix const & xx_matrix)
+    {
+        detail::unroll<tpDimR * tpDimC>([&](auto i) {
+            m_data[i] -= xx_matrix.m_data[i];
+        });
+        return *this;
+    }
+
+    /*! *=operator overload with matrix => Matrix Multiplication (only for square matrices)
+     */
+    template<std::size_t tpDimR2, std::size_t tpDimC2>
+    fixed_matrix & operator*=(fixed_matrix<tpDataType, tpDimR2, tpDimC2> const & xx_matrix)
+    {
+        static_assert(tpDimR == tpDimC && tpDimR2 == tpDimC2 && tpDimR == tpDimR2, "matrix_B should be the same size as matrix_A");
+        return (*this) = (*this) * xx_matrix;
+    }
+
+    fixed_matrix & operator*=(tpDataType const & xx_scalar)
+    {
+        detail::unroll<tpDimR * tpDimC>([&](auto i) {
+            m_data[i] *= xx_scalar;
+        });
+        return *this;
+    }
+
+    /*! ()operator overload for indexing
+     * \note No error checking is done; upto the used to use proper indexing
+     */
+    tpDataType const & operator()(size_type const dimR, size_type const dimC) const
+    {
+        return m_data[dimR * tpDimC + dimC];
+    }
+
+    tpDataType & operator()(size_type const dimR, size_type const dimC)
+    {
+        return m_data[dimR * tpDimC + dimC];
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! Get the row dimension of the matrix
+     */
+    static constexpr size_type dimR()
+    {
+        return tpDimR;
+    }
+
+    /*! Get the coloumn dimension of the matrix
+     */
+    static constexpr size_type dimC()
+    {
+        return tpDimC;
+    }
+
+    tpDataType const * data() const
+    {
+        return m_data;
+    }
+
+    tpDataType * data()
+    {
+        return m_data;
+    }
+
+private:
+
+    tpDataType m_data[tpDimR * tpDimC];
+};
+
+/* ==== f  r  e  e     o  p  e  r  a  t  o  r  s ==== */
+
+namespace detail {
+
+/*! element (R, C) of a * b, summed in the same order as the dynamic kernels
+ */
+template<std::size_t tpR, std::size_t tpC, typename tpDataType, std::size_t tpDimR, std::size_t tpDimK, std::size_t tpDimC, std::size_t ... tpK>
+inline tpDataType fixed_dot(fixed_matrix<tpDataType, tpDimR, tpDimK> const & xx_left, fixed_matrix<tpDataType, tpDimK, tpDimC> const & xx_right,
+                            std::index_sequence<tpK...>)
+{
+    return (static_cast<tpDataType>(0) + ... + (xx_left(tpR, tpK) * xx_right(tpK, tpC)));
+}
+
+}
+
+/*! + operator overload; dimensions are checked at compile time
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC, std::size_t tpDimR2, std::size_t tpDimC2>
+fixed_matrix<tpDataType, tpDimR, tpDimC> operator+(fixed_matrix<tpDataType, tpDimR, tpDimC> const & xx_left,
+                                                   fixed_matrix<tpDataType, tpDimR2, tpDimC2> const & xx_right)
+{
+    static_assert(tpDimR == tpDimR2 && tpDimC == tpDimC2, "Matrices should have same dimension");
+    auto result = xx_left;
+    return result += xx_right;
+}
+
+/*! - operator overload; dimensions are checked at compile time
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC, std::size_t tpDimR2, std::size_t tpDimC2>
+fixed_matrix<tpDataType, tpDimR, tpDimC> operator-(fixed_matrix<tpDataType, tpDimR, tpDimC> const & xx_left,
+                                                   fixed_matrix<tpDataType, tpDimR2, tpDimC2> const & xx_right)
+{
+    static_assert(tpDimR == tpDimR2 && tpDimC == tpDimC2, "Matrices should have same dimension");
+    auto result = xx_left;
+    return result -= xx_right;
+}
+
+/*! * operator overload => fully unrolled matrix multiplication; dimensions are checked at compile time
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimK, std::size_t tpDimK2, std::size_t tpDimC>
+fixed_matrix<tpDataType, tpDimR, tpDimC> operator*(fixed_matrix<tpDataType, tpDimR, tpDimK> const & xx_left,
+                                                   fixed_matrix<tpDataType, tpDimK2, tpDimC> const & xx_right)
+{
+    static_assert(tpDimK == tpDimK2, "Number of columns_A != Number of rows_B");
+    fixed_matrix<tpDataType, tpDimR, tpDimC> result;
+    detail::unroll<tpDimR * tpDimC>([&](auto i) {
+        constexpr std::size_t R = decltype(i)::value / tpDimC;
+        constexpr std::size_t C = decltype(i)::value % tpDimC;
+        result(R, C) = detail::fixed_dot<R, C>(xx_left, xx_right, std::make_index_sequence<tpDimK>());
+    });
+    return result;
+}
+
+/*! * operator overload with a column vector; dimensions are checked at compile time
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC, std::size_t tpDim>
+fixed_vector<tpDataType, tpDimR> operator*(fixed_matrix<tpDataType, tpDimR, tpDimC> const & xx_matrix, fixed_vector<tpDataType, tpDim> const & xx_col_vector)
+{
+    static_assert(tpDimC == tpDim, "coloumn dimension of the matrix not equal to vector dimension");
+    fixed_vector<tpDataType, tpDimR> result;
+    detail::unroll<tpDimR>([&](auto R) {
+        tpDataType sum = static_cast<tpDataType>(0);
+        detail::unroll<tpDimC>([&](auto C) {
+            sum += xx_matrix(R, C) * xx_col_vector[C];
+        });
+        result[R] = sum;
+    });
+    return result;
+}
+
+/*! * operator overload with a scalar value => element-wise multiplication
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC>
+fixed_matrix<tpDataType, tpDimR, tpDimC> operator*(fixed_matrix<tpDataType, tpDimR, tpDimC> const & xx_matrix, tpDataType const & xx_scalar)
+{
+    auto result = xx_matrix;
+    return result *= xx_scalar;
+}
+
+/*! left scalar multiply operator
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC>
+fixed_matrix<tpDataType, tpDimR, tpDimC> operator*(tpDataType const & xx_scalar, fixed_matrix<tpDataType, tpDimR, tpDimC> const & xx_matrix)
+{
+    auto result = xx_matrix;
+    return result *= xx_scalar;
+}
+
+/*! negation operator
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC>
+fixed_matrix<tpDataType, tpDimR, tpDimC> operator-(fixed_matrix<tpDataType, tpDimR, tpDimC> const & xx_matrix)
+{
+    fixed_matrix<tpDataType, tpDimR, tpDimC> result;
+    detail::unroll<tpDimR * tpDimC>([&](auto i) {
+        result.data()[i] = -xx_matrix.data()[i];
+    });
+    return result;
+}
+
+/*! + operator overload; dimensions are checked at compile time
+ */
+template<typename tpDataType, std::size_t tpDim, std::size_t tpDim2>
+fixed_vector<tpDataType, tpDim> operator+(fixed_vector<tpDataType, tpDim> const & xx_left, fixed_vector<tpDataType, tpDim2> const & xx_right)
+{
+    static_assert(tpDim == tpDim2, "Vectors should have same dimension");
+    auto result = xx_left;
+    return result += xx_right;
+}
+
+/*! - operator overload; dimensions are checked at compile time
+ */
+template<typename tpDataType, std::size_t tpDim, std::size_t tpDim2>
+fixed_vector<tpDataType, tpDim> operator-(fixed_vector<tpDataType, tpDim> const & xx_left, fixed_vector<tpDataType, tpDim2> const & xx_right)
+{
+    static_assert(tpDim == tpDim2, "Vectors should have same dimension");
+    auto result = xx_left;
+    return result -= xx_right;
+}
+
+/*! * operator overload => element-wise multiplication; dimensions are checked at compile time
+ */
+template<typename tpDataType, std::size_t tpDim, std::size_t tpDim2>
+fixed_vector<tpDataType, tpDim> operator*(fixed_vector<tpDataType, tpDim> const & xx_left, fixed_vector<tpDataType, tpDim2> const & xx_right)
+{
+    static_assert(tpDim == tpDim2, "Vectors should have same dimension");
+    auto result = xx_left;
+    return result *= xx_right;
+}
+
+/*! * operator overload with a scalar value
+ */
+template<typename tpDataType, std::size_t tpDim>
+fixed_vector<tpDataType, tpDim> operator*(fixed_vector<tpDataType, tpDim> const & xx_vector, tpDataType const & xx_scalar)
+{
+    auto result = xx_vector;
+    return result *= xx_scalar;
+}
+
+/*! left scalar multiply operator
+ */
+template<typename tpDataType, std::size_t tpDim>
+fixed_vector<tpDataType, tpDim> operator*(tpDataType const & xx_scalar, fixed_vector<tpDataType, tpDim> const & xx_vector)
+{
+    auto result = xx_vector;
+    return result *= xx_scalar;
+}
+
+/*! negation operator
+ */
+template<typename tpDataType, std::size_t tpDim>
+fixed_vector<tpDataType, tpDim> operator-(fixed_vector<tpDataType, tpDim> const & xx_vector)
+{
+    fixed_vector<tpDataType, tpDim> result;
+    detail::unroll<tpDim>([&](auto i) {
+        result[i] = -xx_vector[i];
+    });
+    return result;
+}
+
+/*! output matrix to std::cout
+ */
+template<typename tpDataType, std::size_t tpDimR, std::size_t tpDimC>
+std::ostream& operator<<(std::ostream& os, fixed_matrix<tpDataType, tpDimR, tpDimC> const & xx_matrix)
+{
+    os << '[';
+    for (std::size_t R = 0; R < tpDimR; ++R) {
+        if (R > 0)
+            os << ",\n ";
+
+        for (std::size_t C = 0; C < tpDimC; ++C)
+            os << xx_matrix(R, C) << " ";
+    }
+    os << ']';
+    return os;
+}
+
+/*! output vector to std::cout
+ */
+template<typename tpDataType, std::size_t tpDim>
+std::ostream& operator<<(std::ostream& os, fixed_vector<tpDataType, tpDim> const & xx_vector)
+{
+    os << '[';
+    for (std::size_t i = 0; i < tpDim; ++i) {
+        if (i > 0)
+            os << " ,";
+        os << xx_vector[i];
+    }
+    os << ']';
+    return os;
+}
+
+}
+
+#endif /* fixed_h */
@@ -0,0 +1,179 @@
+/*
+ //  gemm.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the cache-blocked, register-tiled kernel behind the matrix multiply policies
+ */
+#ifndef gemm_h
+#define gemm_h
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+namespace assignment {
+namespace detail {
+
+/*! block sizes of the multiply kernel
+ \tparam tpDataType element type
+ \note MR x NR accumulators are held in registers; an MC x KC panel of the left matrix is sized for L2 and a KC x NC panel of the right matrix for L3.
+ */
+template<typename tpDataType>
+struct gemm_blocking {
+    static constexpr std::size_t MR = 4;
+    static constexpr std::size_t NR = sizeof(tpDataType) <= 4 ? 16 : (sizeof(tpDataType) <= 8 ? 8 : 4);
+    static constexpr std::size_t KC = 256;
+    static constexpr std::size_t MC = 24 * MR;
+    static constexpr std::size_t NC = 256 * NR;
+};
+
+/*! packs an xx_panels x xx_kc strip of micro-panels of width W: buffer[k * W + i] = matrix[i * xx_is + k * xx_ks], padding with zeros
+ \note the source is read along whichever of its strides is the unit one, so a transposed operand (Ex: the A in transpose(A) * B)
+ is packed with the same streaming reads as a plain one.
+ */
+template<typename tpDataType, std::size_t W>
+void pack_panel(tpDataType * xx_buffer, tpDataType const * xx_matrix, std::ptrdiff_t const xx_is, std::ptrdiff_t const xx_ks,
+                std::size_t const xx_width, std::size_t const xx_kc)
+{
+    if (std::abs(xx_ks) == 1 && std::abs(xx_is) != 1) {
+        for (std::size_t i = 0; i < xx_width; ++i) {
+            tpDataType const * const source = xx_matrix + static_cast<std::ptrdiff_t>(i) * xx_is;
+            for (std::size_t k = 0; k < xx_kc; ++k) {
+                xx_buffer[k * W + i] = source[static_cast<std::ptrdiff_t>(k) * xx_ks];
+            }
+        }
+        for (std::size_t i = xx_width; i < W; ++i) {
+            for (std::size_t k = 0; k < xx_kc; ++k) {
+                xx_buffer[k * W + i] = static_cast<tpDataType>(0);
+            }
+        }
+    } else {
+        for (std::size_t k = 0; k < xx_kc; ++k) {
+            tpDataType const * const source = xx_matrix + static_cast<std::ptrdiff_t>(k) * xx_ks;
+            for (std::size_t i = 0; i < W; ++i) {
+                xx_buffer[k * W + i] = i < xx_width ? source[static_cast<std::ptrdiff_t>(i) * xx_is] : static_cast<tpDataType>(0);
+            }
+        }
+    }
+}
+
+/*! packs an xx_mc x xx_kc block of a strided matrix into micro-panels of MR rows, padding with zeros
+ */
+template<typename tpDataType, std::size_t MR>
+void pack_left(tpDataType * xx_buffer, tpDataType const * xx_matrix, std::ptrdiff_t const xx_rs, std::ptrdiff_t const xx_cs,
+               std::size_t const xx_mc, std::size_t const xx_kc)
+{
+    for (std::size_t ir = 0; ir < xx_mc; ir += MR) {
+        pack_panel<tpDataType, MR>(xx_buffer, xx_matrix + static_cast<std::ptrdiff_t>(ir) * xx_rs, xx_rs, xx_cs, std::min(MR, xx_mc - ir), xx_kc);
+        xx_buffer += MR * xx_kc;
+    }
+}
+
+/*! packs an xx_kc x xx_nc block of a strided matrix into micro-panels of NR columns, padding with zeros
+ */
+template<typename tpDataType, std::size_t NR>
+void pack_right(tpDataType * xx_buffer, tpDataType const * xx_matrix, std::ptrdiff_t const xx_rs, std::ptrdiff_t const xx_cs,
+                std::size_t const xx_kc, std::size_t const xx_nc)
+{
+    for (std::size_t jr = 0; jr < xx_nc; jr += NR) {
+        pack_panel<tpDataType, NR>(xx_buffer, xx_matrix + static_cast<std::ptrdiff_t>(jr) * xx_cs, xx_cs, xx_rs, std::min(NR, xx_nc - jr), xx_kc);
+        xx_buffer += NR * xx_kc;
+    }
+}
+
+/*! register-blocked micro-kernel: C[mr x nr] (+)= A_panel * B_panel
+ \param xx_first if true the accumulators start at zero, otherwise from the current content of C
+ \note accumulating on top of C keeps the summation order of every element identical to a plain triple loop.
+ */
+template<typename tpDataType, std::size_t MR, std::size_t NR>
+void micro_kernel(std::size_t const xx_kc, tpDataType const * xx_left, tpDataType const * xx_right,
+                  tpDataType * xx_result, std::ptrdiff_t const xx_rs, std::size_t const xx_mr, std::size_t const xx_nr, bool const xx_first)
+{
+    tpDataType acc[MR][NR];
+
+    for (std::size_t i = 0; i < MR; ++i) {
+        for (std::size_t j = 0; j < NR; ++j) {
+            acc[i][j] = (xx_first || i >= xx_mr || j >= xx_nr) ? static_cast<tpDataType>(0) : xx_result[i * xx_rs + j];
+        }
+    }
+
+    for (std::size_t k = 0; k < xx_kc; ++k) {
+        for (std::size_t i = 0; i < MR; ++i) {
+            tpDataType const left = xx_left[i];
+            for (std::size_t j = 0; j < NR; ++j) {
+                acc[i][j] += left * xx_right[j];
+            }
+        }
+        xx_left += MR;
+        xx_right += NR;
+    }
+
+    for (std::size_t i = 0; i < xx_mr; ++i) {
+        for (std::size_t j = 0; j < xx_nr; ++j) {
+            xx_result[i * xx_rs + j] = acc[i][j];
+        }
+    }
+}
+
+/*! C = A * B for strided operands
+ \param xx_M rows of A and C
+ \param xx_N columns of B and C
+ \param xx_K columns of A and rows of B
+ \param xx_left A, element (i, k) at xx_left[i * xx_rsA + k * xx_csA]
+ \param xx_right B, element (k, j) at xx_right[k * xx_rsB + j * xx_csB]
+ \param xx_result C, element (i, j) at xx_result[i * xx_rsC + j]; must not alias A or B
+ \note packs panels of A and B into contiguous buffers so the micro-kernel streams unit-stride data whatever the operand layout.
+ */
+template<typename tpDataType>
+void gemm(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+          tpDataType const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+          tpDataType const * xx_right, std::ptrdiff_t const xx_rsB, std::ptrdiff_t const xx_csB,
+          tpDataType * xx_result, std::ptrdiff_t const xx_rsC)
+{
+    using blocking = gemm_blocking<tpDataType>;
+    constexpr std::size_t MR = blocking::MR;
+    constexpr std::size_t NR = blocking::NR;
+
+    if (xx_K == 0) {
+        for (std::size_t i = 0; i < xx_M; ++i)
+            std::fill(xx_result + i * xx_rsC, xx_result + i * xx_rsC + xx_N, static_cast<tpDataType>(0));
+        return;
+    }
+
+    // panels are reused across calls of the same thread
+    thread_local std::vector<tpDataType> packed_left;
+    thread_local std::vector<tpDataType> packed_right;
+    packed_left.resize(blocking::MC * blocking::KC);
+    packed_right.resize(blocking::KC * blocking::NC);
+
+    for (std::size_t jc = 0; jc < xx_N; jc += blocking::NC) {
+        std::size_t const nc = std::min(blocking::NC, xx_N - jc);
+
+        for (std::size_t pc = 0; pc < xx_K; pc += blocking::KC) {
+            std::size_t const kc = std::min(blocking::KC, xx_K - pc);
+            pack_right<tpDataType, NR>(packed_right.data(), xx_right + pc * xx_rsB + jc * xx_csB, xx_rsB, xx_csB, kc, nc);
+
+            for (std::size_t ic = 0; ic < xx_M; ic += blocking::MC) {
+                std::size_t const mc = std::min(blocking::MC, xx_M - ic);
+                pack_left<tpDataType, MR>(packed_left.data(), xx_left + ic * xx_rsA + pc * xx_csA, xx_rsA, xx_csA, mc, kc);
+
+                for (std::size_t jr = 0; jr < nc; jr += NR) {
+                    for (std::size_t ir = 0; ir < mc; ir += MR) {
+                        micro_kernel<tpDataType, MR, NR>(kc, packed_left.data() + ir * kc, packed_right.data() + jr * kc,
+                                                         xx_result + (ic + ir) * xx_rsC + jc + jr, xx_rsC,
+                                                         std::min(MR, mc - ir), std::min(NR, nc - jr), pc == 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
+}
+
+#endif /* gemm_h */
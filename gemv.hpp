@@ -0,0 +1,127 @@
+/*
+ //  gemv.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the row-blocked kernel behind the matrix-vector multiply of the policies
+ */
+#ifndef gemv_h
+#define gemv_h
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "simd.hpp"
+
+namespace assignment {
+namespace detail {
+
+/*! block sizes of the matrix-vector kernel
+ \note ROWS dot products share each load of the vector; in the column-wise form a slice of COLS_ROWS results stays in L1
+ while the columns are added into it.
+ */
+struct gemv_blocking {
+    static constexpr std::size_t ROWS = 4;
+    static constexpr std::size_t COLS_ROWS = 1024;
+};
+
+/*! y_j = A * x_j for a batch of contiguous vectors, where A has unit column stride
+ \note each block of ROWS rows is multiplied with every vector before moving on. The block stays in cache, so A is streamed
+ from memory once for the whole batch.
+ */
+template<typename tpDataType>
+void gemv_rows(std::size_t const xx_M, std::size_t const xx_N, tpDataType const * xx_left, std::ptrdiff_t const xx_rsA,
+               std::size_t const xx_count, tpDataType const * const * xx_vectors, tpDataType * const * xx_results)
+{
+    constexpr std::size_t ROWS = gemv_blocking::ROWS;
+
+    std::size_t i = 0;
+    for (; i + ROWS <= xx_M; i += ROWS) {
+        tpDataType const * rows[ROWS];
+        for (std::size_t r = 0; r < ROWS; ++r)
+            rows[r] = xx_left + static_cast<std::ptrdiff_t>(i + r) * xx_rsA;
+        for (std::size_t j = 0; j < xx_count; ++j)
+            simd::dot<ROWS>(xx_results[j] + i, rows, xx_vectors[j], xx_N);
+    }
+    for (; i < xx_M; ++i) {
+        tpDataType const * const row = xx_left + static_cast<std::ptrdiff_t>(i) * xx_rsA;
+        for (std::size_t j = 0; j < xx_count; ++j)
+            simd::dot<1>(xx_results[j] + i, &row, xx_vectors[j], xx_N);
+    }
+}
+
+/*! y = A * x for any layout of A and a contiguous x, adding up the columns of A in order
+ */
+template<typename tpDataType>
+void gemv_columns(std::size_t const xx_M, std::size_t const xx_N, tpDataType const * xx_left, std::ptrdiff_t const xx_rsA,
+                  std::ptrdiff_t const xx_csA, tpDataType const * xx_vector, tpDataType * xx_result)
+{
+    for (std::size_t ib = 0; ib < xx_M; ib += gemv_blocking::COLS_ROWS) {
+        std::size_t const mb = std::min(gemv_blocking::COLS_ROWS, xx_M - ib);
+        tpDataType * const result = xx_result + ib;
+        std::fill(result, result + mb, static_cast<tpDataType>(0));
+        for (std::size_t k = 0; k < xx_N; ++k) {
+            tpDataType const x = xx_vector[k];
+            tpDataType const * const col = xx_left + static_cast<std::ptrdiff_t>(ib) * xx_rsA + static_cast<std::ptrdiff_t>(k) * xx_csA;
+            for (std::size_t i = 0; i < mb; ++i)
+                result[i] += col[static_cast<std::ptrdiff_t>(i) * xx_rsA] * x;
+        }
+    }
+}
+
+/*! y = A * x for a strided matrix
+ \param xx_M rows of A and elements of y
+ \param xx_N columns of A and elements of x
+ \param xx_left A, element (i, k) at xx_left[i * xx_rsA + k * xx_csA]
+ \param xx_vector x, element k at xx_vector[k * xx_incx]
+ \param xx_result y, contiguous; must not alias A or x
+ \note rows with unit column stride are multiplied ROWS at a time with the SIMD dot kernels, which sum per lane. Any other
+ layout (Ex: a transposed view) adds up the columns of A in order, reading along the row stride.
+ */
+template<typename tpDataType>
+void gemv(std::size_t const xx_M, std::size_t const xx_N,
+          tpDataType const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+          tpDataType const * xx_vector, std::ptrdiff_t const xx_incx,
+          tpDataType * xx_result)
+{
+    // the kernels read x contiguously; a strided one is gathered per thread
+    if (xx_incx != 1) {
+        thread_local std::vector<tpDataType> packed;
+        packed.resize(xx_N);
+        for (std::size_t k = 0; k < xx_N; ++k)
+            packed[k] = xx_vector[static_cast<std::ptrdiff_t>(k) * xx_incx];
+        xx_vector = packed.data();
+    }
+
+    if (xx_csA == 1)
+        gemv_rows(xx_M, xx_N, xx_left, xx_rsA, 1, &xx_vector, &xx_result);
+    else
+        gemv_columns(xx_M, xx_N, xx_left, xx_rsA, xx_csA, xx_vector, xx_result);
+}
+
+/*! y_j = A * x_j for a batch of contiguous vectors and a strided matrix
+ \param xx_count number of vectors
+ \param xx_vectors the xx_count vectors x_j, each with xx_N elements
+ \param xx_results the xx_count results y_j, each with xx_M elements; must not alias A or any x_j
+ \note every y_j is identical to gemv(A, x_j); only the order in which A is read changes.
+ */
+template<typename tpDataType>
+void gemv_batch(std::size_t const xx_M, std::size_t const xx_N,
+                tpDataType const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                std::size_t const xx_count, tpDataType const * const * xx_vectors, tpDataType * const * xx_results)
+{
+    if (xx_csA == 1) {
+        gemv_rows(xx_M, xx_N, xx_left, xx_rsA, xx_count, xx_vectors, xx_results);
+        return;
+    }
+    for (std::size_t j = 0; j < xx_count; ++j)
+        gemv_columns(xx_M, xx_N, xx_left, xx_rsA, xx_csA, xx_vectors[j], xx_results[j]);
+}
+
+}
+}
+
+#endif /* gemv_h */
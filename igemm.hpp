@@ -0,0 +1,269 @@
+/*
+ //  igemm.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the integer kernel behind the quantized matrix multiply: 8 or 16 bit operands, 32 bit accumulators.
+ Pairs of products are summed by one instruction (pmaddwd, or vpdpwssd where the CPU has AVX-512 VNNI), which is what makes
+ narrow integers faster than int32 or float. Every kernel wraps its sums modulo 2^32 the same way, so all give the same
+ result. The sums are exact only while the sum of |A(i, k) * B(k, j)| over k stays below 2^31: for 8 bit operands that holds
+ for any K < 2^17, but full-range 16 bit operands can reach it from K = 2 (2 * 32768^2 = 2^31).
+ */
+#ifndef igemm_h
+#define igemm_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace assignment {
+namespace detail {
+
+/*! block sizes of the integer kernel
+ \note MR rows x NR columns of int32 accumulators are held in registers (eight AVX-512 registers, enough independent sums
+ to hide the latency of the multiply-add); k advances in pairs, each packed as two adjacent int16.
+ */
+struct igemm_blocking {
+    static constexpr std::size_t MR = 8;
+    static constexpr std::size_t NR = 16;
+};
+
+/*! operand types of the integer kernel
+ */
+template<typename tpDataType>
+struct is_igemm_input : std::integral_constant<bool, std::is_same<tpDataType, std::int8_t>::value || std::is_same<tpDataType, std::int16_t>::value> {
+};
+
+/*! fewest multiply-adds a thread works on in the integer kernel; below this the threading overhead dominates
+ */
+constexpr std::size_t igemm_min_panel = std::size_t(1) << 20;
+
+/*! tile[r][j] = sum over the xx_pairs k pairs of A_r(2p) * B(2p, j) + A_r(2p + 1) * B(2p + 1, j)
+ \param xx_rows the MR rows of A, as int16 pairs
+ \param xx_panel NR columns of B; pair p of column j at xx_panel[(p * NR + j) * 2]
+ \note the sums wrap modulo 2^32 like the SIMD instructions; for 8 bit operands they cannot overflow below 2^16 pairs (K = 2^17),
+ for full-range 16 bit operands a single pair can (2 * 32768^2 = 2^31).
+ */
+inline void igemm_kernel_scalar(std::size_t const xx_pairs, std::int16_t const * const * xx_rows, std::int16_t const * xx_panel,
+                                std::int32_t * xx_tile)
+{
+    constexpr std::size_t MR = igemm_blocking::MR;
+    constexpr std::size_t NR = igemm_blocking::NR;
+    std::uint32_t sum[MR][NR] = {};
+    for (std::size_t p = 0; p < xx_pairs; ++p) {
+        std::int16_t const * const b = xx_panel + p * NR * 2;
+        for (std::size_t r = 0; r < MR; ++r) {
+            std::int32_t const a0 = xx_rows[r][2 * p];
+            std::int32_t const a1 = xx_rows[r][2 * p + 1];
+            for (std::size_t j = 0; j < NR; ++j)
+                sum[r][j] += static_cast<std::uint32_t>(a0 * b[2 * j]) + static_cast<std::uint32_t>(a1 * b[2 * j + 1]);
+        }
+    }
+    for (std::size_t r = 0; r < MR; ++r) {
+        for (std::size_t j = 0; j < NR; ++j)
+            xx_tile[r * NR + j] = static_cast<std::int32_t>(sum[r][j]);
+    }
+}
+
+#if ASSIGNMENT_SIMD_X86
+
+/*! the k pair of row xx_row as one 32 bit word, ready to be broadcast
+ */
+inline std::int32_t igemm_pair(std::int16_t const * xx_row, std::size_t const xx_p)
+{
+    std::int32_t pair;
+    std::memcpy(&pair, xx_row + 2 * xx_p, sizeof(pair));
+    return pair;
+}
+
+/*! \note sixteen AVX2 registers hold four rows of accumulators, so the rows are done four at a time
+ */
+ASSIGNMENT_TARGET("avx2")
+inline void igemm_kernel_avx2(std::size_t const xx_pairs, std::int16_t const * const * xx_rows, std::int16_t const * xx_panel,
+                              std::int32_t * xx_tile)
+{
+    constexpr std::size_t MR = igemm_blocking::MR;
+    constexpr std::size_t NR = igemm_blocking::NR;
+    constexpr std::size_t GROUP = 4;
+    for (std::size_t g = 0; g < MR; g += GROUP) {
+        __m256i sum[GROUP][2];
+        for (std::size_t r = 0; r < GROUP; ++r)
+            sum[r][0] = sum[r][1] = _mm256_setzero_si256();
+        for (std::size_t p = 0; p < xx_pairs; ++p) {
+            __m256i const b0 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(xx_panel + p * NR * 2));
+            __m256i const b1 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(xx_panel + p * NR * 2 + 16));
+            for (std::size_t r = 0; r < GROUP; ++r) {
+                __m256i const a = _mm256_set1_epi32(igemm_pair(xx_rows[g + r], p));
+                sum[r][0] = _mm256_add_epi32(sum[r][0], _mm256_madd_epi16(a, b0));
+                sum[r][1] = _mm256_add_epi32(sum[r][1], _mm256_madd_epi16(a, b1));
+            }
+        }
+        for (std::size_t r = 0; r < GROUP; ++r) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(xx_tile + (g + r) * NR), sum[r][0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(xx_tile + (g + r) * NR + 8), sum[r][1]);
+        }
+    }
+}
+
+ASSIGNMENT_TARGET("avx512f,avx512bw")
+inline void igemm_kernel_avx512(std::size_t const xx_pairs, std::int16_t const * const * xx_rows, std::int16_t const * xx_panel,
+                                std::int32_t * xx_tile)
+{
+    constexpr std::size_t MR = igemm_blocking::MR;
+    constexpr std::size_t NR = igemm_blocking::NR;
+    __m512i sum[MR];
+    for (std::size_t r = 0; r < MR; ++r)
+        sum[r] = _mm512_setzero_si512();
+    for (std::size_t p = 0; p < xx_pairs; ++p) {
+        __m512i const b = _mm512_loadu_si512(xx_panel + p * NR * 2);
+        for (std::size_t r = 0; r < MR; ++r)
+            sum[r] = _mm512_add_epi32(sum[r], _mm512_madd_epi16(_mm512_set1_epi32(igemm_pair(xx_rows[r], p)), b));
+    }
+    for (std::size_t r = 0; r < MR; ++r)
+        _mm512_storeu_si512(xx_tile + r * NR, sum[r]);
+}
+
+/*! as igemm_kernel_avx512, with the multiply and the add fused into one VNNI instruction
+ */
+ASSIGNMENT_TARGET("avx512f,avx512vnni")
+inline void igemm_kernel_vnni(std::size_t const xx_pairs, std::int16_t const * const * xx_rows, std::int16_t const * xx_panel,
+                              std::int32_t * xx_tile)
+{
+    constexpr std::size_t MR = igemm_blocking::MR;
+    constexpr std::size_t NR = igemm_blocking::NR;
+    __m512i sum[MR];
+    for (std::size_t r = 0; r < MR; ++r)
+        sum[r] = _mm512_setzero_si512();
+    for (std::size_t p = 0; p < xx_pairs; ++p) {
+        __m512i const b = _mm512_loadu_si512(xx_panel + p * NR * 2);
+        for (std::size_t r = 0; r < MR; ++r)
+            sum[r] = _mm512_dpwssd_epi32(sum[r], _mm512_set1_epi32(igemm_pair(xx_rows[r], p)), b);
+    }
+    for (std::size_t r = 0; r < MR; ++r)
+        _mm512_storeu_si512(xx_tile + r * NR, sum[r]);
+}
+
+#endif
+
+using igemm_kernel = void (*)(std::size_t, std::int16_t const * const *, std::int16_t const *, std::int32_t *);
+
+/*! fastest integer kernel for the running CPU
+ */
+inline igemm_kernel select_igemm()
+{
+#if ASSIGNMENT_SIMD_X86
+    switch (simd::active()) {
+    case simd::isa::avx512:
+        if (__builtin_cpu_supports("avx512vnni"))
+            return &igemm_kernel_vnni;
+        if (__builtin_cpu_supports("avx512bw"))
+            return &igemm_kernel_avx512;
+        return &igemm_kernel_avx2;
+    case simd::isa::avx2:
+        return &igemm_kernel_avx2;
+    default:
+        break;
+    }
+#endif
+    return &igemm_kernel_scalar;
+}
+
+/*! copies xx_count elements into a row of int16 pairs, padding an odd count with a zero
+ */
+template<typename tpInputType>
+void igemm_widen(std::int16_t * xx_out, tpInputType const * xx_in, std::size_t const xx_count)
+{
+    for (std::size_t k = 0; k < xx_count; ++k)
+        xx_out[k] = static_cast<std::int16_t>(xx_in[k]);
+    if (xx_count % 2 != 0)
+        xx_out[xx_count] = 0;
+}
+
+/*! xx_value * xx_scale converted to tpResultType; integer results are rounded to nearest and saturated
+ */
+template<typename tpResultType>
+tpResultType igemm_requantize(std::int32_t const xx_value, float const xx_scale)
+{
+    float const scaled = static_cast<float>(xx_value) * xx_scale;
+    if constexpr (std::is_integral<tpResultType>::value) {
+        float const rounded = std::nearbyint(scaled);
+        if (!(rounded > static_cast<float>(std::numeric_limits<tpResultType>::min())))
+            return std::numeric_limits<tpResultType>::min();
+        if (!(rounded < static_cast<float>(std::numeric_limits<tpResultType>::max())))
+            return std::numeric_limits<tpResultType>::max();
+        return static_cast<tpResultType>(rounded);
+    } else {
+        return static_cast<tpResultType>(scaled);
+    }
+}
+
+/*! C = A * B for 8 or 16 bit operands with 32 bit accumulators, handing every finished MR x NR tile to xx_store
+ \param xx_M rows of A and C
+ \param xx_N columns of B and C
+ \param xx_K columns of A and rows of B
+ \param xx_left A, row-major with unit column stride, element (i, k) at xx_left[i * xx_K + k]
+ \param xx_right B, row-major, element (k, j) at xx_right[k * xx_N + j]
+ \param xx_store callable (i, j, tile, mr, nr) storing the mr x nr valid part of tile (row stride NR) at C(i, j)
+ \note A is widened to int16 once; each panel of NR columns of B is packed into k pairs by the thread working on it, and the
+ whole depth is summed in registers, so xx_store sees final values (Ex: to rescale them on the way out). With tpParallel the
+ panels are spread over the thread pool.
+ */
+template<bool tpParallel, typename tpInputType, typename tpStore>
+void igemm(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+           tpInputType const * xx_left, tpInputType const * xx_right, tpStore const & xx_store)
+{
+    static_assert(is_igemm_input<tpInputType>::value, "the integer kernel takes int8_t or int16_t operands");
+    constexpr std::size_t MR = igemm_blocking::MR;
+    constexpr std::size_t NR = igemm_blocking::NR;
+    static igemm_kernel const kernel = select_igemm();
+
+    std::size_t const pairs = (xx_K + 1) / 2;
+    std::vector<std::int16_t> left(std::max<std::size_t>(xx_M, 1) * 2 * pairs);
+    for (std::size_t i = 0; i < xx_M; ++i)
+        igemm_widen(left.data() + i * 2 * pairs, xx_left + i * xx_K, xx_K);
+
+    auto const panel = [&](std::size_t const xx_panel) {
+        std::size_t const j0 = xx_panel * NR;
+        std::size_t const nr = std::min(NR, xx_N - j0);
+
+        thread_local std::vector<std::int16_t> packed;
+        packed.assign(pairs * NR * 2, 0);
+        for (std::size_t k = 0; k < xx_K; ++k) {
+            for (std::size_t j = 0; j < nr; ++j)
+                packed[((k / 2) * NR + j) * 2 + k % 2] = static_cast<std::int16_t>(xx_right[k * xx_N + j0 + j]);
+        }
+
+        std::int32_t tile[MR * NR];
+        for (std::size_t i = 0; i < xx_M; i += MR) {
+            std::size_t const mr = std::min(MR, xx_M - i);
+            std::int16_t const * rows[MR];
+            for (std::size_t r = 0; r < MR; ++r)
+                rows[r] = left.data() + (i + std::min(r, mr - 1)) * 2 * pairs;
+            kernel(pairs, rows, packed.data(), tile);
+            xx_store(i, j0, tile, mr, nr);
+        }
+    };
+
+    std::size_t const panels = (xx_N + NR - 1) / NR;
+    if (tpParallel && xx_M * xx_N * xx_K >= 2 * igemm_min_panel) {
+        parallel_for(panels, panel);
+    } else {
+        for (std::size_t p = 0; p < panels; ++p)
+            panel(p);
+    }
+}
+
+}
+}
+
+#endif /* igemm_h */
@@ -0,0 +1,598 @@
+/*
+ //  iterative.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the matrix-free Krylov solvers for A * x = b: conjugate gradients for symmetric positive definite
+ A, BiCGSTAB and restarted GMRES for general A. The solvers only apply A and the preconditioner to vectors through
+ apply_operator(op, x, y), y = op(x), which the dense matrix, the sparse matrices and any callable op(x, y) provide; a
+ user type takes part by an overload of apply_operator. A solver object allocates its workspace vectors once for a
+ dimension, so its iterations, and further solves of the same dimension, do not allocate.
+ */
+#ifndef iterative_h
+#define iterative_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "matrix.hpp"
+#include "sparse.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+
+/* ==== l  i  n  e  a  r     o  p  e  r  a  t  o  r  s ==== */
+
+/*! xx_y = xx_operator(xx_x) for a callable xx_operator(x, y) writing its result into y
+ */
+template<typename tpOperator, typename tpDataType, typename tpAllocatorType>
+void apply_operator(tpOperator const & xx_operator, vector<tpDataType, tpAllocatorType> const & xx_x, vector<tpDataType, tpAllocatorType> & xx_y)
+{
+    xx_operator(xx_x, xx_y);
+}
+
+/*! xx_y = xx_matrix * xx_x through the multiply policy of the matrix, into the storage of xx_y
+ \throw std::domain_error if the dimensions differ
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpMatrixAllocator, typename tpAllocatorType>
+void apply_operator(matrix<tpDataType, tpPolicyType, tpMatrixAllocator> const & xx_matrix, vector<tpDataType, tpAllocatorType> const & xx_x,
+                    vector<tpDataType, tpAllocatorType> & xx_y)
+{
+    if (xx_matrix.dimC() != xx_x.dim() || xx_matrix.dimR() != xx_y.dim())
+        throw std::domain_error("Number of columns_A != dimension of vector");
+    using policy = typename matrix<tpDataType, tpPolicyType, tpMatrixAllocator>::policy_type;
+    policy::vector_multiply(xx_matrix.dimR(), xx_matrix.dimC(), xx_matrix.data(), static_cast<std::ptrdiff_t>(xx_matrix.dimC()), 1,
+                            xx_x.data(), 1, xx_y.data());
+}
+
+/*! xx_y = xx_matrix * xx_x, see the SpMV operator*, into the storage of xx_y
+ \throw std::domain_error if the dimensions differ
+ */
+template<typename tpDataType, sparse_format tpFormat, template<typename > class tpPolicyType, typename tpAllocatorType>
+void apply_operator(sparse_matrix<tpDataType, tpFormat, tpPolicyType> const & xx_matrix, vector<tpDataType, tpAllocatorType> const & xx_x,
+                    vector<tpDataType, tpAllocatorType> & xx_y)
+{
+    if (xx_matrix.dimC() != xx_x.dim() || xx_matrix.dimR() != xx_y.dim())
+        throw std::domain_error("Number of columns_A != dimension of vector");
+    detail::sparse_vector_multiply(xx_matrix, xx_x.data(), xx_y.data());
+}
+
+/*! preconditioner M = I; the default of the solvers
+ */
+struct identity_preconditioner {
+};
+
+/*! xx_y = xx_x
+ */
+template<typename tpDataType, typename tpAllocatorType>
+void apply_operator(identity_preconditioner const &, vector<tpDataType, tpAllocatorType> const & xx_x, vector<tpDataType, tpAllocatorType> & xx_y)
+{
+    std::copy(xx_x.data(), xx_x.data() + xx_x.dim(), xx_y.data());
+}
+
+/*! Jacobi preconditioner M = diag(A): divides every element by its diagonal element of A
+ */
+template<typename tpDataType, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class jacobi_preconditioner {
+public:
+
+    /*! from the diagonal of A
+     \throw std::domain_error if an element of the diagonal is zero
+     */
+    explicit jacobi_preconditioner(vector<tpDataType, tpAllocatorType> const & xx_diagonal) :
+                    m_inverse(xx_diagonal.dim())
+    {
+        for (std::size_t i = 0; i < xx_diagonal.dim(); ++i) {
+            if (xx_diagonal[i] == tpDataType(0))
+                throw std::domain_error("Diagonal should not have a zero");
+            m_inverse[i] = tpDataType(1) / xx_diagonal[i];
+        }
+    }
+
+    /*! from the diagonal of a square dense matrix
+     \throw std::domain_error if an element of the diagonal is zero
+     */
+    template<template<typename > class tpPolicyType, typename tpMatrixAllocator>
+    explicit jacobi_preconditioner(matrix<tpDataType, tpPolicyType, tpMatrixAllocator> const & xx_matrix) :
+                    jacobi_preconditioner(diagonal(xx_matrix))
+    {
+    }
+
+    /*! from the diagonal of a square sparse matrix
+     \throw std::domain_error if an element of the diagonal is zero
+     */
+    template<sparse_format tpFormat, template<typename > class tpPolicyType>
+    explicit jacobi_preconditioner(sparse_matrix<tpDataType, tpFormat, tpPolicyType> const & xx_matrix) :
+                    jacobi_preconditioner(diagonal(xx_matrix))
+    {
+    }
+
+    /*! the reciprocals of the diagonal
+     */
+    vector<tpDataType, tpAllocatorType> const & inverse() const
+    {
+        return m_inverse;
+    }
+
+private:
+
+    template<typename tpMatrixType>
+    static vector<tpDataType, tpAllocatorType> diagonal(tpMatrixType const & xx_matrix)
+    {
+        vector<tpDataType, tpAllocatorType> result(std::min(xx_matrix.dimR(), xx_matrix.dimC()));
+        for (std::size_t i = 0; i < result.dim(); ++i)
+            result[i] = xx_matrix(i, i);
+        return result;
+    }
+
+    vector<tpDataType, tpAllocatorType> m_inverse;
+};
+
+/*! xx_y = M^-1 * xx_x
+ */
+template<typename tpDataType, typename tpAllocatorType>
+void apply_operator(jacobi_preconditioner<tpDataType, tpAllocatorType> const & xx_preconditioner, vector<tpDataType, tpAllocatorType> const & xx_x,
+                    vector<tpDataType, tpAllocatorType> & xx_y)
+{
+    xx_y = xx_x * xx_preconditioner.inverse();
+}
+
+/* ==== s  o  l  v  e  r  s ==== */
+
+/*! stopping criteria of the iterative solvers
+ */
+struct iterative_options {
+
+    /*! converged once ||b - A * x|| <= tolerance * ||b||
+     */
+    double tolerance = 1e-8;
+
+    /*! most iterations (matrix-vector products for GMRES) before giving up
+     */
+    std::size_t max_iterations = 1000;
+
+    /*! GMRES: Krylov vectors kept before a restart
+     */
+    std::size_t restart = 30;
+};
+
+/*! outcome of a solve
+ */
+struct iterative_result {
+
+    /*! iterations done
+     */
+    std::size_t iterations = 0;
+
+    /*! ||b - A * x|| / ||b|| at the end, recomputed from x rather than taken from the recurrences; the preconditioned
+     residual is never used for this
+     */
+    double residual = 0;
+
+    /*! whether the residual reached the tolerance
+     */
+    bool converged = false;
+};
+
+namespace detail {
+
+/*! checks the dimensions of a solve against the dimension of the workspace
+ */
+template<typename tpVectorType>
+void check_iterative(std::size_t const xx_dim, tpVectorType const & xx_rhs, tpVectorType const & xx_x)
+{
+    if (xx_rhs.dim() != xx_dim || xx_x.dim() != xx_dim)
+        throw std::domain_error("Vectors should have the dimension of the solver");
+}
+
+/*! xx_r = xx_rhs - A * xx_x, and ||xx_rhs|| as the scale of the residuals, 1 if xx_rhs is zero
+ */
+template<typename tpOperator, typename tpVectorType>
+typename tpVectorType::value_type initial_residual(tpOperator const & xx_operator, tpVectorType const & xx_rhs, tpVectorType const & xx_x,
+                                                   tpVectorType & xx_r)
+{
+    using value_type = typename tpVectorType::value_type;
+    apply_operator(xx_operator, xx_x, xx_r);
+    xx_r = xx_rhs - xx_r;
+    value_type const scale = norm(xx_rhs);
+    return scale > value_type(0) ? scale : value_type(1);
+}
+
+/*! ||xx_rhs - A * xx_x|| / xx_scale, computed in xx_work; the solvers report this instead of their recurrence residual,
+ which drifts from it by rounding
+ */
+template<typename tpOperator, typename tpVectorType>
+typename tpVectorType::value_type true_residual(tpOperator const & xx_operator, tpVectorType const & xx_rhs, tpVectorType const & xx_x,
+                                                typename tpVectorType::value_type const xx_scale, tpVectorType & xx_work)
+{
+    apply_operator(xx_operator, xx_x, xx_work);
+    xx_work = xx_rhs - xx_work;
+    return norm(xx_work) / xx_scale;
+}
+
+}
+
+/*! preconditioned conjugate gradients for a symmetric positive definite A
+ \tparam tpDataType element type; floating point
+ \note the preconditioner must be symmetric positive definite as well.
+ */
+template<typename tpDataType, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class cg_solver {
+public:
+
+    static_assert(std::is_floating_point<tpDataType>::value, "Iterative solvers need a floating point element type");
+
+    /*! type of the solved vectors
+     */
+    using vector_type = vector<tpDataType, tpAllocatorType>;
+
+    /*! type for the size of the vectors
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! allocates the workspace for systems of dimension xx_dim
+     */
+    explicit cg_solver(size_type const xx_dim, iterative_options const & xx_options = iterative_options()) :
+                    m_options(xx_options),
+                    m_r(xx_dim),
+                    m_z(xx_dim),
+                    m_p(xx_dim),
+                    m_q(xx_dim)
+    {
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! the stopping criteria of the next solves
+     */
+    iterative_options & options()
+    {
+        return m_options;
+    }
+
+    /*! improves xx_x, the initial guess, in place until A * xx_x = xx_rhs within the tolerance
+     \throw std::domain_error if the dimensions differ from the dimension of the solver
+     */
+    template<typename tpOperator, typename tpPreconditioner = identity_preconditioner>
+    iterative_result solve(tpOperator const & xx_operator, vector_type const & xx_rhs, vector_type & xx_x,
+                           tpPreconditioner const & xx_preconditioner = tpPreconditioner())
+    {
+        detail::check_iterative(m_r.dim(), xx_rhs, xx_x);
+        iterative_result result;
+        tpDataType const scale = detail::initial_residual(xx_operator, xx_rhs, xx_x, m_r);
+        result.residual = norm(m_r) / scale;
+        if (result.residual <= m_options.tolerance) {
+            result.converged = true;
+            return result;
+        }
+
+        apply_operator(xx_preconditioner, m_r, m_z);
+        m_p = m_z;
+        tpDataType rz = dot(m_r, m_z);
+        while (result.iterations < m_options.max_iterations) {
+            ++result.iterations;
+            apply_operator(xx_operator, m_p, m_q);
+            tpDataType const curvature = dot(m_p, m_q);
+            if (curvature == tpDataType(0))
+                break;
+            tpDataType const alpha = rz / curvature;
+            axpy(alpha, m_p, xx_x);
+            axpy(-alpha, m_q, m_r);
+            if (norm(m_r) / scale <= m_options.tolerance)
+                break;
+
+            apply_operator(xx_preconditioner, m_r, m_z);
+            tpDataType const rz_next = dot(m_r, m_z);
+            m_p = m_z + m_p * (rz_next / rz);
+            rz = rz_next;
+        }
+        result.residual = detail::true_residual(xx_operator, xx_rhs, xx_x, scale, m_q);
+        result.converged = result.residual <= m_options.tolerance;
+        return result;
+    }
+
+private:
+
+    iterative_options m_options;
+    vector_type m_r, m_z, m_p, m_q;
+};
+
+/*! BiCGSTAB for a general nonsingular A, right preconditioned
+ \tparam tpDataType element type; floating point
+ \note two products with A per iteration; the recurrences run on the unpreconditioned residual, and the reported
+ residual is recomputed as b - A * x when the solve stops.
+ */
+template<typename tpDataType, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class bicgstab_solver {
+public:
+
+    static_assert(std::is_floating_point<tpDataType>::value, "Iterative solvers need a floating point element type");
+
+    /*! type of the solved vectors
+     */
+    using vector_type = vector<tpDataType, tpAllocatorType>;
+
+    /*! type for the size of the vectors
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! allocates the workspace for systems of dimension xx_dim
+     */
+    explicit bicgstab_solver(size_type const xx_dim, iterative_options const & xx_options = iterative_options()) :
+                    m_options(xx_options),
+                    m_r(xx_dim),
+                    m_shadow(xx_dim),
+                    m_p(xx_dim),
+                    m_v(xx_dim),
+                    m_s(xx_dim),
+                    m_t(xx_dim),
+                    m_y(xx_dim),
+                    m_z(xx_dim)
+    {
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! the stopping criteria of the next solves
+     */
+    iterative_options & options()
+    {
+        return m_options;
+    }
+
+    /*! improves xx_x, the initial guess, in place until A * xx_x = xx_rhs within the tolerance
+     \note stops without convergence on a breakdown, when a denominator of the recurrences becomes zero.
+     \throw std::domain_error if the dimensions differ from the dimension of the solver
+     */
+    template<typename tpOperator, typename tpPreconditioner = identity_preconditioner>
+    iterative_result solve(tpOperator const & xx_operator, vector_type const & xx_rhs, vector_type & xx_x,
+                           tpPreconditioner const & xx_preconditioner = tpPreconditioner())
+    {
+        detail::check_iterative(m_r.dim(), xx_rhs, xx_x);
+        iterative_result result;
+        tpDataType const scale = detail::initial_residual(xx_operator, xx_rhs, xx_x, m_r);
+        result.residual = norm(m_r) / scale;
+        if (result.residual <= m_options.tolerance) {
+            result.converged = true;
+            return result;
+        }
+
+        m_shadow = m_r;
+        m_p.set(tpDataType(0));
+        m_v.set(tpDataType(0));
+        tpDataType rho = tpDataType(1), alpha = tpDataType(1), omega = tpDataType(1);
+        while (result.iterations < m_options.max_iterations) {
+            ++result.iterations;
+            tpDataType const rho_next = dot(m_shadow, m_r);
+            if (rho_next == tpDataType(0))
+                break;
+            m_p = m_r + (m_p - m_v * omega) * ((rho_next / rho) * (alpha / omega));
+            rho = rho_next;
+
+            apply_operator(xx_preconditioner, m_p, m_y);
+            apply_operator(xx_operator, m_y, m_v);
+            tpDataType const projection = dot(m_shadow, m_v);
+            if (projection == tpDataType(0))
+                break;
+            alpha = rho / projection;
+            m_s = m_r - m_v * alpha;
+            if (norm(m_s) / scale <= m_options.tolerance) {
+                axpy(alpha, m_y, xx_x);
+                break;
+            }
+
+            apply_operator(xx_preconditioner, m_s, m_z);
+            apply_operator(xx_operator, m_z, m_t);
+            tpDataType const tt = dot(m_t, m_t);
+            omega = tt == tpDataType(0) ? tpDataType(0) : dot(m_t, m_s) / tt;
+            axpy(alpha, m_y, xx_x);
+            axpy(omega, m_z, xx_x);
+            m_r = m_s - m_t * omega;
+            if (norm(m_r) / scale <= m_options.tolerance || omega == tpDataType(0))
+                break;
+        }
+        result.residual = detail::true_residual(xx_operator, xx_rhs, xx_x, scale, m_t);
+        result.converged = result.residual <= m_options.tolerance;
+        return result;
+    }
+
+private:
+
+    iterative_options m_options;
+    vector_type m_r, m_shadow, m_p, m_v, m_s, m_t, m_y, m_z;
+};
+
+/*! restarted GMRES(m) for a general nonsingular A, right preconditioned
+ \tparam tpDataType element type; floating point
+ \note the Krylov basis is orthogonalized with modified Gram-Schmidt, and the least-squares problem of the Hessenberg
+ matrix is updated with Givens rotations, so the residual is known in every step without forming x. The workspace holds
+ options().restart + 1 basis vectors; the restart length is fixed when the solver is constructed.
+ */
+template<typename tpDataType, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class gmres_solver {
+public:
+
+    static_assert(std::is_floating_point<tpDataType>::value, "Iterative solvers need a floating point element type");
+
+    /*! type of the solved vectors
+     */
+    using vector_type = vector<tpDataType, tpAllocatorType>;
+
+    /*! type for the size of the vectors
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! allocates the workspace for systems of dimension xx_dim
+     \throw std::domain_error if the restart length is zero
+     */
+    explicit gmres_solver(size_type const xx_dim, iterative_options const & xx_options = iterative_options()) :
+                    m_options(xx_options),
+                    m_restart(xx_options.restart),
+                    m_basis(),
+                    m_w(xx_dim),
+                    m_z(xx_dim),
+                    m_hessenberg((xx_options.restart + 1) * xx_options.restart),
+                    m_cos(xx_options.restart),
+                    m_sin(xx_options.restart),
+                    m_g(xx_options.restart + 1)
+    {
+        if (m_restart == 0)
+            throw std::domain_error("Restart length should be positive");
+        m_basis.reserve(m_restart + 1);
+        for (size_type i = 0; i <= m_restart; ++i)
+            m_basis.emplace_back(xx_dim);
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! the tolerance and the iteration limit may be changed; the restart length stays the one of the constructor
+     */
+    iterative_options & options()
+    {
+        return m_options;
+    }
+
+    /*! improves xx_x, the initial guess, in place until A * xx_x = xx_rhs within the tolerance
+     \note result.iterations counts the products with A, over all restarts.
+     \throw std::domain_error if the dimensions differ from the dimension of the solver
+     */
+    template<typename tpOperator, typename tpPreconditioner = identity_preconditioner>
+    iterative_result solve(tpOperator const & xx_operator, vector_type const & xx_rhs, vector_type & xx_x,
+                           tpPreconditioner const & xx_preconditioner = tpPreconditioner())
+    {
+        detail::check_iterative(m_w.dim(), xx_rhs, xx_x);
+        iterative_result result;
+        vector_type & r = m_basis[0];
+        tpDataType const scale = detail::initial_residual(xx_operator, xx_rhs, xx_x, r);
+        tpDataType beta = norm(r);
+        result.residual = beta / scale;
+
+        while (result.residual > m_options.tolerance && result.iterations < m_options.max_iterations) {
+            m_basis[0] = r * (tpDataType(1) / beta);
+            std::fill(m_g.begin(), m_g.end(), tpDataType(0));
+            m_g[0] = beta;
+
+            size_type k = 0;
+            while (k < m_restart && result.iterations < m_options.max_iterations) {
+                ++result.iterations;
+                apply_operator(xx_preconditioner, m_basis[k], m_z);
+                apply_operator(xx_operator, m_z, m_w);
+                for (size_type i = 0; i <= k; ++i) {
+                    tpDataType const h = dot(m_w, m_basis[i]);
+                    H(i, k) = h;
+                    axpy(-h, m_basis[i], m_w);
+                }
+                tpDataType const next = norm(m_w);
+                H(k + 1, k) = next;
+
+                for (size_type i = 0; i < k; ++i)
+                    rotate(m_cos[i], m_sin[i], H(i, k), H(i + 1, k));
+                tpDataType const radius = std::hypot(H(k, k), H(k + 1, k));
+                m_cos[k] = radius == tpDataType(0) ? tpDataType(1) : H(k, k) / radius;
+                m_sin[k] = radius == tpDataType(0) ? tpDataType(0) : H(k + 1, k) / radius;
+                rotate(m_cos[k], m_sin[k], H(k, k), H(k + 1, k));
+                rotate(m_cos[k], m_sin[k], m_g[k], m_g[k + 1]);
+                ++k;
+
+                result.residual = std::abs(m_g[k]) / scale;
+                if (result.residual <= m_options.tolerance || next == tpDataType(0))
+                    break;
+                m_basis[k] = m_w * (tpDataType(1) / next);
+            }
+
+            // y = H^-1 * g on the k x k triangle, x += M^-1 * (V * y)
+            for (size_type i = k; i-- > 0; ) {
+                tpDataType sum = m_g[i];
+                for (size_type j = i + 1; j < k; ++j)
+                    sum -= H(i, j) * m_g[j];
+                m_g[i] = H(i, i) == tpDataType(0) ? tpDataType(0) : sum / H(i, i);
+            }
+            m_w.set(tpDataType(0));
+            for (size_type i = 0; i < k; ++i)
+                axpy(m_g[i], m_basis[i], m_w);
+            apply_operator(xx_preconditioner, m_w, m_z);
+            axpy(tpDataType(1), m_z, xx_x);
+
+            // the true residual, which also starts the next cycle
+            apply_operator(xx_operator, xx_x, r);
+            r = xx_rhs - r;
+            beta = norm(r);
+            result.residual = beta / scale;
+            if (beta == tpDataType(0))
+                break;
+        }
+        result.converged = result.residual <= m_options.tolerance;
+        return result;
+    }
+
+private:
+
+    /*! element (i, j) of the (restart + 1) x restart Hessenberg matrix, row-major
+     */
+    tpDataType & H(size_type const xx_i, size_type const xx_j)
+    {
+        return m_hessenberg[xx_i * m_restart + xx_j];
+    }
+
+    /*! applies the Givens rotation (xx_cos, xx_sin) to the pair (xx_a, xx_b)
+     */
+    static void rotate(tpDataType const xx_cos, tpDataType const xx_sin, tpDataType & xx_a, tpDataType & xx_b)
+    {
+        tpDataType const a = xx_cos * xx_a + xx_sin * xx_b;
+        xx_b = -xx_sin * xx_a + xx_cos * xx_b;
+        xx_a = a;
+    }
+
+    iterative_options m_options;
+    size_type m_restart;
+    std::vector<vector_type> m_basis;
+    vector_type m_w, m_z;
+    std::vector<tpDataType> m_hessenberg, m_cos, m_sin, m_g;
+};
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! solves A * xx_x = xx_rhs with conjugate gradients, starting from xx_x
+ \note allocates the workspace for this solve; keep a cg_solver to solve repeatedly without allocation.
+ */
+template<typename tpOperator, typename tpDataType, typename tpAllocatorType, typename tpPreconditioner = identity_preconditioner>
+iterative_result cg(tpOperator const & xx_operator, vector<tpDataType, tpAllocatorType> const & xx_rhs, vector<tpDataType, tpAllocatorType> & xx_x,
+                    iterative_options const & xx_options = iterative_options(), tpPreconditioner const & xx_preconditioner = tpPreconditioner())
+{
+    return cg_solver<tpDataType, tpAllocatorType>(xx_rhs.dim(), xx_options).solve(xx_operator, xx_rhs, xx_x, xx_preconditioner);
+}
+
+/*! solves A * xx_x = xx_rhs with BiCGSTAB, starting from xx_x
+ \note allocates the workspace for this solve; keep a bicgstab_solver to solve repeatedly without allocation.
+ */
+template<typename tpOperator, typename tpDataType, typename tpAllocatorType, typename tpPreconditioner = identity_preconditioner>
+iterative_result bicgstab(tpOperator const & xx_operator, vector<tpDataType, tpAllocatorType> const & xx_rhs, vector<tpDataType, tpAllocatorType> & xx_x,
+                          iterative_options const & xx_options = iterative_options(), tpPreconditioner const & xx_preconditioner = tpPreconditioner())
+{
+    return bicgstab_solver<tpDataType, tpAllocatorType>(xx_rhs.dim(), xx_options).solve(xx_operator, xx_rhs, xx_x, xx_preconditioner);
+}
+
+/*! solves A * xx_x = xx_rhs with restarted GMRES, starting from xx_x
+ \note allocates the workspace for this solve; keep a gmres_solver to solve repeatedly without allocation.
+ */
+template<typename tpOperator, typename tpDataType, typename tpAllocatorType, typename tpPreconditioner = identity_preconditioner>
+iterative_result gmres(tpOperator const & xx_operator, vector<tpDataType, tpAllocatorType> const & xx_rhs, vector<tpDataType, tpAllocatorType> & xx_x,
+                       iterative_options const & xx_options = iterative_options(), tpPreconditioner const & xx_preconditioner = tpPreconditioner())
+{
+    return gmres_solver<tpDataType, tpAllocatorType>(xx_rhs.dim(), xx_options).solve(xx_operator, xx_rhs, xx_x, xx_preconditioner);
+}
+
+}
+#endif /* iterative_h */
@@ -0,0 +1,280 @@
+/*
+ //  lu.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the LU factorization with partial pivoting, P * A = L * U, of a square assignment::matrix and the
+ solves, determinant and inverse built on it. The factorization is blocked and right-looking: a narrow panel of columns
+ is factored row by row, and the trailing matrix is updated by one matrix product of the multiply policy per panel,
+ which does almost all of the work, so Parallel speeds up the factorization as it does a product.
+ */
+#ifndef lu_h
+#define lu_h
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "triangular.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+/*! LU factorization with partial pivoting, P * A = L * U, of a square matrix
+ \tparam tpDataType element type; floating point or complex
+ \tparam tpPolicyType multiply policy of the trailing updates and of the solves with several right-hand sides
+ \note factor once, then solve() any number of right-hand sides against the stored factors.
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class lu_factorization {
+public:
+
+    static_assert(!std::is_integral<tpDataType>::value, "LU factorization needs a floating point or complex element type");
+
+    /*! type of the factored and solved matrices
+     */
+    using matrix_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! factors xx_matrix; pass an rvalue to factor in its storage without a copy
+     \note a zero pivot does not stop the factorization; singular() reports it and the solves refuse to run.
+     \throw std::domain_error if the matrix is not square
+     */
+    explicit lu_factorization(matrix_type xx_matrix) :
+                    m_factors(std::move(xx_matrix)),
+                    m_pivots(m_factors.dimR()),
+                    m_swaps(0),
+                    m_singular(false)
+    {
+        if (m_factors.dimR() != m_factors.dimC())
+            throw std::domain_error("Matrix should be square");
+        factor();
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! get dimension of the factored matrix
+     */
+    size_type dim() const
+    {
+        return m_factors.dimR();
+    }
+
+    /*! L below the diagonal, its unit diagonal implied, and U on and above it
+     */
+    matrix_type const & factors() const
+    {
+        return m_factors;
+    }
+
+    /*! row i was swapped with row pivots()[i] >= i at step i of the factorization
+     */
+    std::vector<size_type> const & pivots() const
+    {
+        return m_pivots;
+    }
+
+    /*! true if U has a zero on its diagonal
+     */
+    bool singular() const
+    {
+        return m_singular;
+    }
+
+    /*! determinant of the factored matrix: the product of the diagonal of U, negated for an odd number of row swaps
+     */
+    tpDataType determinant() const
+    {
+        tpDataType result = m_swaps % 2 == 0 ? tpDataType(1) : tpDataType(-1);
+        for (size_type i = 0; i < dim(); ++i)
+            result *= m_factors(i, i);
+        return result;
+    }
+
+    /*! solves A * x = xx_rhs
+     \throw std::domain_error if the dimension of xx_rhs differs or the matrix is singular
+     */
+    template<typename tpVectorAllocator>
+    vector<tpDataType, tpVectorAllocator> solve(vector<tpDataType, tpVectorAllocator> const & xx_rhs) const
+    {
+        if (xx_rhs.dim() != dim())
+            throw std::domain_error("Vector should have the dimension of the matrix");
+        check_regular();
+
+        using policy = typename matrix_type::policy_type;
+        vector<tpDataType, tpVectorAllocator> result(xx_rhs);
+        tpDataType * const x = result.data();
+        std::ptrdiff_t const rs = static_cast<std::ptrdiff_t>(dim());
+        std::vector<tpDataType> temp;
+        for (size_type i = 0; i < dim(); ++i)
+            std::swap(x[i], x[m_pivots[i]]);
+        detail::solve_vector<policy>(dim(), m_factors.data(), rs, 1, triangle::lower, true, x, temp);
+        detail::solve_vector<policy>(dim(), m_factors.data(), rs, 1, triangle::upper, false, x, temp);
+        return result;
+    }
+
+    /*! solves A * X = xx_rhs for all columns of xx_rhs at once
+     \note blocked like the factorization: most of the work is products of the multiply policy.
+     \throw std::domain_error if the row dimension of xx_rhs differs or the matrix is singular
+     */
+    matrix_type solve(matrix_type xx_rhs) const
+    {
+        if (xx_rhs.dimR() != dim())
+            throw std::domain_error("Matrix should have the row dimension of the factored matrix");
+        check_regular();
+
+        using policy = typename matrix_type::policy_type;
+        size_type const m = xx_rhs.dimC();
+        std::ptrdiff_t const rs = static_cast<std::ptrdiff_t>(dim());
+        tpDataType * const rhs = xx_rhs.data();
+        std::vector<tpDataType> temp;
+        for (size_type i = 0; i < dim(); ++i) {
+            if (m_pivots[i] != i)
+                std::swap_ranges(rhs + i * m, rhs + (i + 1) * m, rhs + m_pivots[i] * m);
+        }
+        detail::solve_blocked<policy>(dim(), m, m_factors.data(), rs, 1, triangle::lower, true, rhs, static_cast<std::ptrdiff_t>(m), temp);
+        detail::solve_blocked<policy>(dim(), m, m_factors.data(), rs, 1, triangle::upper, false, rhs, static_cast<std::ptrdiff_t>(m), temp);
+        return xx_rhs;
+    }
+
+    /*! inverse of the factored matrix, solved for the identity
+     \throw std::domain_error if the matrix is singular
+     */
+    matrix_type inverse() const
+    {
+        matrix_type identity(dim(), dim(), tpDataType(0));
+        for (size_type i = 0; i < dim(); ++i)
+            identity(i, i) = tpDataType(1);
+        return solve(std::move(identity));
+    }
+
+private:
+
+    void check_regular() const
+    {
+        if (m_singular)
+            throw std::domain_error("Matrix is singular");
+    }
+
+    /*! right-looking blocked factorization in place
+     */
+    void factor()
+    {
+        using policy = typename matrix_type::policy_type;
+        constexpr size_type NB = detail::factor_blocking::NB;
+        size_type const n = dim();
+        std::ptrdiff_t const rs = static_cast<std::ptrdiff_t>(n);
+        tpDataType * const a = m_factors.data();
+        std::vector<tpDataType> temp;
+
+        for (size_type k = 0; k < n; k += NB) {
+            size_type const b = std::min(NB, n - k);
+            factor_panel(k, b);
+
+            // U12 = L11^-1 * A12, then A22 -= L21 * U12
+            size_type const rest = n - k - b;
+            detail::substitute(b, rest, a + k * n + k, rs, 1, triangle::lower, true, a + k * n + k + b, rs);
+            detail::subtract_product<policy>(rest, rest, b, a + (k + b) * n + k, rs, 1, a + k * n + k + b, rs, 1,
+                                             a + (k + b) * n + k + b, rs, temp);
+        }
+    }
+
+    /*! factors columns xx_k ... xx_k + xx_b - 1 from row xx_k down, swapping whole rows
+     */
+    void factor_panel(size_type const xx_k, size_type const xx_b)
+    {
+        size_type const n = dim();
+        tpDataType * const a = m_factors.data();
+        for (size_type j = xx_k; j < xx_k + xx_b; ++j) {
+            size_type pivot = j;
+            auto largest = std::abs(a[j * n + j]);
+            for (size_type i = j + 1; i < n; ++i) {
+                auto const candidate = std::abs(a[i * n + j]);
+                if (candidate > largest) {
+                    largest = candidate;
+                    pivot = i;
+                }
+            }
+            m_pivots[j] = pivot;
+            if (pivot != j) {
+                std::swap_ranges(a + j * n, a + (j + 1) * n, a + pivot * n);
+                ++m_swaps;
+            }
+
+            tpDataType const diagonal = a[j * n + j];
+            if (diagonal == tpDataType(0)) {
+                m_singular = true;
+                continue;
+            }
+            tpDataType const inverse = tpDataType(1) / diagonal;
+            size_type const width = xx_k + xx_b - j - 1;
+            for (size_type i = j + 1; i < n; ++i) {
+                tpDataType * const row = a + i * n;
+                row[j] *= inverse;
+                detail::subtract_scaled(row + j + 1, a + j * n + j + 1, row[j], width);
+            }
+        }
+    }
+
+    matrix_type m_factors;
+    std::vector<size_type> m_pivots;
+    size_type m_swaps;
+    bool m_singular;
+};
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! solves A * x = xx_rhs through an LU factorization of xx_matrix
+ \throw std::domain_error if the matrix is not square, the dimensions differ or the matrix is singular
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType, typename tpVectorAllocator>
+vector<tpDataType, tpVectorAllocator> solve(matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_matrix, vector<tpDataType, tpVectorAllocator> const & xx_rhs)
+{
+    return lu_factorization<tpDataType, tpPolicyType, tpAllocatorType>(std::move(xx_matrix)).solve(xx_rhs);
+}
+
+/*! solves A * X = xx_rhs through an LU factorization of xx_matrix
+ \throw std::domain_error if the matrix is not square, the dimensions differ or the matrix is singular
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> solve(matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_matrix,
+                                                        matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_rhs)
+{
+    return lu_factorization<tpDataType, tpPolicyType, tpAllocatorType>(std::move(xx_matrix)).solve(std::move(xx_rhs));
+}
+
+/*! determinant of a square matrix through its LU factorization
+ \throw std::domain_error if the matrix is not square
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+tpDataType determinant(matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_matrix)
+{
+    return lu_factorization<tpDataType, tpPolicyType, tpAllocatorType>(std::move(xx_matrix)).determinant();
+}
+
+/*! inverse of a square matrix through its LU factorization
+ \note solving against the factors is cheaper and more accurate than multiplying by the inverse.
+ \throw std::domain_error if the matrix is not square or singular
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> inverse(matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_matrix)
+{
+    return lu_factorization<tpDataType, tpPolicyType, tpAllocatorType>(std::move(xx_matrix)).inverse();
+}
+
+}
+#endif /* lu_h */
@@ -5,13 +5,22 @@
 //  Created by Mohammed Afroze on 23.02.20.
 */
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
 #include <iostream>
 #include <initializer_list>
+#include <utility>
 
+#include "cholesky.hpp"
+#include "iterative.hpp"
+#include "lu.hpp"
 #include "matrix.hpp"
 #include "matrix_helpers.hpp"
+#include "qr.hpp"
+#include "spectral.hpp"
 #include "vector_helpers.hpp"
+#include "view.hpp"
 
 int main(int argc, const char * argv[]) {
     
@@ -59,5 +68,116 @@ int main(int argc, const char * argv[]) {
     auto casted_v3 =  assignment::cast_V2M<int, assignment::NonParallel>(v3, 1, 3);
     std::cout << "Cast vector2Matrix: " << casted_v3 << std::endl;
 
+    // largest absolute element of xx_a - xx_b; the factorizations below are checked against operator* reconstructions
+    auto const max_error = [](assignment::matrix<double> const & xx_a, assignment::matrix<double> const & xx_b) {
+        double result = 0;
+        for (std::size_t i = 0; i < xx_a.dimR(); ++i)
+            for (std::size_t j = 0; j < xx_a.dimC(); ++j)
+                result = std::max(result, std::abs(xx_a(i, j) - xx_b(i, j)));
+        return result;
+    };
+    assignment::matrix<double> identity(3,3,{1,0,0,0,1,0,0,0,1});
+
+    // LU: P * A = L * U
+    assignment::matrix<double> a_lu(3,3,{2,1,1,4,-6,0,-2,7,2});
+    assignment::lu_factorization<double> lu(a_lu);
+    assignment::matrix<double> l_lu(3,3,0.0), u_lu(3,3,0.0), pa_lu(a_lu);
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j)
+            (j < i ? l_lu(i, j) : u_lu(i, j)) = lu.factors()(i, j);
+        l_lu(i, i) = 1;
+        for (std::size_t j = 0; j < 3; ++j)
+            std::swap(pa_lu(i, j), pa_lu(lu.pivots()[i], j));
+    }
+    std::cout << "LU max|P*A - L*U|: " << max_error(pa_lu, l_lu * u_lu) << std::endl;
+    std::cout << "LU solve (1,1,2): " << lu.solve(assignment::vector<double>({5,-2,9})) << std::endl;
+    std::cout << "LU determinant (-16): " << lu.determinant() << std::endl;
+    std::cout << "LU max|A*inverse(A) - I|: " << max_error(a_lu * lu.inverse(), identity) << std::endl;
+
+    // Cholesky: A = L * L^T
+    assignment::matrix<double> a_ch(3,3,{4,12,-16,12,37,-43,-16,-43,98});
+    assignment::cholesky_factorization<double> ch(a_ch);
+    assignment::matrix<double> l_ch(ch.factor_lower());
+    std::cout << "Cholesky L: " << l_ch << std::endl;
+    std::cout << "Cholesky max|A - L*L^T|: " << max_error(a_ch, l_ch * assignment::matrix<double>(assignment::transpose(l_ch))) << std::endl;
+    std::cout << "Cholesky solve (1,1,1): " << ch.solve(assignment::vector<double>({0,6,39})) << std::endl;
+    std::cout << "Cholesky max|A*inverse(A) - I|: " << max_error(a_ch * ch.inverse(), identity) << std::endl;
+
+    // QR: A = Q * R, and the least-squares solve of a consistent system
+    assignment::matrix<double> a_qr(4,3,{1,2,0,0,1,1,1,0,1,1,1,1});
+    assignment::qr_factorization<double> qr(a_qr);
+    assignment::matrix<double> q_qr = qr.Q();
+    std::cout << "QR max|A - Q*R|: " << max_error(a_qr, q_qr * qr.R()) << std::endl;
+    std::cout << "QR max|Q^T*Q - I|: " << max_error(assignment::matrix<double>(assignment::transpose(q_qr)) * q_qr, identity) << std::endl;
+    std::cout << "QR least_squares (1,2,3): " << qr.least_squares(assignment::vector<double>({5,5,4,6})) << std::endl;
+
+    // TSQR of a tall-skinny matrix split into row blocks: R^T * R = A^T * A
+    std::size_t const rows_ts = 100000;
+    assignment::matrix<double> a_ts(rows_ts, 3);
+    assignment::vector<double> b_ts(rows_ts);
+    for (std::size_t i = 0; i < rows_ts; ++i) {
+        for (std::size_t j = 0; j < 3; ++j)
+            a_ts(i, j) = std::cos(0.001 * double(i) * double(j + 1)) + (i % 3 == j ? 1 : 0);
+        b_ts[i] = a_ts(i, 0) + 2 * a_ts(i, 1) + 3 * a_ts(i, 2);
+    }
+    assignment::tsqr_factorization<double> ts(a_ts);
+    assignment::matrix<double> r_ts = ts.R();
+    assignment::matrix<double> gram_ts = assignment::matrix<double>(assignment::transpose(a_ts)) * a_ts;
+    std::cout << "TSQR blocks: " << ts.blocks() << std::endl;
+    std::cout << "TSQR max|R^T*R - A^T*A| / rows: "
+              << max_error(assignment::matrix<double>(assignment::transpose(r_ts)) * r_ts, gram_ts) / double(rows_ts) << std::endl;
+    std::cout << "TSQR least_squares (1,2,3): " << assignment::least_squares(a_ts, b_ts) << std::endl;
+
+    // Krylov solvers on a diagonally dominant system with the solution (1,1,1,1,1)
+    assignment::matrix<double> a_kr(5,5,{4,-1,0,0,0,-1,4,-1,0,0,0,-1,4,-1,0,0,0,-1,4,-1,0,0,0,-1,4});
+    assignment::vector<double> b_kr({3,2,2,2,3});
+    assignment::vector<double> x_cg(5, 0.0), x_bicgstab(5, 0.0), x_gmres(5, 0.0);
+    assignment::iterative_result const r_cg = assignment::cg(a_kr, b_kr, x_cg);
+    assignment::iterative_result const r_bicgstab = assignment::bicgstab(a_kr, b_kr, x_bicgstab, assignment::iterative_options(),
+                                                                         assignment::jacobi_preconditioner<double>(a_kr));
+    assignment::iterative_result const r_gmres = assignment::gmres(a_kr, b_kr, x_gmres);
+    std::cout << "CG: " << x_cg << " iterations " << r_cg.iterations << ", residual " << r_cg.residual << std::endl;
+    std::cout << "BiCGSTAB: " << x_bicgstab << " iterations " << r_bicgstab.iterations << ", residual " << r_bicgstab.residual << std::endl;
+    std::cout << "GMRES: " << x_gmres << " iterations " << r_gmres.iterations << ", residual " << r_gmres.residual << std::endl;
+
+    // eigs of the 50 x 50 second difference matrix, eigenvalues 2 - 2 cos(k pi / 51)
+    std::size_t const dim_ei = 50;
+    assignment::matrix<double> a_ei(dim_ei, dim_ei, 0.0);
+    for (std::size_t i = 0; i < dim_ei; ++i) {
+        a_ei(i, i) = 2;
+        if (i > 0)
+            a_ei(i, i - 1) = a_ei(i - 1, i) = -1;
+    }
+    assignment::vector<double> exact_ei(3);
+    for (std::size_t i = 0; i < 3; ++i)
+        exact_ei[i] = 2 - 2 * std::cos(double(dim_ei - i) * std::acos(-1.0) / double(dim_ei + 1));
+    auto const eigen_ei = assignment::eigs(a_ei, 3);
+    assignment::matrix<double> lv_ei(eigen_ei.vectors);
+    for (std::size_t i = 0; i < dim_ei; ++i)
+        for (std::size_t j = 0; j < 3; ++j)
+            lv_ei(i, j) *= eigen_ei.values[j];
+    std::cout << "eigs: " << eigen_ei.values << " exact " << exact_ei << std::endl;
+    std::cout << "eigs max|A*v - lambda*v|: " << max_error(a_ei * eigen_ei.vectors, lv_ei) << std::endl;
+
+    // randomized_svd of A = Q * diag(1, 1/2, ..., 1/40) with orthonormal Q, 60 x 40, singular values 1, 1/2, 1/3, ...
+    assignment::matrix<double> a_sv(60, 40);
+    for (std::size_t i = 0; i < 60; ++i)
+        for (std::size_t j = 0; j < 40; ++j)
+            a_sv(i, j) = std::cos(double(i * j + i + 2 * j)) + (i == j ? 2 : 0);
+    a_sv = assignment::qr_factorization<double>(a_sv).Q();
+    for (std::size_t i = 0; i < 60; ++i)
+        for (std::size_t j = 0; j < 40; ++j)
+            a_sv(i, j) /= double(j + 1);
+    // the power iterations stop once the singular values settle, and the vectors lag behind them: ask for a tight tolerance
+    assignment::spectral_options options_sv;
+    options_sv.tolerance = 1e-14;
+    auto const svd_sv = assignment::randomized_svd(a_sv, 3, options_sv);
+    assignment::matrix<double> su_sv(svd_sv.U);
+    for (std::size_t i = 0; i < 60; ++i)
+        for (std::size_t j = 0; j < 3; ++j)
+            su_sv(i, j) *= svd_sv.values[j];
+    std::cout << "randomized_svd (1,0.5,0.333333): " << svd_sv.values << std::endl;
+    std::cout << "randomized_svd max|A*v - sigma*u|: " << max_error(a_sv * svd_sv.V, su_sv) << std::endl;
+
     return 0;
 }
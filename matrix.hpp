@@ -17,27 +17,57 @@
 #include <stdexcept>
 #include <type_traits>
 
+#include "allocator.hpp"
+#include "expression.hpp"
+#include "gemm.hpp"
+#include "gemv.hpp"
+#include "igemm.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "strassen.hpp"
 #include "vector.hpp"
 
 namespace assignment {
 
 /*! struct containing matrix data and convienience indexing functions.
  \tparam tpDataType matrix type
+ \tparam tpAllocatorType allocator of the row-major storage
  */
-template<typename tpDataType>
+template<typename tpDataType, typename tpAllocatorType = aligned_allocator<tpDataType>>
 struct MData {
 
     std::size_t m_dimR;
     std::size_t m_dimC;
-    std::unique_ptr<tpDataType[]> m_data;
+    buffer<tpDataType, tpAllocatorType> m_data;
 
     MData(std::size_t dimR, std::size_t dimC) :
                     m_dimR(dimR),
                     m_dimC(dimC),
-                    m_data(new tpDataType[dimR * dimC])
+                    m_data(dimR * dimC)
     {
     }
 
+    /*! takes over the storage of xx_data, which is left as an empty 0 x 0 block
+     */
+    MData(MData && xx_data) noexcept :
+                    m_dimR(xx_data.m_dimR),
+                    m_dimC(xx_data.m_dimC),
+                    m_data(std::move(xx_data.m_data))
+    {
+        xx_data.m_dimR = 0;
+        xx_data.m_dimC = 0;
+    }
+
+    MData & operator=(MData && xx_data) noexcept
+    {
+        m_dimR = xx_data.m_dimR;
+        m_dimC = xx_data.m_dimC;
+        m_data = std::move(xx_data.m_data);
+        xx_data.m_dimR = 0;
+        xx_data.m_dimC = 0;
+        return *this;
+    }
+
     tpDataType const & operator()(std::size_t R, std::size_t C) const
     {
         return m_data[R * m_dimC + C];
@@ -53,6 +83,13 @@ struct MData {
  */
 template<typename tpMatrixType>
 struct NonParallel {
+
+    using value_type = typename tpMatrixType::value_type;
+
+    /*! whether kernels outside the class (Ex: the sparse products) may spread their work over the thread pool
+     */
+    static constexpr bool is_parallel = false;
+
     /*! worker class, which is just used to process data !
      \param xx_matrix_result matrix to hold result
      \param xx_left_matrix left matrix
@@ -60,36 +97,226 @@ struct NonParallel {
      */
     static void matrix_multiply(tpMatrixType * xx_matrix_result, tpMatrixType const * xx_left_matrix, tpMatrixType const * xx_right_matrix)
     {
+        multiply(xx_left_matrix->dimR(), xx_right_matrix->dimC(), xx_left_matrix->dimC(),
+                 xx_left_matrix->data(), xx_left_matrix->dimC(), 1,
+                 xx_right_matrix->data(), xx_right_matrix->dimC(), 1,
+                 xx_matrix_result->data(), xx_matrix_result->dimC());
+    }
 
-        for (typename tpMatrixType::size_type R = 0; R < xx_left_matrix->dimR(); ++R) {
-            for (typename tpMatrixType::size_type C = 0; C < xx_right_matrix->dimC(); ++C) {
-                (*xx_matrix_result)(R, C) = static_cast<typename tpMatrixType::value_type>(0.0);
-                for (typename tpMatrixType::size_type i = 0; i < xx_left_matrix->dimC(); ++i) {
-                    (*xx_matrix_result)(R, C) += (*xx_left_matrix)(R, i) * ((*xx_right_matrix)(i, C));
-                }
-            }
-        }
+    /*! C = A * B for strided operands (Ex: views on blocks of larger matrices), see detail::gemm
+     */
+    static void multiply(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+                         value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                         value_type const * xx_right, std::ptrdiff_t const xx_rsB, std::ptrdiff_t const xx_csB,
+                         value_type * xx_result, std::ptrdiff_t const xx_rsC)
+    {
+        detail::gemm(xx_M, xx_N, xx_K, xx_left, xx_rsA, xx_csA, xx_right, xx_rsB, xx_csB, xx_result, xx_rsC);
+    }
+
+    /*! y = A * x for a strided matrix and vector, see detail::gemv
+     */
+    static void vector_multiply(std::size_t const xx_M, std::size_t const xx_N,
+                                value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                                value_type const * xx_vector, std::ptrdiff_t const xx_incx, value_type * xx_result)
+    {
+        detail::gemv(xx_M, xx_N, xx_left, xx_rsA, xx_csA, xx_vector, xx_incx, xx_result);
+    }
+
+    /*! y_j = A * x_j for a batch of vectors, see detail::gemv_batch
+     */
+    static void batch_multiply(std::size_t const xx_M, std::size_t const xx_N,
+                               value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                               std::size_t const xx_count, value_type const * const * xx_vectors, value_type * const * xx_results)
+    {
+        detail::gemv_batch(xx_M, xx_N, xx_left, xx_rsA, xx_csA, xx_count, xx_vectors, xx_results);
     }
 };
 
-/*! worker class, which is just used to process data !
+/*! worker class, which splits the result matrix into row and column tiles and computes them on all threads of the pool
  \tparam tpMatrixType matrix type
- \note Not implemented yet. Can implement parallel matrix operation.
  */
 template<typename tpMatrixType>
 struct Parallel {
+
+    using value_type = typename tpMatrixType::value_type;
+
+    /*! kernels outside the class (Ex: the sparse products) spread their work over the thread pool as well
+     */
+    static constexpr bool is_parallel = true;
+
+    /*! smallest edge of a tile; below this the threading overhead dominates
+     */
+    static constexpr std::size_t min_tile = 64;
+
+    /*! largest edge of a tile; keeps a row panel of the result and the right matrix tile in cache
+     */
+    static constexpr std::size_t max_tile = 256;
+
+    /*! fewest matrix elements a thread multiplies with a vector; below this the threading overhead dominates
+     */
+    static constexpr std::size_t min_panel = std::size_t(1) << 15;
+
     /*! worker class, which is just used to process data !
      \param xx_matrix_result matrix to hold result
      \param xx_left_matrix left matrix
      \param xx_right_matrix right matrix
+     \note xx_matrix_result must not alias either operand.
      */
     static void matrix_multiply(tpMatrixType * xx_matrix_result, tpMatrixType const * xx_left_matrix, tpMatrixType const * xx_right_matrix)
     {
-        std::domain_error("Not Yet Implemented");
+        multiply(xx_left_matrix->dimR(), xx_right_matrix->dimC(), xx_left_matrix->dimC(),
+                 xx_left_matrix->data(), xx_left_matrix->dimC(), 1,
+                 xx_right_matrix->data(), xx_right_matrix->dimC(), 1,
+                 xx_matrix_result->data(), xx_matrix_result->dimC());
+    }
+
+    /*! C = A * B for strided operands (Ex: views on blocks of larger matrices), see detail::gemm
+     \note xx_result must not alias either operand.
+     */
+    static void multiply(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+                         value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                         value_type const * xx_right, std::ptrdiff_t const xx_rsB, std::ptrdiff_t const xx_csB,
+                         value_type * xx_result, std::ptrdiff_t const xx_rsC)
+    {
+        using size_type = typename tpMatrixType::size_type;
+
+        size_type const dimR = xx_M;
+        size_type const dimC = xx_N;
+
+        // shrink the tiles until every thread gets a few of them to balance the load
+        size_type const wanted_tiles = 4 * detail::pool_threads();
+        size_type tile = max_tile;
+        while (tile > min_tile && ((dimR + tile - 1) / tile) * ((dimC + tile - 1) / tile) < wanted_tiles)
+            tile /= 2;
+
+        thread_pool::current().parallel_for_2d(dimR, dimC, tile, tile, [&](size_type const xx_beginR, size_type const xx_endR,
+                                                                          size_type const xx_beginC, size_type const xx_endC) {
+            detail::gemm(xx_endR - xx_beginR, xx_endC - xx_beginC, xx_K,
+                         xx_left + static_cast<std::ptrdiff_t>(xx_beginR) * xx_rsA, xx_rsA, xx_csA,
+                         xx_right + static_cast<std::ptrdiff_t>(xx_beginC) * xx_csB, xx_rsB, xx_csB,
+                         xx_result + static_cast<std::ptrdiff_t>(xx_beginR) * xx_rsC + xx_beginC, xx_rsC);
+        });
+    }
+
+    /*! y = A * x for a strided matrix and vector, with the rows split into panels computed on all threads of the pool
+     \note every row is computed by one thread, so the result is the same as with NonParallel.
+     */
+    static void vector_multiply(std::size_t const xx_M, std::size_t const xx_N,
+                                value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                                value_type const * xx_vector, std::ptrdiff_t const xx_incx, value_type * xx_result)
+    {
+        using size_type = typename tpMatrixType::size_type;
+
+        size_type const rows = panel_rows(xx_M, xx_N);
+        detail::parallel_for((xx_M + rows - 1) / rows, [&](size_type const xx_panel) {
+            size_type const beginR = xx_panel * rows;
+            detail::gemv(std::min(rows, xx_M - beginR), xx_N, xx_left + static_cast<std::ptrdiff_t>(beginR) * xx_rsA, xx_rsA, xx_csA,
+                         xx_vector, xx_incx, xx_result + beginR);
+        });
+    }
+
+    /*! y_j = A * x_j for a batch of vectors, with the rows split into panels computed on all threads of the pool
+     \note every thread streams its panel of A once for the whole batch.
+     */
+    static void batch_multiply(std::size_t const xx_M, std::size_t const xx_N,
+                               value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                               std::size_t const xx_count, value_type const * const * xx_vectors, value_type * const * xx_results)
+    {
+        using size_type = typename tpMatrixType::size_type;
+
+        size_type const rows = panel_rows(xx_M, xx_N * xx_count);
+        detail::parallel_for((xx_M + rows - 1) / rows, [&](size_type const xx_panel) {
+            size_type const beginR = xx_panel * rows;
+            std::vector<value_type *> results(xx_results, xx_results + xx_count);
+            for (auto & result : results)
+                result += beginR;
+            detail::gemv_batch(std::min(rows, xx_M - beginR), xx_N, xx_left + static_cast<std::ptrdiff_t>(beginR) * xx_rsA, xx_rsA, xx_csA,
+                               xx_count, xx_vectors, results.data());
+        });
+    }
+
+private:
+
+    /*! rows of a panel of a matrix-vector product with xx_work multiply-adds per row
+     \note a few panels per thread balance the load, each panel is a whole number of row blocks and none is smaller than min_panel.
+     */
+    static std::size_t panel_rows(std::size_t const xx_M, std::size_t const xx_work)
+    {
+        constexpr std::size_t ROWS = detail::gemv_blocking::ROWS;
+        std::size_t const wanted_panels = 4 * detail::pool_threads();
+        std::size_t const rows = std::max((xx_M + wanted_panels - 1) / wanted_panels, (min_panel + xx_work - 1) / std::max<std::size_t>(xx_work, 1));
+        return (rows + ROWS - 1) / ROWS * ROWS;
     }
 };
 
-template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+/*! worker class, which multiplies large matrices with the sub-cubic Strassen-Winograd recursion (see detail::strassen)
+ \tparam tpMatrixType matrix type
+ \note products whose smallest dimension is below 2 * detail::strassen_cutoff, and all matrix-vector products, are computed
+ exactly as with NonParallel. Integer results are exact as long as the intermediate sums do not overflow. For floating
+ point types the error is bounded normwise rather than per element: for n x n operands recursing down to n0 = cutoff,
+ max|C - C'| <= ((n / n0)^log2(18) * (n0^2 + 6 n0) - 6 n) * u * max|A| * max|B| to first order in the unit roundoff u
+ (Higham, Accuracy and Stability of Numerical Algorithms, ch. 23), against n * u * (|A| * |B|) for the regular kernel.
+ Elements of C much smaller than max|A| * max|B| can therefore lose relative accuracy.
+ */
+template<typename tpMatrixType>
+struct Strassen {
+
+    using value_type = typename tpMatrixType::value_type;
+
+    /*! the recursion runs on the calling thread
+     */
+    static constexpr bool is_parallel = false;
+
+    /*! worker class, which is just used to process data !
+     \param xx_matrix_result matrix to hold result
+     \param xx_left_matrix left matrix
+     \param xx_right_matrix right matrix
+     \note xx_matrix_result must not alias either operand.
+     */
+    static void matrix_multiply(tpMatrixType * xx_matrix_result, tpMatrixType const * xx_left_matrix, tpMatrixType const * xx_right_matrix)
+    {
+        multiply(xx_left_matrix->dimR(), xx_right_matrix->dimC(), xx_left_matrix->dimC(),
+                 xx_left_matrix->data(), xx_left_matrix->dimC(), 1,
+                 xx_right_matrix->data(), xx_right_matrix->dimC(), 1,
+                 xx_matrix_result->data(), xx_matrix_result->dimC());
+    }
+
+    /*! C = A * B for strided operands (Ex: views on blocks of larger matrices), see detail::strassen
+     \note xx_result must not alias either operand.
+     */
+    static void multiply(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+                         value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                         value_type const * xx_right, std::ptrdiff_t const xx_rsB, std::ptrdiff_t const xx_csB,
+                         value_type * xx_result, std::ptrdiff_t const xx_rsC)
+    {
+        detail::strassen(xx_M, xx_N, xx_K, xx_left, xx_rsA, xx_csA, xx_right, xx_rsB, xx_csB, xx_result, xx_rsC);
+    }
+
+    /*! y = A * x for a strided matrix and vector, see detail::gemv
+     */
+    static void vector_multiply(std::size_t const xx_M, std::size_t const xx_N,
+                                value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                                value_type const * xx_vector, std::ptrdiff_t const xx_incx, value_type * xx_result)
+    {
+        detail::gemv(xx_M, xx_N, xx_left, xx_rsA, xx_csA, xx_vector, xx_incx, xx_result);
+    }
+
+    /*! y_j = A * x_j for a batch of vectors, see detail::gemv_batch
+     */
+    static void batch_multiply(std::size_t const xx_M, std::size_t const xx_N,
+                               value_type const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                               std::size_t const xx_count, value_type const * const * xx_vectors, value_type * const * xx_results)
+    {
+        detail::gemv_batch(xx_M, xx_N, xx_left, xx_rsA, xx_csA, xx_count, xx_vectors, xx_results);
+    }
+};
+
+/*! mathematical matrix
+ \tparam tpDataType element type
+ \tparam tpPolicyType policy used for matrix multiplication
+ \tparam tpAllocatorType allocator of the storage; 64 byte aligned by default, pool_allocator recycles same-sized buffers
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
 class matrix {
 public:
 
@@ -101,6 +328,14 @@ public:
      */
     using size_type = std::size_t;
 
+    /*! allocator of the storage
+     */
+    using allocator_type = tpAllocatorType;
+
+    /*! policy used for matrix multiplication
+     */
+    using policy_type = tpPolicyType<matrix>;
+
     /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
 
     /*! constructor
@@ -143,7 +378,14 @@ public:
     /*! move constructor
      \param xx_matrix  Dimension of the matrix; treated as xx_dim X xx_dim
      */
-    matrix(matrix && xx_matrix);
+    matrix(matrix && xx_matrix) noexcept;
+
+    /*! constructor from an element-wise expression (Ex: m1 + m2 * 3)
+     \note all elements are computed in a single pass without intermediate matrices; a temporary matrix inside a temporary
+     expression (Ex: the product in m1 * m2 + m3) lends its storage to the result
+     */
+    template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, matrix_kind, tpDataType>::value>::type* = nullptr>
+    matrix(tpExpression && xx_expression);
 
     /* ==== a  s  s  i  g  n  m  e  n  t     o  p  e  r  a  t  o  r  s ==== */
 
@@ -152,8 +394,15 @@ public:
     matrix & operator=(matrix const & xx_matrix);
 
     /*! move assignment operator
+     \note takes over the storage of xx_matrix, which is left as an empty 0 x 0 matrix
+     */
+    matrix & operator=(matrix && xx_matrix) noexcept;
+
+    /*! assignment from an element-wise expression
+     \note evaluated in place, without allocation, if the dimensions do not change
      */
-    matrix & operator=(matrix && xx_matrix);
+    template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, matrix_kind, tpDataType>::value>::type* = nullptr>
+    matrix & operator=(tpExpression && xx_expression);
 
     /* ==== d  e  s  t  r  u  c  t  o  r ==== */
 
@@ -163,22 +412,18 @@ public:
 
     /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ====*/
 
-    /*! + operator overload
-     \throw std::domain_error; if dimensions are not equal as (*this) matrix
-     */
-    matrix operator+(matrix const & xx_matrix) const;
+    /* element-wise +, - and the scalar forms are free operators building lazy expressions, see expression.hpp */
 
     /*! + operator overload for the vector on the RHS.
      * \param xx_col_vector can be of any dimension but should have the meaning of a matrix having one coloumn
      * \note If xx_col_vector is greater than (*this) matrix_dimC then values are clipped accordingly and if contains less then vector is appended with zeros
      */
-    matrix operator+(assignment::vector<tpDataType> const & xx_col_vector) const;
+    matrix operator+(assignment::vector<tpDataType, tpAllocatorType> const & xx_col_vector) const &;
 
-    /*! -operator overload
-     * \param xx_matrix is the same dimension as (*this) matrix
-     * \throw std::domain_error; if dimensions are not equal as (*this) matrix
+    /*! + operator overload for the vector on the RHS of a temporary matrix
+     * \note the sum is computed in place and the storage of (*this) is returned without allocating
      */
-    matrix operator-(matrix const & xx_matrix) const;
+    matrix operator+(assignment::vector<tpDataType, tpAllocatorType> const & xx_col_vector) &&;
 
     /*! *operator overload => Policy Matrix multiplication
      * \param xx_matrix is the same dimension as (*this) matrix
@@ -187,40 +432,25 @@ public:
      */
     matrix operator*(matrix const & xx_matrix) const;
 
-    /*! *operator overload => Element-wise multiplication
+    /*! *operator overload => Policy Matrix-vector multiplication
      * \param xx_col_vector is similar to coloumn matrix
      * \throw std::domain_error if coloumn dimension of (*this) matrix not equal to vector dimension
+     * \note uses the policy with which the matrix class is instantiated.
      */
-    assignment::vector<tpDataType> operator*(assignment::vector<tpDataType> const & xx_col_vector) const;
-
-    /*! +operator overload with a scalar value
-     */
-    matrix operator+(tpDataType const & xx_scalar) const;
-
-    /*! -operator overload with a scalar value.
-     */
-    matrix operator-(tpDataType const & xx_scalar) const;
-
-    /*! *operator overload with a scalar value => element-wise multiplication
-     */
-    matrix operator*(tpDataType const xx_scalar) const;
-
-    /*! *operator overload with a scalar value
-     * \note enabled only when Non-integral data-type is used.
-     */
-    template<typename TDummy = tpDataType, typename std::enable_if<!std::is_integral<TDummy>::value>::type* = nullptr>
-    matrix<tpDataType, tpPolicyType> operator *(size_type const xx_scalar) const;
+    assignment::vector<tpDataType, tpAllocatorType> operator*(assignment::vector<tpDataType, tpAllocatorType> const & xx_col_vector) const;
 
-    /*! +=operator overload with matrix
-     * \param xx_matrix same dimension as (*this) matrix
-     * \throw std::domain_error if coloumn dimension of (*this) matrix not equal to vector dimension
+    /*! +=operator overload with a matrix or matrix expression
+     * \param xx_expression same dimension as (*this) matrix
+     * \throw std::domain_error if the dimensions differ from (*this) matrix
      */
-    matrix & operator+=(matrix const & xx_matrix);
+    template<typename tpExpression, typename std::enable_if<detail::are_compatible<matrix, tpExpression>::value>::type* = nullptr>
+    matrix & operator+=(tpExpression const & xx_expression);
 
-    /*! -=operator overload with matrix
-     * \throw std::domain_error if coloumn dimension of (*this) matrix not equal to vector dimension
+    /*! -=operator overload with a matrix or matrix expression
+     * \throw std::domain_error if the dimensions differ from (*this) matrix
      */
-    matrix & operator-=(matrix const & xx_matrix);
+    template<typename tpExpression, typename std::enable_if<detail::are_compatible<matrix, tpExpression>::value>::type* = nullptr>
+    matrix & operator-=(tpExpression const & xx_expression);
 
     /*! *=operator overload with matrix => Policy Matrix Multiplication (only for square matrices)
      * \throw std::domain_error if coloumn dimension of (*this) matrix not equal to vector dimension
@@ -251,6 +481,14 @@ public:
      */
     void set(tpDataType const & xx_value);
 
+    /*! Get the pointer to the row-major matrix data
+     */
+    tpDataType const * data() const;
+
+    /*! Get the pointer to the row-major matrix data
+     */
+    tpDataType * data();
+
 private:
 
     /*! number of rows and columns
@@ -259,30 +497,46 @@ private:
 
     /*! pointer to the matrix data
      */
-    MData<tpDataType> m_data;
+    MData<tpDataType, tpAllocatorType> m_data;
 
 };
 
+/*! matrices are the leaves of matrix expressions
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+struct expression_traits<matrix<tpDataType, tpPolicyType, tpAllocatorType>> {
+    static constexpr bool is_expression = true;
+    static constexpr bool is_leaf = true;
+    using kind = matrix_kind;
+    using value_type = tpDataType;
+    using result_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    static std::size_t size(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix)
+    {
+        return xx_matrix.dimR() * xx_matrix.dimC();
+    }
+};
+
 /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType>::matrix(size_type const xx_dim) :
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(size_type const xx_dim) :
                 m_dimR(xx_dim),
                 m_dimC(xx_dim),
                 m_data(xx_dim, xx_dim)
 {
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType>::matrix(size_type const xx_dimR, size_type const xx_dimC) :
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(size_type const xx_dimR, size_type const xx_dimC) :
                 m_dimR(xx_dimR),
                 m_dimC(xx_dimC),
                 m_data(xx_dimR, xx_dimC)
 {
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType>::matrix(size_type const xx_dimR, size_type const xx_dimC, tpDataType const xx_value) :
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(size_type const xx_dimR, size_type const xx_dimC, tpDataType const xx_value) :
                 m_dimR(xx_dimR),
                 m_dimC(xx_dimC),
                 m_data(m_dimR, m_dimC)
@@ -294,21 +548,17 @@ assignment::matrix<tpDataType, tpPolicyType>::matrix(size_type const xx_dimR, si
     }
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType>::matrix(size_type const xx_dimR, size_type const xx_dimC, tpDataType const* xx_ptr_array) :
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(size_type const xx_dimR, size_type const xx_dimC, tpDataType const* xx_ptr_array) :
                 m_dimR(xx_dimR),
                 m_dimC(xx_dimC),
                 m_data(m_dimR, m_dimC)
 {
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            m_data(R, C) = xx_ptr_array(R, C);
-        }
-    }
+    std::copy(xx_ptr_array, xx_ptr_array + m_dimR * m_dimC, data());
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType>::matrix(size_type const xx_dimR, size_type const xx_dimC, std::initializer_list<tpDataType>&& xx_list) :
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(size_type const xx_dimR, size_type const xx_dimC, std::initializer_list<tpDataType>&& xx_list) :
                 m_dimR(xx_dimR),
                 m_dimC(xx_dimC),
                 m_data(m_dimR, m_dimC)
@@ -325,193 +575,147 @@ assignment::matrix<tpDataType, tpPolicyType>::matrix(size_type const xx_dimR, si
     }
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType>::matrix(matrix const & xx_matrix) :
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(matrix const & xx_matrix) :
                 m_dimR(xx_matrix.m_dimR),
                 m_dimC(xx_matrix.m_dimC),
                 m_data(m_dimR, m_dimC)
 {
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            m_data(R, C) = xx_matrix.m_data(R, C);
-        }
-    }
+    std::copy(xx_matrix.data(), xx_matrix.data() + m_dimR * m_dimC, data());
+}
 
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(matrix && xx_matrix) noexcept :
+                m_dimR(xx_matrix.m_dimR),
+                m_dimC(xx_matrix.m_dimC),
+                m_data(std::move(xx_matrix.m_data))
+{
+    xx_matrix.m_dimR = 0;
+    xx_matrix.m_dimC = 0;
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType>::matrix(matrix && xx_matrix) :
-                m_dimR(std::move(xx_matrix.m_dimR)),
-                m_dimC(std::move(xx_matrix.m_dimC)),
-                m_data(m_dimR, m_dimC)
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, matrix_kind, tpDataType>::value>::type*>
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::matrix(tpExpression && xx_expression) :
+                matrix(detail::materialize<matrix>(std::forward<tpExpression>(xx_expression)))
 {
-    m_data = std::move(xx_matrix.m_data);
 }
 
 /*  a  s  s  i  g  n  m  e  n  t     o  p  e  r  a  t  o  r  s  */
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> &
-assignment::matrix<tpDataType, tpPolicyType>::operator=(matrix const & xx_matrix)
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> &
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator=(matrix const & xx_matrix)
 {
     if (this == &xx_matrix)
         return *this;
 
-    m_dimR = xx_matrix.m_dimR;
-    m_dimC = xx_matrix.m_dimC;
-    m_data(m_dimR, m_dimC);
-
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimR; ++C) {
-            m_data(R, C) = xx_matrix.m_data(R, C);
-        }
+    // the storage is only replaced if the dimensions change
+    if (m_dimR != xx_matrix.m_dimR || m_dimC != xx_matrix.m_dimC) {
+        m_data = MData<tpDataType, tpAllocatorType>(xx_matrix.m_dimR, xx_matrix.m_dimC);
+        m_dimR = xx_matrix.m_dimR;
+        m_dimC = xx_matrix.m_dimC;
     }
+    std::copy(xx_matrix.data(), xx_matrix.data() + m_dimR * m_dimC, data());
+    return *this;
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> &
-assignment::matrix<tpDataType, tpPolicyType>::operator=(matrix && xx_matrix)
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> &
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator=(matrix && xx_matrix) noexcept
 {
     if (this == &xx_matrix)
         return *this;
-    if ((m_dimC != xx_matrix.m_dimC) && (m_dimR != xx_matrix.m_dimR)) {
-        m_dimR = xx_matrix.m_dimR;
-        m_dimC = xx_matrix.m_dimC;
-    }
+
+    m_dimR = xx_matrix.m_dimR;
+    m_dimC = xx_matrix.m_dimC;
     m_data = std::move(xx_matrix.m_data);
+    xx_matrix.m_dimR = 0;
+    xx_matrix.m_dimC = 0;
     return *this;
 }
 
-/* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
-
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator+(matrix const & xx_matrix) const
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, matrix_kind, tpDataType>::value>::type*>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> &
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator=(tpExpression && xx_expression)
 {
-    if (m_dimC != xx_matrix.m_dimC && m_dimR != xx_matrix.m_dimR)
-        throw std::domain_error("Matrices should have same dimension");
-
-    auto result = *this;
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            result.m_data(R, C) += xx_matrix.m_data(R, C);
-        }
+    if (m_dimR == xx_expression.dimR() && m_dimC == xx_expression.dimC() && !detail::aliases(xx_expression, detail::layout_of(*this))) {
+        detail::evaluate(data(), xx_expression);
+        return *this;
     }
-    return result;
+
+    // the expression may refer to this matrix (Ex: m = transpose(m)); evaluate before releasing the old storage
+    return (*this) = detail::materialize<matrix>(std::forward<tpExpression>(xx_expression));
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator+(assignment::vector<tpDataType> const & xx_vector) const
+/* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator+(assignment::vector<tpDataType, tpAllocatorType> const & xx_vector) const &
 {
     auto result = *this;
-    tpDataType temp;
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            if (R > xx_vector.dim())
-                temp = static_cast<tpDataType>(0.0);
-            else
-                temp = xx_vector[R];
-            result.m_data(R, C) += temp;
-        }
-    }
-    return result;
+    return std::move(result) + xx_vector;
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator-(matrix const & xx_matrix) const
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator+(assignment::vector<tpDataType, tpAllocatorType> const & xx_vector) &&
 {
-    if (m_dimC != xx_matrix.m_dimC && m_dimR != xx_matrix.m_dimR)
-        throw std::domain_error("Matrices should have same dimension");
-
-    auto result = *this;
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            result.m_data(R, C) -= xx_matrix.m_data(R, C);
-        }
+    for (size_type R = 0; R < m_dimR && R < xx_vector.dim(); ++R) {
+        detail::simd::broadcast<detail::simd::op::add>(&m_data(R, 0), &m_data(R, 0), xx_vector[R], m_dimC);
     }
-    return result;
+    return std::move(*this);
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator*(matrix const & xx_matrix) const
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator*(matrix const & xx_matrix) const
 {
     if (m_dimC != xx_matrix.m_dimR)
         throw std::domain_error("Number of columns_A != Number of rows_B");
 
-    matrix<tpDataType, tpPolicyType> result(m_dimR, xx_matrix.m_dimC);
+    matrix<tpDataType, tpPolicyType, tpAllocatorType> result(m_dimR, xx_matrix.m_dimC);
     tpPolicyType<matrix>::matrix_multiply(&result, this, &xx_matrix);
 
     return result;
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator+(tpDataType const & xx_scalar) const
-{
-    auto result = *this;
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            result.m_data(R, C) += xx_scalar;
-        }
-    }
-    return result;
-}
-
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator-(tpDataType const & xx_scalar) const
-{
-    auto result = *this;
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            result.m_data(R, C) -= xx_scalar;
-        }
-    }
-    return result;
-}
-
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator*(tpDataType const xx_scalar) const
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::are_compatible<matrix<tpDataType, tpPolicyType, tpAllocatorType>, tpExpression>::value>::type*>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> &
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator+=(tpExpression const & xx_expression)
 {
-    auto result = *this;
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            result.m_data(R, C) *= xx_scalar;
-        }
-    }
-    return result;
-}
-
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> &
-assignment::matrix<tpDataType, tpPolicyType>::operator+=(matrix const & xx_matrix)
-{
-    if (m_dimC != xx_matrix.dimR())
-        throw std::domain_error("Number of columns_A != Number of rows_B");
-
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            m_data(R, C) += xx_matrix.m_data(R, C);
+    // a view on this matrix in another layout (Ex: m += transpose(m)) is evaluated first
+    if constexpr (detail::has_view<tpExpression>::value) {
+        if (detail::aliases(xx_expression, detail::layout_of(*this))) {
+            matrix const temp = xx_expression;
+            detail::evaluate(data(), (*this) + temp);
+            return (*this);
         }
     }
+    detail::evaluate(data(), (*this) + xx_expression);
     return (*this);
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> &
-assignment::matrix<tpDataType, tpPolicyType>::operator-=(matrix const & xx_matrix)
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::are_compatible<matrix<tpDataType, tpPolicyType, tpAllocatorType>, tpExpression>::value>::type*>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> &
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator-=(tpExpression const & xx_expression)
 {
-    if (m_dimC != xx_matrix.dimR())
-        throw std::domain_error("Number of columns_A != Number of rows_B");
-
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            m_data(R, C) -= xx_matrix.m_data(R, C);
+    // a view on this matrix in another layout (Ex: m += transpose(m)) is evaluated first
+    if constexpr (detail::has_view<tpExpression>::value) {
+        if (detail::aliases(xx_expression, detail::layout_of(*this))) {
+            matrix const temp = xx_expression;
+            detail::evaluate(data(), (*this) - temp);
+            return (*this);
         }
     }
+    detail::evaluate(data(), (*this) - xx_expression);
     return (*this);
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> &
-assignment::matrix<tpDataType, tpPolicyType>::operator*=(matrix const & xx_matrix)
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> &
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator*=(matrix const & xx_matrix)
 {
     if (m_dimC != m_dimR || xx_matrix.m_dimC != xx_matrix.m_dimR)
         throw std::domain_error("matrix_B should be the same size as matrix_A");
@@ -526,64 +730,49 @@ assignment::matrix<tpDataType, tpPolicyType>::operator*=(matrix const & xx_matri
     return (*this);
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-template<typename TDummy, typename std::enable_if<!std::is_integral<TDummy>::value>::type*>
-matrix<tpDataType, tpPolicyType> assignment::matrix<tpDataType, tpPolicyType>::operator *(size_type const xx_scalar) const
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType> assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator*(assignment::vector<tpDataType, tpAllocatorType> const & xx_col_vector) const
 {
-    auto result = *this;
-    for (size_type R = 0; R < m_dimR; ++R) {
-        for (size_type C = 0; C < m_dimC; ++C) {
-            result.m_data(R, C) *= static_cast<tpDataType>(xx_scalar);
-        }
-    }
-    return result;
-}
+    if (m_dimC != xx_col_vector.dim())
+        throw std::domain_error("Number of columns_A != dimension of vector");
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::vector<tpDataType> assignment::matrix<tpDataType, tpPolicyType>::operator*(assignment::vector<tpDataType> const & xx_col_vector) const
-{
-    auto result = assignment::vector<tpDataType>(m_dimR);
-    for (size_type R = 0; R < m_dimR; ++R) {
-        result[R] = static_cast<tpDataType>(0);
-        for (size_type C = 0; C < m_dimC; ++C) {
-            result[R] += (*this)(R, C) * xx_col_vector[C];
-        }
-    }
+    auto result = assignment::vector<tpDataType, tpAllocatorType>(m_dimR);
+    tpPolicyType<matrix>::vector_multiply(m_dimR, m_dimC, data(), m_dimC, 1, xx_col_vector.data(), 1, result.data());
     return result;
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
 tpDataType const &
-assignment::matrix<tpDataType, tpPolicyType>::operator()(size_type dimR, size_type dimC) const
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator()(size_type dimR, size_type dimC) const
 {
     return m_data(dimR, dimC);
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
 tpDataType &
-assignment::matrix<tpDataType, tpPolicyType>::operator()(size_type dimR, size_type dimC)
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::operator()(size_type dimR, size_type dimC)
 {
     return m_data(dimR, dimC);
 }
 
 /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s  ==== */
 
-template<typename tpDataType, template<typename > class tpPolicyType>
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
 std::size_t const &
-assignment::matrix<tpDataType, tpPolicyType>::dimR() const
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::dimR() const
 {
     return m_dimR;
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
 std::size_t const &
-assignment::matrix<tpDataType, tpPolicyType>::dimC() const
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::dimC() const
 {
     return m_dimC;
 }
 
-template<typename tpDataType, template<typename > class tpPolicyType>
-void assignment::matrix<tpDataType, tpPolicyType>::set(tpDataType const & xx_value)
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+void assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::set(tpDataType const & xx_value)
 {
     for (size_type R = 0; R < m_dimR; ++R) {
         for (size_type C = 0; C < m_dimC; ++C) {
@@ -592,6 +781,20 @@ void assignment::matrix<tpDataType, tpPolicyType>::set(tpDataType const & xx_val
     }
 }
 
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+tpDataType const *
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::data() const
+{
+    return m_data.m_data.get();
+}
+
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+tpDataType *
+assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>::data()
+{
+    return m_data.m_data.get();
+}
+
 }
 
 #endif /* matrix_h */
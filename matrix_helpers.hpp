@@ -11,58 +11,167 @@
 namespace assignment {
 /* ==== f  r  e  e     o  p  e  r  a  t  o  r  s ==== */
 
-/*! left scalar multiply operator
+/*! left scalar multiply operator => lazy element-wise multiplication
 */
-template<typename tpDataType, template<typename > class tpPolicyType>
-assignment::matrix<tpDataType, tpPolicyType> operator *(tpDataType const xx_scalar, matrix<tpDataType, tpPolicyType> const & xx_matrix)
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+scalar_expression<detail::simd::op::mul, detail::operand_t<tpExpression>> operator *(typename detail::traits<tpExpression>::value_type const & xx_scalar, tpExpression && xx_matrix)
 {
-    auto result = xx_matrix;
-    for (std::size_t R = 0; R < xx_matrix.dimR(); ++R) {
-        for (std::size_t C = 0; C < xx_matrix.dimC(); ++C) {
-            result(R, C) *= xx_scalar;
-        }
-    }
-    return result;
+    return {std::forward<tpExpression>(xx_matrix), xx_scalar};
 }
 
 /*! left scalar multiply operator  => disabled for integrals
 */
-template<typename tpDataType, template<typename > class tpPolicyType, typename std::enable_if<!std::is_integral<tpDataType>::value>::type* = nullptr>
-matrix<tpDataType, tpPolicyType> operator *(std::size_t const xx_scalar, matrix<tpDataType, tpPolicyType> const & xx_matrix)
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value
+                && !std::is_integral<typename detail::traits<tpExpression>::value_type>::value>::type* = nullptr>
+scalar_expression<detail::simd::op::mul, detail::operand_t<tpExpression>> operator *(std::size_t const xx_scalar, tpExpression && xx_matrix)
 {
-    auto result = xx_matrix;
-    for (std::size_t R = 0; R < xx_matrix.dimR(); ++R) {
-        for (std::size_t C = 0; C < xx_matrix.dimC(); ++C) {
-            result(R, C) *= xx_scalar;
-        }
+    return {std::forward<tpExpression>(xx_matrix), static_cast<typename detail::traits<tpExpression>::value_type>(xx_scalar)};
+}
+
+/*!  negation operator => lazy
+*/
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+negate_expression<detail::operand_t<tpExpression>> operator -(tpExpression && xx_matrix)
+{
+    return negate_expression<detail::operand_t<tpExpression>>(std::forward<tpExpression>(xx_matrix));
+}
+
+/*! policy matrix multiplication where either operand is an element-wise expression
+ \note the expression is evaluated into a temporary first; matrix * matrix is a member of the matrix class
+ \throw std::domain_error if Number of columns_A != Number of rows_B
+*/
+template<typename tpLeft, typename tpRight, typename std::enable_if<detail::are_compatible<tpLeft, tpRight>::value
+                && detail::is_kind<tpLeft, matrix_kind>::value && (detail::is_node<tpLeft>::value || detail::is_node<tpRight>::value)>::type* = nullptr>
+typename detail::traits<tpLeft>::result_type operator *(tpLeft const & xx_left, tpRight const & xx_right)
+{
+    typename detail::traits<tpLeft>::result_type const & left = xx_left;
+    typename detail::traits<tpLeft>::result_type const & right = xx_right;
+    return left * right;
+}
+
+/*! matrix-vector multiplication where the matrix is an element-wise expression
+ \note the expression is evaluated into a temporary first; views are multiplied in place, see view.hpp
+*/
+template<typename tpLeft, typename std::enable_if<detail::is_node<tpLeft>::value && detail::is_kind<tpLeft, matrix_kind>::value>::type* = nullptr>
+assignment::vector<typename detail::traits<tpLeft>::value_type, typename detail::traits<tpLeft>::result_type::allocator_type>
+operator *(tpLeft const & xx_left, assignment::vector<typename detail::traits<tpLeft>::value_type, typename detail::traits<tpLeft>::result_type::allocator_type> const & xx_col_vector)
+{
+    typename detail::traits<tpLeft>::result_type const left = xx_left;
+    return left * xx_col_vector;
+}
+
+/*! batched matrix-vector multiplication: the j-th result is xx_matrix * xx_vectors[j]
+ \note every block of rows of the matrix is multiplied with all vectors while it is in cache, so the matrix is streamed from
+ memory once for the whole batch rather than once per vector. The results are identical to separate products.
+ \throw std::domain_error if Number of columns_A != dimension of any of the vectors
+*/
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+std::vector<assignment::vector<tpDataType, tpAllocatorType>>
+multiply(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix, std::vector<assignment::vector<tpDataType, tpAllocatorType>> const & xx_vectors)
+{
+    std::vector<tpDataType const *> vectors;
+    std::vector<tpDataType *> results;
+    std::vector<assignment::vector<tpDataType, tpAllocatorType>> products;
+    vectors.reserve(xx_vectors.size());
+    results.reserve(xx_vectors.size());
+    products.reserve(xx_vectors.size());
+    for (auto const & vector : xx_vectors) {
+        if (vector.dim() != xx_matrix.dimC())
+            throw std::domain_error("Number of columns_A != dimension of vector");
+        products.emplace_back(xx_matrix.dimR());
+        vectors.push_back(vector.data());
+        results.push_back(products.back().data());
     }
+
+    tpPolicyType<matrix<tpDataType, tpPolicyType, tpAllocatorType>>::batch_multiply(xx_matrix.dimR(), xx_matrix.dimC(),
+                    xx_matrix.data(), static_cast<std::ptrdiff_t>(xx_matrix.dimC()), 1,
+                    xx_vectors.size(), vectors.data(), results.data());
+    return products;
+}
+
+/*! quantized matrix multiplication: 8 or 16 bit operands, summed in 32 bits
+ \tparam tpResultType std::int32_t, given explicitly (Ex: multiply<std::int32_t>(A, B))
+ \note runs on the integer kernel, which adds pairs of products in one instruction (VNNI where available); under Parallel the
+ columns are split over the thread pool. Sums wrap modulo 2^32 and are exact only while the sum of |A(i, k) * B(k, j)| over k
+ stays below 2^31: int8_t operands cannot reach it below K = 2^17, but full-range int16_t operands can from K = 2
+ (2 * 32768^2 = 2^31), so int16_t inputs must be scaled to keep that sum in range.
+ \throw std::domain_error if Number of columns_A != Number of rows_B
+*/
+template<typename tpResultType, typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType,
+                typename std::enable_if<std::is_same<tpResultType, std::int32_t>::value && detail::is_igemm_input<tpDataType>::value>::type* = nullptr>
+matrix<tpResultType, tpPolicyType> multiply(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_left,
+                                            matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_right)
+{
+    if (xx_left.dimC() != xx_right.dimR())
+        throw std::domain_error("Number of columns_A != Number of rows_B");
+
+    constexpr std::size_t NR = detail::igemm_blocking::NR;
+    matrix<tpResultType, tpPolicyType> result(xx_left.dimR(), xx_right.dimC());
+    tpResultType * const C = result.data();
+    std::size_t const N = result.dimC();
+    detail::igemm<tpPolicyType<matrix<tpDataType, tpPolicyType, tpAllocatorType>>::is_parallel>(
+                    xx_left.dimR(), N, xx_left.dimC(), xx_left.data(), xx_right.data(),
+                    [&](std::size_t const xx_i, std::size_t const xx_j, std::int32_t const * xx_tile, std::size_t const xx_mr, std::size_t const xx_nr) {
+                        for (std::size_t r = 0; r < xx_mr; ++r)
+                            std::copy_n(xx_tile + r * NR, xx_nr, C + (xx_i + r) * N + xx_j);
+                    });
     return result;
 }
 
-/*!  negation operator
+/*! quantized matrix multiplication with requantization: result(i, j) = (A * B)(i, j) * xx_row_scales[i] * xx_col_scales[j]
+ \tparam tpResultType element type of the result (Ex: std::int8_t for the next quantized layer, float to dequantize); integer
+ results are rounded to nearest and saturated
+ \note the 32 bit sums are scaled in float as each tile of the product is finished, so no 32 bit matrix is stored; they wrap
+ under the same bound as multiply<std::int32_t>, which int16_t operands reach from K = 2 at full range.
+ \throw std::domain_error if Number of columns_A != Number of rows_B or the scales do not match the dimensions of the result
 */
-template<typename tpDataType, template<typename > class tpPolicyType>
-matrix<tpDataType, tpPolicyType> operator -(matrix<tpDataType, tpPolicyType> const & xx_matrix)
+template<typename tpResultType, typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType,
+                typename std::enable_if<detail::is_igemm_input<tpDataType>::value>::type* = nullptr>
+matrix<tpResultType, tpPolicyType> multiply(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_left,
+                                            matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_right,
+                                            std::vector<float> const & xx_row_scales, std::vector<float> const & xx_col_scales)
 {
-    auto result = xx_matrix;
-    for (std::size_t R = 0; R < xx_matrix.dimR(); ++R) {
-        for (std::size_t C = 0; C < xx_matrix.dimC(); ++C) {
-            result(R, C) = -xx_matrix(R, C);
-        }
-    }
+    if (xx_left.dimC() != xx_right.dimR())
+        throw std::domain_error("Number of columns_A != Number of rows_B");
+    if (xx_row_scales.size() != xx_left.dimR() || xx_col_scales.size() != xx_right.dimC())
+        throw std::domain_error("Number of scales != dimensions of the result");
+
+    constexpr std::size_t NR = detail::igemm_blocking::NR;
+    matrix<tpResultType, tpPolicyType> result(xx_left.dimR(), xx_right.dimC());
+    tpResultType * const C = result.data();
+    std::size_t const N = result.dimC();
+    detail::igemm<tpPolicyType<matrix<tpDataType, tpPolicyType, tpAllocatorType>>::is_parallel>(
+                    xx_left.dimR(), N, xx_left.dimC(), xx_left.data(), xx_right.data(),
+                    [&](std::size_t const xx_i, std::size_t const xx_j, std::int32_t const * xx_tile, std::size_t const xx_mr, std::size_t const xx_nr) {
+                        for (std::size_t r = 0; r < xx_mr; ++r) {
+                            float const row_scale = xx_row_scales[xx_i + r];
+                            for (std::size_t c = 0; c < xx_nr; ++c)
+                                C[(xx_i + r) * N + xx_j + c] = detail::igemm_requantize<tpResultType>(xx_tile[r * NR + c], row_scale * xx_col_scales[xx_j + c]);
+                        }
+                    });
     return result;
 }
 
+/*! addition of a column vector where the matrix is an element-wise expression or a view
+*/
+template<typename tpLeft, typename std::enable_if<(detail::is_node<tpLeft>::value || detail::is_view<tpLeft>::value) && detail::is_kind<tpLeft, matrix_kind>::value>::type* = nullptr>
+typename detail::traits<tpLeft>::result_type
+operator +(tpLeft const & xx_left, assignment::vector<typename detail::traits<tpLeft>::value_type, typename detail::traits<tpLeft>::result_type::allocator_type> const & xx_col_vector)
+{
+    typename detail::traits<tpLeft>::result_type left = xx_left;
+    return std::move(left) + xx_col_vector;
+}
+
 /*! casting vector to matrix
  \note either one of dimR or dimC should be 1
  \throw std::domain error
 */
-template<typename tpDataType, template<typename > class tpPolicyType = assignment::NonParallel>
-matrix<tpDataType, tpPolicyType> cast_V2M(assignment::vector<tpDataType> const & xx_vector, int dimR, int dimC)
+template<typename tpDataType, template<typename > class tpPolicyType = assignment::NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> cast_V2M(assignment::vector<tpDataType, tpAllocatorType> const & xx_vector, int dimR, int dimC)
 {
     if (dimR > 1 && dimC > 1)
         throw std::domain_error("Either dimR or dimC should be 1");
-    auto temp_mat = assignment::matrix<tpDataType, tpPolicyType>(dimR, dimC);
+    auto temp_mat = assignment::matrix<tpDataType, tpPolicyType, tpAllocatorType>(dimR, dimC);
     
     for (std::size_t R = 0; R < temp_mat.dimR(); ++R) {
         for (std::size_t C = 0; C < temp_mat.dimC(); ++C) {
@@ -75,13 +184,13 @@ matrix<tpDataType, tpPolicyType> cast_V2M(assignment::vector<tpDataType> const &
 /*! casting matrix to vector
  \throw std::domain error if matrix is neither row or coloumn matrix
 */
-template<typename tpDataType, template<typename > class tpPolicyType = assignment::NonParallel>
-assignment::vector<tpDataType> cast_M2V(matrix<tpDataType, tpPolicyType> const & xx_matrix)
+template<typename tpDataType, template<typename > class tpPolicyType = assignment::NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+assignment::vector<tpDataType, tpAllocatorType> cast_M2V(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix)
 {
     if (xx_matrix.dimR() > 1 && xx_matrix.dimC() > 1)
         throw std::domain_error("Either dimR or dimC should be 1");
 
-    auto temp_mat = assignment::vector < tpDataType > (std::max(xx_matrix.dimC(), xx_matrix.dimR()));
+    auto temp_mat = assignment::vector<tpDataType, tpAllocatorType>(std::max(xx_matrix.dimC(), xx_matrix.dimR()));
     for (std::size_t R = 0; R < xx_matrix.dimR(); ++R) {
         for (std::size_t C = 0; C < xx_matrix.dimC(); ++C) {
             temp_mat[std::max(R, C)] = xx_matrix(R, C);
@@ -90,19 +199,19 @@ assignment::vector<tpDataType> cast_M2V(matrix<tpDataType, tpPolicyType> const &
     return temp_mat;
 }
 
-/*! output matrix to std::cout
+/*! output matrix or matrix expression to std::cout
  \throw std::domain error
 */
-template<typename tpDataType, template<typename > class tpPolicyType>
-std::ostream& operator<<(std::ostream& os, assignment::matrix<tpDataType, tpPolicyType> const & xx_matrix)
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+std::ostream& operator<<(std::ostream& os, tpExpression const & xx_matrix)
 {   
     os << '[';
-    for (int R = 0; R < xx_matrix.dimR(); ++R) {
+    for (std::size_t R = 0; R < xx_matrix.dimR(); ++R) {
         if (R > 0)
-            os << ',' << std::endl << " ";
+            os << ",\n ";
 
-        for (int C = 0; C < xx_matrix.dimC(); ++C)
-            os << xx_matrix(R, C) << " ";
+        for (std::size_t C = 0; C < xx_matrix.dimC(); ++C)
+            os << detail::element_at(xx_matrix, R * xx_matrix.dimC() + C) << " ";
     }
     os << ']';
     return os;
@@ -0,0 +1,212 @@
+/*
+ //  out_of_core.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the out-of-core matrix product: C = A * B for matrices kept in tiled binary files, which need not
+ fit into the memory. Tiles are read and written on one background thread while the multiply policy works on the tiles
+ in memory, and the tiles held at once stay within a memory budget given by the caller.
+ */
+#ifndef out_of_core_h
+#define out_of_core_h
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "binary.hpp"
+#include "matrix.hpp"
+#include "simd.hpp"
+
+namespace assignment {
+namespace detail {
+
+/*! one background thread running the file transfers of the out-of-core product, in the order they are submitted
+ \note the destructor runs the transfers still queued before it joins the thread, so the tiles they use must outlive it.
+ */
+class io_worker {
+public:
+
+    io_worker() :
+                    m_stop(false),
+                    m_thread([this]() { run(); })
+    {
+    }
+
+    io_worker(io_worker const &) = delete;
+    io_worker & operator=(io_worker const &) = delete;
+
+    ~io_worker()
+    {
+        {
+            std::lock_guard<std::mutex> const lock(m_mutex);
+            m_stop = true;
+        }
+        m_ready.notify_one();
+        m_thread.join();
+    }
+
+    /*! queues xx_function; the future is ready, or holds its exception, once it has run
+     */
+    template<typename tpFunction>
+    std::future<void> submit(tpFunction xx_function)
+    {
+        std::packaged_task<void()> task(std::move(xx_function));
+        std::future<void> result = task.get_future();
+        {
+            std::lock_guard<std::mutex> const lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_ready.notify_one();
+        return result;
+    }
+
+private:
+
+    void run()
+    {
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_ready.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                    return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<std::packaged_task<void()>> m_tasks;
+    bool m_stop;
+
+    /*! started last, once the queue it works on exists
+     */
+    std::thread m_thread;
+};
+
+} // namespace detail
+
+/*! C = A * B for the tiled binary files xx_left (A) and xx_right (B), written to the tiled file xx_result (C)
+ \tparam tpDataType element type
+ \tparam tpPolicyType multiply policy for the products of two tiles
+ \param xx_budget bytes of tiles held in memory at once
+ \note the tiles of C are computed row by row, each as the sum of A(I, k) * B(k, J) over k. The next pair of tiles is
+       read by the I/O thread while the current one is multiplied, and a finished tile of C is written while the next one is computed, so
+       2 tiles of A, 2 of B and 3 of C are held at once. If the budget holds a whole tile row of A and one more tile, the
+       tiles of A are kept for the tile row of C and read once instead of once per tile column. The packing buffers of
+       the multiply policy are not counted.
+ \note C has the tile rows of A and the tile columns of B; an existing xx_result is overwritten.
+ \throw std::domain_error if the dimensions of A and B do not match, the tile columns of A differ from the tile rows of
+        B, or the budget is smaller than the tiles in flight; std::system_error and std::runtime_error from the files
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+void multiply_out_of_core(std::string const & xx_left, std::string const & xx_right, std::string const & xx_result, std::size_t const xx_budget)
+{
+    using policy = tpPolicyType<matrix<tpDataType, tpPolicyType>>;
+
+    tiled_file<tpDataType> const left(xx_left);
+    tiled_file<tpDataType> const right(xx_right);
+    if (left.dimC() != right.dimR())
+        throw std::domain_error("Matrices should have compatible dimensions");
+    if (left.tileC() != right.tileR())
+        throw std::domain_error("Tile columns of the left matrix should match the tile rows of the right matrix");
+
+    std::size_t const sizeA = left.tileR() * left.tileC();
+    std::size_t const sizeB = right.tileR() * right.tileC();
+    std::size_t const sizeC = left.tileR() * right.tileC();
+    std::size_t const streamed = (2 * sizeA + 2 * sizeB + 3 * sizeC) * sizeof(tpDataType);
+    if (xx_budget < streamed)
+        throw std::domain_error("Memory budget is smaller than the tiles in flight");
+
+    tiled_file<tpDataType> const result(xx_result, left.dimR(), right.dimC(), left.tileR(), right.tileC());
+    std::size_t const tilesI = left.tilesR();
+    std::size_t const tilesJ = right.tilesC();
+    std::size_t const tilesK = left.tilesC();
+    std::size_t const steps = tilesI * tilesJ * tilesK;
+    if (steps == 0)
+        return; // C is empty or, for an empty inner dimension, all zeros already
+
+    // a ring of tilesK + 1 slots keeps the tile row of A while the first tile of the next row is read
+    bool const keep = tilesJ > 1 && (xx_budget - streamed) / (sizeA * sizeof(tpDataType)) >= tilesK - 1;
+    std::size_t const slotsA = keep ? tilesK + 1 : 2;
+    auto const slot_left = [&](std::size_t const s) {
+        return keep ? (s / (tilesJ * tilesK) * tilesK + s % tilesK) % slotsA : s % 2;
+    };
+
+    std::vector<tpDataType> tilesA(slotsA * sizeA);
+    std::vector<tpDataType> tilesB(2 * sizeB);
+    std::vector<tpDataType> tilesC(3 * sizeC); // two accumulators, one of them possibly being written, and a product
+
+    auto const load = [&](std::size_t const s) {
+        std::size_t const I = s / (tilesJ * tilesK);
+        std::size_t const J = s / tilesK % tilesJ;
+        std::size_t const k = s % tilesK;
+        if (!keep || J == 0)
+            left.read_tile(I, k, tilesA.data() + slot_left(s) * sizeA);
+        right.read_tile(k, J, tilesB.data() + s % 2 * sizeB);
+    };
+
+    // declared after the tiles: if a product throws, the worker finishes the queued transfers before the tiles go away
+    detail::io_worker io;
+    std::future<void> written[2];
+    std::future<void> next = io.submit([&load]() { load(0); });
+    tpDataType * const product = tilesC.data() + 2 * sizeC;
+    std::size_t const tileK = left.tileC();
+    std::size_t const tileN = right.tileC();
+    for (std::size_t s = 0, tile = 0; s < steps; ++s) {
+        next.get();
+        if (s + 1 < steps)
+            next = io.submit([&load, s]() { load(s + 1); });
+
+        std::size_t const I = s / (tilesJ * tilesK);
+        std::size_t const J = s / tilesK % tilesJ;
+        std::size_t const k = s % tilesK;
+        std::size_t const M = left.rows(I);
+        std::size_t const N = right.cols(J);
+        tpDataType const * const A = tilesA.data() + slot_left(s) * sizeA;
+        tpDataType const * const B = tilesB.data() + s % 2 * sizeB;
+        tpDataType * const sum = tilesC.data() + tile % 2 * sizeC;
+
+        if (k == 0) {
+            if (written[tile % 2].valid())
+                written[tile % 2].get();
+            // the padding of an edge tile is written to the file as well; clear what a full tile left there
+            if (M < left.tileR() || N < tileN)
+                std::fill(sum, sum + sizeC, tpDataType(0));
+            policy::multiply(M, N, left.cols(k), A, static_cast<std::ptrdiff_t>(tileK), 1,
+                             B, static_cast<std::ptrdiff_t>(tileN), 1, sum, static_cast<std::ptrdiff_t>(tileN));
+        } else {
+            policy::multiply(M, N, left.cols(k), A, static_cast<std::ptrdiff_t>(tileK), 1,
+                             B, static_cast<std::ptrdiff_t>(tileN), 1, product, static_cast<std::ptrdiff_t>(tileN));
+            for (std::size_t r = 0; r < M; ++r)
+                detail::simd::binary<detail::simd::op::add>(sum + r * tileN, sum + r * tileN, product + r * tileN, N);
+        }
+
+        if (k + 1 == tilesK) {
+            written[tile % 2] = io.submit([&result, sum, I, J]() { result.write_tile(I, J, sum); });
+            ++tile;
+        }
+    }
+    for (std::future<void> & pending : written) {
+        if (pending.valid())
+            pending.get();
+    }
+}
+
+}
+#endif /* out_of_core_h */
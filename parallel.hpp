@@ -0,0 +1,427 @@
+/*
+ //  parallel.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the thread pool shared by all parallel operations and the helpers the parallel policies use to
+ spread work over it. The workers are started on first use and kept for the life of the pool; each has a deque of tasks,
+ taking the newest task from its own deque and stealing the oldest, largest task from the others when it runs dry.
+ */
+#ifndef parallel_h
+#define parallel_h
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace assignment {
+namespace detail {
+
+/*! number of hardware threads available to the process
+ \note falls back to 1 if the implementation cannot tell
+ */
+inline std::size_t hardware_threads()
+{
+    auto const threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+} // namespace detail
+
+/*! pool of persistent worker threads with work-stealing deques
+ \note the parallel kernels run on thread_pool::current(): the global() pool unless the calling thread installs another
+       one with a thread_pool::scope. The thread calling parallel_for() works on the loop as well, so a pool of n threads
+       has n - 1 workers.
+ */
+class thread_pool {
+public:
+
+    /*! installs a pool for the parallel kernels called on this thread until the scope ends
+     */
+    class scope {
+    public:
+
+        explicit scope(thread_pool & xx_pool) :
+                        m_previous(installed())
+        {
+            installed() = &xx_pool;
+        }
+
+        scope(scope const &) = delete;
+        scope & operator=(scope const &) = delete;
+
+        ~scope()
+        {
+            installed() = m_previous;
+        }
+
+    private:
+
+        thread_pool * m_previous;
+    };
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor; no thread is started before the first parallel loop
+     \param xx_threads threads working on a loop, the caller included; 0 for one per hardware thread
+     */
+    explicit thread_pool(std::size_t const xx_threads = 0) :
+                    m_threads(xx_threads == 0 ? detail::hardware_threads() : xx_threads)
+    {
+    }
+
+    thread_pool(thread_pool const &) = delete;
+    thread_pool & operator=(thread_pool const &) = delete;
+
+    ~thread_pool()
+    {
+        stop();
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! pool used by the parallel kernels when the caller did not install another one
+     \note sized to the hardware threads; set_threads() changes it for the whole program.
+     */
+    static thread_pool & global()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    /*! pool the parallel kernels called on this thread run on: the one installed by the innermost scope, else the pool
+     the thread works for, else global()
+     */
+    static thread_pool & current()
+    {
+        if (installed() != nullptr)
+            return *installed();
+        if (worker().pool != nullptr)
+            return *worker().pool;
+        return global();
+    }
+
+    /*! threads working on a loop, the caller included
+     */
+    std::size_t threads() const
+    {
+        return m_threads.load(std::memory_order_relaxed);
+    }
+
+    /*! changes the number of threads working on a loop; 0 for one per hardware thread
+     \note stops the running workers, the next loop starts the new ones. Must not be called while the pool runs a loop.
+     */
+    void set_threads(std::size_t const xx_threads)
+    {
+        stop();
+        m_threads.store(xx_threads == 0 ? detail::hardware_threads() : xx_threads, std::memory_order_relaxed);
+    }
+
+    /*! runs xx_function(begin, end) over subranges of [xx_first, xx_last) of at most xx_grain indices on all threads
+     \note a range is halved while it is longer than xx_grain, and the halves are left for idle threads to steal, so
+           uneven work is balanced without cutting the loop into more tasks than needed.
+     \throw the first exception thrown by xx_function; the subranges not started yet are skipped
+     */
+    template<typename tpFunction>
+    void parallel_for(std::size_t const xx_first, std::size_t const xx_last, std::size_t const xx_grain, tpFunction const & xx_function)
+    {
+        if (xx_last <= xx_first)
+            return;
+        std::size_t const grain = std::max<std::size_t>(xx_grain, 1);
+        std::size_t const chunks = (xx_last - xx_first + grain - 1) / grain;
+        if (threads() <= 1 || chunks <= 1) {
+            for (std::size_t begin = xx_first; begin < xx_last; begin += std::min(grain, xx_last - begin))
+                xx_function(begin, std::min(begin + grain, xx_last));
+            return;
+        }
+
+        start();
+        job work(&invoke<tpFunction>, &xx_function, grain, xx_last - xx_first);
+
+        // one piece per thread; the queue of this thread gets the first one
+        std::size_t const self = slot();
+        std::size_t const pieces = std::min(chunks, m_queues.size());
+        for (std::size_t p = pieces; p-- > 0; ) {
+            std::size_t const begin = xx_first + chunks * p / pieces * grain;
+            std::size_t const end = std::min(xx_first + chunks * (p + 1) / pieces * grain, xx_last);
+            push((self + p) % m_queues.size(), task{&work, begin, end});
+        }
+
+        while (run_one(self)) {
+            if (work.finished())
+                break;
+        }
+        work.wait();
+        if (work.error)
+            std::rethrow_exception(work.error);
+    }
+
+    /*! runs xx_function(beginR, endR, beginC, endC) over the xx_grainR x xx_grainC tiles of an xx_dimR x xx_dimC index space
+     \note the tiles are numbered row by row and handed out one at a time, see parallel_for().
+     */
+    template<typename tpFunction>
+    void parallel_for_2d(std::size_t const xx_dimR, std::size_t const xx_dimC, std::size_t const xx_grainR, std::size_t const xx_grainC,
+                         tpFunction const & xx_function)
+    {
+        std::size_t const grainR = std::max<std::size_t>(xx_grainR, 1);
+        std::size_t const grainC = std::max<std::size_t>(xx_grainC, 1);
+        std::size_t const tilesC = (xx_dimC + grainC - 1) / grainC;
+        std::size_t const tiles = (xx_dimR + grainR - 1) / grainR * tilesC;
+        parallel_for(0, tiles, 1, [&](std::size_t const xx_begin, std::size_t const xx_end) {
+            for (std::size_t t = xx_begin; t < xx_end; ++t) {
+                std::size_t const beginR = t / tilesC * grainR;
+                std::size_t const beginC = t % tilesC * grainC;
+                xx_function(beginR, std::min(beginR + grainR, xx_dimR), beginC, std::min(beginC + grainC, xx_dimC));
+            }
+        });
+    }
+
+private:
+
+    /*! a parallel loop; lives on the stack of the thread that started it until all its indices are done
+     */
+    struct job {
+
+        job(void (*xx_call)(void const *, std::size_t, std::size_t), void const * xx_function, std::size_t const xx_grain, std::size_t const xx_count) :
+                        call(xx_call),
+                        function(xx_function),
+                        grain(xx_grain),
+                        remaining(xx_count)
+        {
+        }
+
+        bool finished()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return remaining == 0;
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]() { return remaining == 0; });
+        }
+
+        /*! counts xx_count indices as done; the last one wakes the starting thread
+         \note the lock is held while notifying, so the job cannot go away before this returns.
+         */
+        void complete(std::size_t const xx_count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            remaining -= xx_count;
+            if (remaining == 0)
+                done.notify_all();
+        }
+
+        void (*call)(void const *, std::size_t, std::size_t);
+        void const * function;
+        std::size_t grain;
+        std::size_t remaining;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    struct task {
+        job * owner;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    /*! pool and queue of the calling thread if it is a worker
+     */
+    struct identity {
+        thread_pool * pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    static thread_pool * & installed()
+    {
+        thread_local thread_pool * pool = nullptr;
+        return pool;
+    }
+
+    static identity & worker()
+    {
+        thread_local identity self;
+        return self;
+    }
+
+    template<typename tpFunction>
+    static void invoke(void const * xx_function, std::size_t const xx_begin, std::size_t const xx_end)
+    {
+        (*static_cast<tpFunction const *>(xx_function))(xx_begin, xx_end);
+    }
+
+    /*! queue of the calling thread: its own for a worker, the last one, shared by all other threads, otherwise
+     */
+    std::size_t slot() const
+    {
+        return worker().pool == this ? worker().index : m_queues.size() - 1;
+    }
+
+    void start()
+    {
+        if (m_started.load(std::memory_order_acquire))
+            return;
+        std::lock_guard<std::mutex> lock(m_start);
+        if (m_started.load(std::memory_order_relaxed))
+            return;
+        std::size_t const workers = threads() - 1;
+        m_stop = false;
+        m_queues.clear();
+        for (std::size_t q = 0; q <= workers; ++q)
+            m_queues.push_back(std::make_unique<queue>());
+        for (std::size_t w = 0; w < workers; ++w)
+            m_workers.emplace_back([this, w]() { work(w); });
+        m_started.store(true, std::memory_order_release);
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(m_start);
+        {
+            std::lock_guard<std::mutex> sleep(m_sleep);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto & thread : m_workers)
+            thread.join();
+        m_workers.clear();
+        m_started.store(false, std::memory_order_release);
+    }
+
+    void push(std::size_t const xx_queue, task const & xx_task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queues[xx_queue]->mutex);
+            m_queues[xx_queue]->tasks.push_back(xx_task);
+        }
+        m_epoch.fetch_add(1);
+        if (m_sleeping.load() > 0) {
+            std::lock_guard<std::mutex> sleep(m_sleep);
+            m_wake.notify_one();
+        }
+    }
+
+    /*! takes the newest task of queue xx_self or else the oldest of another queue and runs it
+     \return false if all queues were empty
+     */
+    bool run_one(std::size_t const xx_self)
+    {
+        task next;
+        bool found = false;
+        for (std::size_t i = 0; i < m_queues.size() && !found; ++i) {
+            queue & source = *m_queues[(xx_self + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(source.mutex);
+            if (!source.tasks.empty()) {
+                next = i == 0 ? source.tasks.back() : source.tasks.front();
+                if (i == 0)
+                    source.tasks.pop_back();
+                else
+                    source.tasks.pop_front();
+                found = true;
+            }
+        }
+        if (found)
+            run(next, xx_self);
+        return found;
+    }
+
+    void run(task xx_task, std::size_t const xx_self)
+    {
+        job & owner = *xx_task.owner;
+        while (xx_task.end - xx_task.begin > owner.grain) {
+            std::size_t const chunks = (xx_task.end - xx_task.begin + owner.grain - 1) / owner.grain;
+            std::size_t const middle = xx_task.begin + chunks / 2 * owner.grain;
+            push(xx_self, task{&owner, middle, xx_task.end});
+            xx_task.end = middle;
+        }
+        if (!owner.failed.load(std::memory_order_relaxed)) {
+            try {
+                owner.call(owner.function, xx_task.begin, xx_task.end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(owner.mutex);
+                if (!owner.error)
+                    owner.error = std::current_exception();
+                owner.failed.store(true, std::memory_order_relaxed);
+            }
+        }
+        owner.complete(xx_task.end - xx_task.begin);
+    }
+
+    void work(std::size_t const xx_index)
+    {
+        worker().pool = this;
+        worker().index = xx_index;
+        for (;;) {
+            std::size_t const seen = m_epoch.load();
+            if (run_one(xx_index))
+                continue;
+
+            // sleep until a task is pushed; a push after the load above changes the epoch, so it is not missed
+            std::unique_lock<std::mutex> sleep(m_sleep);
+            m_sleeping.fetch_add(1);
+            m_wake.wait(sleep, [&]() { return m_stop || m_epoch.load() != seen; });
+            m_sleeping.fetch_sub(1);
+            if (m_stop)
+                return;
+        }
+    }
+
+    std::atomic<std::size_t> m_threads;
+    std::atomic<bool> m_started{false};
+    std::mutex m_start;
+    std::vector<std::unique_ptr<queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_sleep;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+    std::atomic<std::size_t> m_epoch{0};
+    std::atomic<std::size_t> m_sleeping{0};
+};
+
+namespace detail {
+
+/*! threads of the pool the parallel kernels of the calling thread run on
+ */
+inline std::size_t pool_threads()
+{
+    return thread_pool::current().threads();
+}
+
+/*! runs xx_function(i) for every i in [0, xx_count) on thread_pool::current()
+ \param xx_count number of work items
+ \param xx_function callable taking the index of the work item
+ \note every work item is a task of its own, so uneven items are balanced across threads.
+ \throw the first exception thrown by any of the work items
+ */
+template<typename tpFunction>
+void parallel_for(std::size_t const xx_count, tpFunction const & xx_function)
+{
+    thread_pool::current().parallel_for(0, xx_count, 1, [&](std::size_t const xx_begin, std::size_t const xx_end) {
+        for (std::size_t i = xx_begin; i < xx_end; ++i)
+            xx_function(i);
+    });
+}
+
+}
+}
+
+#endif /* parallel_h */
@@ -0,0 +1,383 @@
+/*
+ //  planar.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the template for a complex matrix in planar (split) storage: all real parts, followed by all
+ imaginary parts. Every kernel then works on plain arrays of the real type, so additions run through the SIMD kernels,
+ complex products are spelled out without the NaN handling of std::complex, and the matrix product takes three real GEMMs
+ of the multiply policy instead of the four of the schoolbook formula. It converts to and from assignment::matrix with interleaved std::complex elements.
+ */
+#ifndef planar_h
+#define planar_h
+
+#include <algorithm>
+#include <complex>
+#include <cstdlib>
+#include <ostream>
+#include <stdexcept>
+
+#include "matrix.hpp"
+
+namespace assignment {
+
+namespace detail {
+
+/*! (xx_re + i xx_im)[k] = (xx_left_re + i xx_left_im)[k] * (xx_scalar_re + i xx_scalar_im) for k in [0, xx_n)
+ \note the output may be the same arrays as the input; the loop has no branches, so the compiler vectorizes it.
+ */
+template<typename tpDataType>
+void planar_scale(tpDataType * xx_re, tpDataType * xx_im, tpDataType const * xx_left_re, tpDataType const * xx_left_im,
+                  tpDataType const xx_scalar_re, tpDataType const xx_scalar_im, std::size_t const xx_n)
+{
+    for (std::size_t k = 0; k < xx_n; ++k) {
+        tpDataType const re = xx_left_re[k];
+        tpDataType const im = xx_left_im[k];
+        xx_re[k] = re * xx_scalar_re - im * xx_scalar_im;
+        xx_im[k] = re * xx_scalar_im + im * xx_scalar_re;
+    }
+}
+
+}
+
+/*! complex matrix with the real and the imaginary parts in separate planes
+ \tparam tpDataType type of the real and imaginary parts (Ex: double for std::complex<double>)
+ \tparam tpPolicyType policy used for matrix multiplication
+ \tparam tpAllocatorType allocator of the storage, holding both planes back to back
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class planar_matrix {
+public:
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = std::complex<tpDataType>;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /*! dynamic matrix of the real type with the same policy, whose multiply the complex product runs on
+     */
+    using real_matrix = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor
+     \param xx_dimR row dimension of the matrix
+     \param xx_dimC column dimension of the matrix
+     */
+    explicit planar_matrix(size_type const xx_dimR, size_type const xx_dimC) :
+                    m_dimR(xx_dimR),
+                    m_dimC(xx_dimC),
+                    m_data(2 * xx_dimR * xx_dimC)
+    {
+    }
+
+    /*! constructor
+     \param xx_dimR row dimension of the matrix
+     \param xx_dimC column dimension of the matrix
+     \param xx_value Value to be filled in the matrix
+     */
+    explicit planar_matrix(size_type const xx_dimR, size_type const xx_dimC, value_type const xx_value) :
+                    planar_matrix(xx_dimR, xx_dimC)
+    {
+        std::fill(real_data(), real_data() + size(), xx_value.real());
+        std::fill(imag_data(), imag_data() + size(), xx_value.imag());
+    }
+
+    /*! constructor from a matrix with interleaved std::complex elements
+     */
+    template<template<typename > class tpOtherPolicyType, typename tpOtherAllocatorType>
+    explicit planar_matrix(matrix<value_type, tpOtherPolicyType, tpOtherAllocatorType> const & xx_matrix) :
+                    planar_matrix(xx_matrix.dimR(), xx_matrix.dimC())
+    {
+        value_type const * const source = xx_matrix.data();
+        for (size_type i = 0; i < size(); ++i) {
+            real_data()[i] = source[i].real();
+            imag_data()[i] = source[i].imag();
+        }
+    }
+
+    planar_matrix(planar_matrix const & xx_matrix) :
+                    planar_matrix(xx_matrix.m_dimR, xx_matrix.m_dimC)
+    {
+        std::copy_n(xx_matrix.m_data.get(), 2 * size(), m_data.get());
+    }
+
+    planar_matrix(planar_matrix && xx_matrix) noexcept :
+                    m_dimR(xx_matrix.m_dimR),
+                    m_dimC(xx_matrix.m_dimC),
+                    m_data(std::move(xx_matrix.m_data))
+    {
+        xx_matrix.m_dimR = 0;
+        xx_matrix.m_dimC = 0;
+    }
+
+    planar_matrix & operator=(planar_matrix const & xx_matrix)
+    {
+        if (this != &xx_matrix) {
+            planar_matrix copy(xx_matrix);
+            (*this) = std::move(copy);
+        }
+        return *this;
+    }
+
+    planar_matrix & operator=(planar_matrix && xx_matrix) noexcept
+    {
+        m_dimR = xx_matrix.m_dimR;
+        m_dimC = xx_matrix.m_dimC;
+        m_data = std::move(xx_matrix.m_data);
+        xx_matrix.m_dimR = 0;
+        xx_matrix.m_dimC = 0;
+        return *this;
+    }
+
+    /*! conversion to a matrix with interleaved std::complex elements
+     */
+    template<typename tpOtherAllocatorType>
+    operator matrix<value_type, tpPolicyType, tpOtherAllocatorType>() const
+    {
+        matrix<value_type, tpPolicyType, tpOtherAllocatorType> result(m_dimR, m_dimC);
+        value_type * const target = result.data();
+        for (size_type i = 0; i < size(); ++i)
+            target[i] = value_type(real_data()[i], imag_data()[i]);
+        return result;
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    /*! \throw std::domain_error if the dimensions are not equal
+     */
+    planar_matrix & operator+=(planar_matrix const & xx_matrix)
+    {
+        check_same(xx_matrix);
+        detail::simd::binary<detail::simd::op::add>(m_data.get(), m_data.get(), xx_matrix.m_data.get(), 2 * size());
+        return *this;
+    }
+
+    /*! \throw std::domain_error if the dimensions are not equal
+     */
+    planar_matrix & operator-=(planar_matrix const & xx_matrix)
+    {
+        check_same(xx_matrix);
+        detail::simd::binary<detail::simd::op::sub>(m_data.get(), m_data.get(), xx_matrix.m_data.get(), 2 * size());
+        return *this;
+    }
+
+    planar_matrix & operator*=(value_type const & xx_scalar)
+    {
+        detail::planar_scale(real_data(), imag_data(), real_data(), imag_data(), xx_scalar.real(), xx_scalar.imag(), size());
+        return *this;
+    }
+
+    /*! policy matrix multiplication
+     \throw std::domain_error if either matrix is not square or the dimensions are not equal
+     */
+    planar_matrix & operator*=(planar_matrix const & xx_matrix)
+    {
+        if (m_dimC != m_dimR || xx_matrix.m_dimC != xx_matrix.m_dimR || m_dimR != xx_matrix.m_dimR)
+            throw std::domain_error("matrix_B should be the same size as matrix_A");
+        (*this) = (*this) * xx_matrix;
+        return *this;
+    }
+
+    /*! element (R, C)
+     */
+    value_type operator()(size_type const xx_R, size_type const xx_C) const
+    {
+        return value_type(real(xx_R, xx_C), imag(xx_R, xx_C));
+    }
+
+    /* ==== g  e  t  t  e  r  s ==== */
+
+    size_type dimR() const
+    {
+        return m_dimR;
+    }
+
+    size_type dimC() const
+    {
+        return m_dimC;
+    }
+
+    /*! number of elements in each plane
+     */
+    size_type size() const
+    {
+        return m_dimR * m_dimC;
+    }
+
+    tpDataType const & real(size_type const xx_R, size_type const xx_C) const
+    {
+        return real_data()[xx_R * m_dimC + xx_C];
+    }
+
+    tpDataType & real(size_type const xx_R, size_type const xx_C)
+    {
+        return real_data()[xx_R * m_dimC + xx_C];
+    }
+
+    tpDataType const & imag(size_type const xx_R, size_type const xx_C) const
+    {
+        return imag_data()[xx_R * m_dimC + xx_C];
+    }
+
+    tpDataType & imag(size_type const xx_R, size_type const xx_C)
+    {
+        return imag_data()[xx_R * m_dimC + xx_C];
+    }
+
+    /*! row-major plane of the real parts
+     */
+    tpDataType const * real_data() const
+    {
+        return m_data.get();
+    }
+
+    tpDataType * real_data()
+    {
+        return m_data.get();
+    }
+
+    /*! row-major plane of the imaginary parts; follows the real plane directly
+     */
+    tpDataType const * imag_data() const
+    {
+        return m_data.get() + size();
+    }
+
+    tpDataType * imag_data()
+    {
+        return m_data.get() + size();
+    }
+
+    /*! \throw std::domain_error if xx_matrix has other dimensions than (*this)
+     */
+    void check_same(planar_matrix const & xx_matrix) const
+    {
+        if (m_dimR != xx_matrix.m_dimR || m_dimC != xx_matrix.m_dimC)
+            throw std::domain_error("Dimensions of the matrices are not equal");
+    }
+
+private:
+
+    size_type m_dimR;
+    size_type m_dimC;
+    buffer<tpDataType, tpAllocatorType> m_data;
+};
+
+/* ==== f  r  e  e     o  p  e  r  a  t  o  r  s ==== */
+
+/*! \throw std::domain_error if the dimensions are not equal
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> operator+(planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_left,
+                                                                   planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_right)
+{
+    xx_left.check_same(xx_right);
+    planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> result(xx_left.dimR(), xx_left.dimC());
+    detail::simd::binary<detail::simd::op::add>(result.real_data(), xx_left.real_data(), xx_right.real_data(), 2 * result.size());
+    return result;
+}
+
+/*! \throw std::domain_error if the dimensions are not equal
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> operator-(planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_left,
+                                                                   planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_right)
+{
+    xx_left.check_same(xx_right);
+    planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> result(xx_left.dimR(), xx_left.dimC());
+    detail::simd::binary<detail::simd::op::sub>(result.real_data(), xx_left.real_data(), xx_right.real_data(), 2 * result.size());
+    return result;
+}
+
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> operator-(planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix)
+{
+    planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> result(xx_matrix.dimR(), xx_matrix.dimC());
+    detail::simd::broadcast<detail::simd::op::mul>(result.real_data(), xx_matrix.real_data(), static_cast<tpDataType>(-1), 2 * result.size());
+    return result;
+}
+
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> operator*(planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix,
+                                                                   std::complex<tpDataType> const & xx_scalar)
+{
+    planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> result(xx_matrix.dimR(), xx_matrix.dimC());
+    detail::planar_scale(result.real_data(), result.imag_data(), xx_matrix.real_data(), xx_matrix.imag_data(),
+                         xx_scalar.real(), xx_scalar.imag(), result.size());
+    return result;
+}
+
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> operator*(std::complex<tpDataType> const & xx_scalar,
+                                                                   planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix)
+{
+    return xx_matrix * xx_scalar;
+}
+
+/*! policy matrix multiplication in three real products (the Gauss, or 3M, method)
+ \note with T1 = Ar * Br, T2 = Ai * Bi and T3 = (Ar + Ai) * (Br + Bi), the result planes are Cr = T1 - T2 and
+ Ci = T3 - T1 - T2: three real GEMMs of the policy on the planes in place, instead of four, at the cost of adding the planes
+ of A and of B once. For floating point types the error of Ci is bounded by |A| * |B| rather than |Ai * Br + Ar * Bi|, so
+ elements of Ci much smaller than that lose relative accuracy.
+ \throw std::domain_error if Number of columns_A != Number of rows_B
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> operator*(planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_left,
+                                                                   planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_right)
+{
+    if (xx_left.dimC() != xx_right.dimR())
+        throw std::domain_error("Number of columns_A != Number of rows_B");
+
+    std::size_t const M = xx_left.dimR();
+    std::size_t const K = xx_left.dimC();
+    std::size_t const N = xx_right.dimC();
+    std::ptrdiff_t const rsA = static_cast<std::ptrdiff_t>(K);
+    std::ptrdiff_t const rsB = static_cast<std::ptrdiff_t>(N);
+
+    // the plane sums, then T2 in the space of Ar + Ai once that product is done with it
+    buffer<tpDataType, tpAllocatorType> sumA(std::max(M * K, M * N));
+    buffer<tpDataType, tpAllocatorType> sumB(K * N);
+    detail::simd::binary<detail::simd::op::add>(sumA.get(), xx_left.real_data(), xx_left.imag_data(), M * K);
+    detail::simd::binary<detail::simd::op::add>(sumB.get(), xx_right.real_data(), xx_right.imag_data(), K * N);
+
+    planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> result(M, N);
+    tpDataType * const re = result.real_data();
+    tpDataType * const im = result.imag_data();
+    using policy = tpPolicyType<typename planar_matrix<tpDataType, tpPolicyType, tpAllocatorType>::real_matrix>;
+    policy::multiply(M, N, K, sumA.get(), rsA, 1, sumB.get(), rsB, 1, im, rsB);
+    policy::multiply(M, N, K, xx_left.real_data(), rsA, 1, xx_right.real_data(), rsB, 1, re, rsB);
+    tpDataType * const product = sumA.get();
+    policy::multiply(M, N, K, xx_left.imag_data(), rsA, 1, xx_right.imag_data(), rsB, 1, product, rsB);
+
+    detail::simd::binary<detail::simd::op::sub>(im, im, re, M * N);
+    detail::simd::binary<detail::simd::op::sub>(im, im, product, M * N);
+    detail::simd::binary<detail::simd::op::sub>(re, re, product, M * N);
+    return result;
+}
+
+/*! output matrix to std::cout
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+std::ostream& operator<<(std::ostream& os, planar_matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix)
+{
+    os << '[';
+    for (std::size_t R = 0; R < xx_matrix.dimR(); ++R) {
+        if (R > 0)
+            os << ",\n ";
+
+        for (std::size_t C = 0; C < xx_matrix.dimC(); ++C)
+            os << xx_matrix(R, C) << " ";
+    }
+    os << ']';
+    return os;
+}
+
+}
+
+#endif /* planar_h */
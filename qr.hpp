@@ -0,0 +1,586 @@
+/*
+ //  qr.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the Householder QR factorization A = Q * R of an assignment::matrix with at least as many rows as
+ columns, and the least-squares solve min ||A * x - b|| built on it. The factorization is blocked in the compact WY form:
+ the reflectors H_1 ... H_b of a panel of columns are collected into I - V * T * V^T, so the trailing matrix is updated
+ by three products of the multiply policy instead of one rank-1 update per column. For tall-skinny matrices,
+ tsqr_factorization factors row blocks independently on the thread pool and combines their R factors with one more QR.
+ */
+#ifndef qr_h
+#define qr_h
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "triangular.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+namespace detail {
+
+/*! buffers of the block reflector products, reused across panels
+ \note V holds the reflectors of a panel with their unit diagonal and the zeros above it made explicit.
+ */
+template<typename tpDataType>
+struct qr_workspace {
+    std::vector<tpDataType> V, W, WT, temp;
+};
+
+/*! bytes of a row block of tsqr_factorization; the block and the buffers of its factorization stay in the L2 cache
+ */
+constexpr std::size_t tsqr_block_bytes = std::size_t(1) << 20;
+
+/*! elements of the T factors of an xx_n column factorization; the factor of panel p starts at p * NB * NB
+ */
+inline std::size_t qr_factor_size(std::size_t const xx_n)
+{
+    constexpr std::size_t NB = factor_blocking::NB;
+    return (xx_n + NB - 1) / NB * NB * NB;
+}
+
+/*! unblocked Householder QR of the xx_m x xx_b panel of the row-major xx_panel, with H_j = I - tau_j * v_j * v_j^T
+ \note v_j is stored below the diagonal of column j with its leading one implied, and R on and above the diagonal; a
+ column that is already zero below the diagonal gets tau_j = 0. The reflectors are applied to the panel row by row, so
+ every row of the panel is read contiguously.
+ */
+template<typename tpDataType>
+void householder_panel(std::size_t const xx_m, std::size_t const xx_b, tpDataType * xx_panel, std::ptrdiff_t const xx_rs,
+                       tpDataType * xx_tau, std::vector<tpDataType> & xx_w)
+{
+    auto const row = [&](std::size_t const xx_r) { return xx_panel + static_cast<std::ptrdiff_t>(xx_r) * xx_rs; };
+    xx_w.resize(xx_b);
+    for (std::size_t j = 0; j < xx_b && j < xx_m; ++j) {
+        tpDataType const alpha = row(j)[j];
+        tpDataType sigma = tpDataType(0);
+        for (std::size_t i = j + 1; i < xx_m; ++i)
+            sigma += row(i)[j] * row(i)[j];
+        if (sigma == tpDataType(0)) {
+            xx_tau[j] = tpDataType(0);
+            continue;
+        }
+
+        tpDataType const norm = std::sqrt(alpha * alpha + sigma);
+        tpDataType const beta = alpha > tpDataType(0) ? -norm : norm;
+        tpDataType const scale = tpDataType(1) / (alpha - beta);
+        tpDataType const tau = (beta - alpha) / beta;
+        xx_tau[j] = tau;
+        row(j)[j] = beta;
+        for (std::size_t i = j + 1; i < xx_m; ++i)
+            row(i)[j] *= scale;
+
+        // w = v^T * A(:, j+1:b), then A(:, j+1:b) -= tau * v * w
+        std::size_t const width = xx_b - j - 1;
+        if (width == 0)
+            continue;
+        tpDataType * const w = xx_w.data();
+        std::copy(row(j) + j + 1, row(j) + xx_b, w);
+        for (std::size_t i = j + 1; i < xx_m; ++i)
+            subtract_scaled(w, row(i) + j + 1, -row(i)[j], width);
+        subtract_scaled(row(j) + j + 1, w, tau, width);
+        for (std::size_t i = j + 1; i < xx_m; ++i)
+            subtract_scaled(row(i) + j + 1, w, tau * row(i)[j], width);
+    }
+}
+
+/*! copies the reflectors of an xx_m x xx_b panel to the row-major xx_m x xx_b buffer xx_V, with the unit diagonal and
+ the zeros above it
+ */
+template<typename tpDataType>
+void copy_reflectors(std::size_t const xx_m, std::size_t const xx_b, tpDataType const * xx_panel, std::ptrdiff_t const xx_rs,
+                     std::vector<tpDataType> & xx_V)
+{
+    xx_V.resize(xx_m * xx_b);
+    for (std::size_t i = 0; i < xx_m; ++i) {
+        tpDataType const * const row = xx_panel + static_cast<std::ptrdiff_t>(i) * xx_rs;
+        tpDataType * const out = xx_V.data() + i * xx_b;
+        std::size_t const below = std::min(i, xx_b);
+        std::copy(row, row + below, out);
+        std::fill(out + below, out + xx_b, tpDataType(0));
+        if (i < xx_b)
+            out[i] = tpDataType(1);
+    }
+}
+
+/*! forms the upper triangular xx_b x xx_b T with H_1 * ... * H_b = I - V * T * V^T from the xx_m x xx_b reflectors V
+ \note V^T * V is one product of the policy; column i of T is then -tau_i * T(0:i, 0:i) * (V^T * v_i)(0:i).
+ */
+template<typename tpPolicy, typename tpDataType>
+void form_block_factor(std::size_t const xx_m, std::size_t const xx_b, tpDataType const * xx_tau, qr_workspace<tpDataType> & xx_work,
+                       tpDataType * xx_T)
+{
+    std::ptrdiff_t const b = static_cast<std::ptrdiff_t>(xx_b);
+    xx_work.W.resize(xx_b * xx_b);
+    tpDataType * const gram = xx_work.W.data();
+    tpPolicy::multiply(xx_b, xx_b, xx_m, xx_work.V.data(), 1, b, xx_work.V.data(), b, 1, gram, b);
+
+    std::fill(xx_T, xx_T + xx_b * xx_b, tpDataType(0));
+    for (std::size_t i = 0; i < xx_b; ++i) {
+        for (std::size_t r = 0; r < i; ++r) {
+            tpDataType sum = tpDataType(0);
+            for (std::size_t c = r; c < i; ++c)
+                sum += xx_T[r * xx_b + c] * gram[c * xx_b + i];
+            xx_T[r * xx_b + i] = -xx_tau[i] * sum;
+        }
+        xx_T[i * xx_b + i] = xx_tau[i];
+    }
+}
+
+/*! C -= V * op(T) * (V^T * C) for the reflectors in xx_work.V, with op(T) = T^T if xx_transpose, applying Q_p^T to C,
+ else T, applying Q_p
+ \note C is xx_m x xx_cols and row-major; all three products go through the multiply policy.
+ */
+template<typename tpPolicy, typename tpDataType>
+void apply_block_reflector(std::size_t const xx_m, std::size_t const xx_b, tpDataType const * xx_T, bool const xx_transpose,
+                           std::size_t const xx_cols, tpDataType * xx_C, std::ptrdiff_t const xx_rsC, qr_workspace<tpDataType> & xx_work)
+{
+    if (xx_m == 0 || xx_cols == 0)
+        return;
+    std::ptrdiff_t const b = static_cast<std::ptrdiff_t>(xx_b);
+    std::ptrdiff_t const cols = static_cast<std::ptrdiff_t>(xx_cols);
+    xx_work.W.resize(xx_b * xx_cols);
+    xx_work.WT.resize(xx_b * xx_cols);
+    tpPolicy::multiply(xx_b, xx_cols, xx_m, xx_work.V.data(), 1, b, xx_C, xx_rsC, 1, xx_work.W.data(), cols);
+    tpPolicy::multiply(xx_b, xx_cols, xx_b, xx_T, xx_transpose ? 1 : b, xx_transpose ? b : 1, xx_work.W.data(), cols, 1,
+                       xx_work.WT.data(), cols);
+    subtract_product<tpPolicy>(xx_m, xx_cols, xx_b, xx_work.V.data(), b, 1, xx_work.WT.data(), cols, 1, xx_C, xx_rsC, xx_work.temp);
+}
+
+/*! blocked Householder QR in place of the row-major xx_m x xx_n matrix xx_a, xx_m >= xx_n
+ \param xx_tau receives the xx_n scalars of the reflectors
+ \param xx_T receives the T factors of the panels, qr_factor_size(xx_n) elements
+ */
+template<typename tpPolicy, typename tpDataType>
+void householder_qr(std::size_t const xx_m, std::size_t const xx_n, tpDataType * xx_a, std::ptrdiff_t const xx_rs, tpDataType * xx_tau,
+                    tpDataType * xx_T, qr_workspace<tpDataType> & xx_work)
+{
+    constexpr std::size_t NB = factor_blocking::NB;
+    auto const at = [&](std::size_t const xx_r, std::size_t const xx_c) { return xx_a + static_cast<std::ptrdiff_t>(xx_r) * xx_rs + xx_c; };
+    for (std::size_t k = 0; k < xx_n; k += NB) {
+        std::size_t const b = std::min(NB, xx_n - k);
+        householder_panel(xx_m - k, b, at(k, k), xx_rs, xx_tau + k, xx_work.W);
+
+        // A22 := Q_p^T * A22 with Q_p = I - V * T * V^T
+        copy_reflectors(xx_m - k, b, at(k, k), xx_rs, xx_work.V);
+        tpDataType * const T = xx_T + k / NB * NB * NB;
+        form_block_factor<tpPolicy>(xx_m - k, b, xx_tau + k, xx_work, T);
+        apply_block_reflector<tpPolicy>(xx_m - k, b, T, true, xx_n - k - b, at(k, k + b), xx_rs, xx_work);
+    }
+}
+
+/*! applies Q^T (xx_transpose) or Q of a householder_qr factorization to the row-major xx_m x xx_cols matrix xx_C
+ */
+template<typename tpPolicy, typename tpDataType>
+void apply_householder(std::size_t const xx_m, std::size_t const xx_n, tpDataType const * xx_a, std::ptrdiff_t const xx_rs,
+                       tpDataType const * xx_T, bool const xx_transpose, std::size_t const xx_cols,
+                       tpDataType * xx_C, std::ptrdiff_t const xx_rsC, qr_workspace<tpDataType> & xx_work)
+{
+    constexpr std::size_t NB = factor_blocking::NB;
+    std::size_t const panels = (xx_n + NB - 1) / NB;
+    for (std::size_t s = 0; s < panels; ++s) {
+        std::size_t const p = xx_transpose ? s : panels - 1 - s;
+        std::size_t const k = p * NB;
+        std::size_t const b = std::min(NB, xx_n - k);
+        copy_reflectors(xx_m - k, b, xx_a + static_cast<std::ptrdiff_t>(k) * xx_rs + k, xx_rs, xx_work.V);
+        apply_block_reflector<tpPolicy>(xx_m - k, b, xx_T + p * NB * NB, xx_transpose, xx_cols, xx_C + static_cast<std::ptrdiff_t>(k) * xx_rsC, xx_rsC, xx_work);
+    }
+}
+
+/*! solves R * x = xx_x(0:n) in place for the upper triangle R of the first xx_n rows of xx_a
+ \throw std::domain_error if R has a zero on its diagonal
+ */
+template<typename tpPolicy, typename tpDataType>
+void solve_upper_factor(std::size_t const xx_n, std::size_t const xx_cols, tpDataType const * xx_a, std::ptrdiff_t const xx_rs,
+                        tpDataType * xx_x, std::ptrdiff_t const xx_rsX, std::vector<tpDataType> & xx_temp)
+{
+    for (std::size_t i = 0; i < xx_n; ++i) {
+        if (xx_a[static_cast<std::ptrdiff_t>(i) * xx_rs + i] == tpDataType(0))
+            throw std::domain_error("Matrix is rank deficient");
+    }
+    if (xx_cols == 1 && xx_rsX == 1)
+        solve_vector<tpPolicy>(xx_n, xx_a, xx_rs, 1, triangle::upper, false, xx_x, xx_temp);
+    else
+        solve_blocked<tpPolicy>(xx_n, xx_cols, xx_a, xx_rs, 1, triangle::upper, false, xx_x, xx_rsX, xx_temp);
+}
+
+} // namespace detail
+
+/*! Householder QR factorization A = Q * R of a matrix with at least as many rows as columns
+ \tparam tpDataType element type; floating point
+ \tparam tpPolicyType multiply policy of the block reflector products
+ \note Q is kept as its reflectors; apply_qt() and least_squares() use them without forming Q.
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class qr_factorization {
+public:
+
+    static_assert(std::is_floating_point<tpDataType>::value, "QR factorization needs a floating point element type");
+
+    /*! type of the factored and solved matrices
+     */
+    using matrix_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! factors xx_matrix; pass an rvalue to factor in its storage without a copy
+     \throw std::domain_error if the matrix has fewer rows than columns
+     */
+    explicit qr_factorization(matrix_type xx_matrix) :
+                    m_factors(std::move(xx_matrix)),
+                    m_tau(m_factors.dimC()),
+                    m_T(detail::qr_factor_size(m_factors.dimC()))
+    {
+        if (m_factors.dimR() < m_factors.dimC())
+            throw std::domain_error("Matrix should have at least as many rows as columns");
+        detail::qr_workspace<tpDataType> work;
+        detail::householder_qr<policy>(dimR(), dimC(), m_factors.data(), stride(), m_tau.data(), m_T.data(), work);
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! get the row dimension of the factored matrix
+     */
+    size_type dimR() const
+    {
+        return m_factors.dimR();
+    }
+
+    /*! get the column dimension of the factored matrix
+     */
+    size_type dimC() const
+    {
+        return m_factors.dimC();
+    }
+
+    /*! R on and above the diagonal, the Householder vectors below it with their leading ones implied
+     */
+    matrix_type const & factors() const
+    {
+        return m_factors;
+    }
+
+    /*! the dimC() x dimC() upper triangular factor R
+     */
+    matrix_type R() const
+    {
+        matrix_type result(dimC(), dimC(), tpDataType(0));
+        for (size_type i = 0; i < dimC(); ++i)
+            std::copy(m_factors.data() + i * dimC() + i, m_factors.data() + (i + 1) * dimC(), result.data() + i * dimC() + i);
+        return result;
+    }
+
+    /*! the dimR() x dimC() factor Q with orthonormal columns, A = Q * R
+     */
+    matrix_type Q() const
+    {
+        matrix_type result(dimR(), dimC(), tpDataType(0));
+        for (size_type i = 0; i < dimC(); ++i)
+            result(i, i) = tpDataType(1);
+        apply(false, dimC(), result.data(), static_cast<std::ptrdiff_t>(dimC()));
+        return result;
+    }
+
+    /*! Q^T * xx_rhs for the full dimR() x dimR() Q
+     \throw std::domain_error if the dimension of xx_rhs differs from dimR()
+     */
+    template<typename tpVectorAllocator>
+    vector<tpDataType, tpVectorAllocator> apply_qt(vector<tpDataType, tpVectorAllocator> xx_rhs) const
+    {
+        if (xx_rhs.dim() != dimR())
+            throw std::domain_error("Vector should have the row dimension of the matrix");
+        apply(true, 1, xx_rhs.data(), 1);
+        return xx_rhs;
+    }
+
+    /*! Q^T * xx_rhs for the full dimR() x dimR() Q
+     \throw std::domain_error if the row dimension of xx_rhs differs from dimR()
+     */
+    matrix_type apply_qt(matrix_type xx_rhs) const
+    {
+        if (xx_rhs.dimR() != dimR())
+            throw std::domain_error("Matrix should have the row dimension of the factored matrix");
+        apply(true, xx_rhs.dimC(), xx_rhs.data(), static_cast<std::ptrdiff_t>(xx_rhs.dimC()));
+        return xx_rhs;
+    }
+
+    /*! x minimizing ||A * x - xx_rhs||, solved as R * x = (Q^T * xx_rhs)(0:dimC())
+     \throw std::domain_error if the dimension of xx_rhs differs from dimR() or R has a zero on its diagonal
+     */
+    template<typename tpVectorAllocator>
+    vector<tpDataType, tpVectorAllocator> least_squares(vector<tpDataType, tpVectorAllocator> xx_rhs) const
+    {
+        xx_rhs = apply_qt(std::move(xx_rhs));
+        std::vector<tpDataType> temp;
+        detail::solve_upper_factor<policy>(dimC(), 1, m_factors.data(), stride(), xx_rhs.data(), 1, temp);
+        return vector<tpDataType, tpVectorAllocator>(dimC(), xx_rhs.data());
+    }
+
+    /*! X minimizing ||A * X - xx_rhs|| column by column, for all columns of xx_rhs at once
+     \throw std::domain_error if the row dimension of xx_rhs differs from dimR() or R has a zero on its diagonal
+     */
+    matrix_type least_squares(matrix_type xx_rhs) const
+    {
+        xx_rhs = apply_qt(std::move(xx_rhs));
+        std::vector<tpDataType> temp;
+        std::ptrdiff_t const rsX = static_cast<std::ptrdiff_t>(xx_rhs.dimC());
+        detail::solve_upper_factor<policy>(dimC(), xx_rhs.dimC(), m_factors.data(), stride(), xx_rhs.data(), rsX, temp);
+        return matrix_type(dimC(), xx_rhs.dimC(), xx_rhs.data());
+    }
+
+private:
+
+    using policy = typename matrix_type::policy_type;
+
+    std::ptrdiff_t stride() const
+    {
+        return static_cast<std::ptrdiff_t>(dimC());
+    }
+
+    void apply(bool const xx_transpose, size_type const xx_cols, tpDataType * xx_C, std::ptrdiff_t const xx_rsC) const
+    {
+        detail::qr_workspace<tpDataType> work;
+        detail::apply_householder<policy>(dimR(), dimC(), m_factors.data(), stride(), m_T.data(), xx_transpose,
+                                          xx_cols, xx_C, xx_rsC, work);
+    }
+
+    matrix_type m_factors;
+    std::vector<tpDataType> m_tau;
+
+    /*! T factors of the panels, see detail::qr_factor_size
+     */
+    std::vector<tpDataType> m_T;
+};
+
+/*! tall-skinny QR (TSQR) of a matrix with many more rows than columns
+ \tparam tpDataType element type; floating point
+ \tparam tpPolicyType multiply policy; with Parallel the row blocks are factored on all threads of the pool
+ \note the rows are split into blocks of about detail::tsqr_block_bytes, every block is factored on its own with the
+ blocked Householder QR while it stays in cache, and the stacked R factors of the blocks are factored the same way,
+ until they fit in one block. A single QR of the whole matrix instead streams all rows through memory once per column.
+ Only R and the least-squares solves are offered; Q is kept as the reflectors of the blocks.
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class tsqr_factorization {
+public:
+
+    static_assert(std::is_floating_point<tpDataType>::value, "QR factorization needs a floating point element type");
+
+    /*! type of the factored and solved matrices
+     */
+    using matrix_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! factors xx_matrix; pass an rvalue to factor in its storage without a copy
+     \throw std::domain_error if the matrix has fewer rows than columns
+     */
+    explicit tsqr_factorization(matrix_type xx_matrix) :
+                    m_blocks(std::move(xx_matrix)),
+                    m_count(block_count(m_blocks.dimR(), m_blocks.dimC())),
+                    m_tau(m_count * m_blocks.dimC()),
+                    m_T(m_count * detail::qr_factor_size(m_blocks.dimC()))
+    {
+        factor();
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! get the row dimension of the factored matrix
+     */
+    size_type dimR() const
+    {
+        return m_blocks.dimR();
+    }
+
+    /*! get the column dimension of the factored matrix
+     */
+    size_type dimC() const
+    {
+        return m_blocks.dimC();
+    }
+
+    /*! number of row blocks factored independently at the first level
+     */
+    size_type blocks() const
+    {
+        return m_count;
+    }
+
+    /*! the dimC() x dimC() upper triangular factor R
+     */
+    matrix_type R() const
+    {
+        if (m_top)
+            return m_top->R();
+        size_type const n = dimC();
+        matrix_type result(n, n, tpDataType(0));
+        for (size_type i = 0; i < n; ++i)
+            std::copy(m_blocks.data() + i * n + i, m_blocks.data() + (i + 1) * n, result.data() + i * n + i);
+        return result;
+    }
+
+    /*! x minimizing ||A * x - xx_rhs||
+     \note every block applies its Q^T to its rows of xx_rhs; the first dimC() elements of each are then solved against
+     the factorization of the stacked R factors.
+     \throw std::domain_error if the dimension of xx_rhs differs from dimR() or R has a zero on its diagonal
+     */
+    template<typename tpVectorAllocator>
+    vector<tpDataType, tpVectorAllocator> least_squares(vector<tpDataType, tpVectorAllocator> xx_rhs) const
+    {
+        if (xx_rhs.dim() != dimR())
+            throw std::domain_error("Vector should have the row dimension of the matrix");
+
+        size_type const n = dimC();
+        tpDataType * const b = xx_rhs.data();
+        for_blocks([&](size_type const xx_block, size_type const xx_first, size_type const xx_rows, detail::qr_workspace<tpDataType> & xx_work) {
+            detail::apply_householder<block_policy>(xx_rows, n, m_blocks.data() + xx_first * n, stride(), block_factor(xx_block), true, 1,
+                                                    b + xx_first, 1, xx_work);
+        });
+
+        if (!m_top) {
+            std::vector<tpDataType> temp;
+            detail::solve_upper_factor<policy>(n, 1, m_blocks.data(), stride(), b, 1, temp);
+            return vector<tpDataType, tpVectorAllocator>(n, b);
+        }
+        vector<tpDataType, tpVectorAllocator> stacked(m_count * n);
+        for (size_type block = 0; block < m_count; ++block)
+            std::copy(b + first_row(block), b + first_row(block) + n, stacked.data() + block * n);
+        return m_top->least_squares(std::move(stacked));
+    }
+
+private:
+
+    using policy = typename matrix_type::policy_type;
+
+    /*! the blocks are factored by one thread each
+     */
+    using block_policy = NonParallel<matrix_type>;
+
+    /*! blocks of about detail::tsqr_block_bytes and at least 2 * xx_n rows; with Parallel, at least one per thread if the
+     matrix is tall enough
+     */
+    static size_type block_count(size_type const xx_m, size_type const xx_n)
+    {
+        if (xx_m < xx_n)
+            throw std::domain_error("Matrix should have at least as many rows as columns");
+        size_type const min_rows = std::max<size_type>(2 * xx_n, 1);
+        size_type rows = std::max(min_rows, detail::tsqr_block_bytes / (std::max<size_type>(xx_n, 1) * sizeof(tpDataType)));
+        if (policy::is_parallel)
+            rows = std::max(min_rows, std::min(rows, xx_m / detail::pool_threads()));
+        return std::max<size_type>(1, xx_m / rows);
+    }
+
+    std::ptrdiff_t stride() const
+    {
+        return static_cast<std::ptrdiff_t>(dimC());
+    }
+
+    size_type first_row(size_type const xx_block) const
+    {
+        return dimR() * xx_block / m_count;
+    }
+
+    tpDataType * block_factor(size_type const xx_block)
+    {
+        return m_T.data() + xx_block * detail::qr_factor_size(dimC());
+    }
+
+    tpDataType const * block_factor(size_type const xx_block) const
+    {
+        return m_T.data() + xx_block * detail::qr_factor_size(dimC());
+    }
+
+    /*! runs xx_function(block, first row, rows, workspace) for every block, on the thread pool with Parallel
+     */
+    template<typename tpFunction>
+    void for_blocks(tpFunction const & xx_function) const
+    {
+        auto const run = [&](size_type const xx_first, size_type const xx_last) {
+            detail::qr_workspace<tpDataType> work;
+            for (size_type block = xx_first; block < xx_last; ++block)
+                xx_function(block, first_row(block), first_row(block + 1) - first_row(block), work);
+        };
+        if (policy::is_parallel)
+            thread_pool::current().parallel_for(0, m_count, 1, run);
+        else
+            run(0, m_count);
+    }
+
+    /*! factors the blocks, then the stacked R factors if there is more than one block
+     */
+    void factor()
+    {
+        size_type const n = dimC();
+        tpDataType * const a = m_blocks.data();
+        for_blocks([&](size_type const xx_block, size_type const xx_first, size_type const xx_rows, detail::qr_workspace<tpDataType> & xx_work) {
+            detail::householder_qr<block_policy>(xx_rows, n, a + xx_first * n, stride(), m_tau.data() + xx_block * n,
+                                                 block_factor(xx_block), xx_work);
+        });
+        if (m_count == 1)
+            return;
+
+        matrix_type stacked(m_count * n, n, tpDataType(0));
+        for (size_type block = 0; block < m_count; ++block) {
+            tpDataType const * const R = a + first_row(block) * n;
+            for (size_type i = 0; i < n; ++i)
+                std::copy(R + i * n + i, R + (i + 1) * n, stacked.data() + (block * n + i) * n + i);
+        }
+        m_top.reset(new tsqr_factorization(std::move(stacked)));
+    }
+
+    matrix_type m_blocks;
+    size_type m_count;
+    std::vector<tpDataType> m_tau;
+    std::vector<tpDataType> m_T;
+
+    /*! factorization of the stacked R factors of the blocks; empty if there is only one block
+     */
+    std::unique_ptr<tsqr_factorization> m_top;
+};
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! x minimizing ||xx_matrix * x - xx_rhs|| for a matrix with at least as many rows as columns and full column rank
+ \note a matrix tall enough to split into row blocks is factored with TSQR, else with the blocked Householder QR.
+ \throw std::domain_error if the matrix has fewer rows than columns, the dimensions differ or the matrix is rank deficient
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType, typename tpVectorAllocator>
+vector<tpDataType, tpVectorAllocator> least_squares(matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_matrix,
+                                                    vector<tpDataType, tpVectorAllocator> xx_rhs)
+{
+    if (xx_rhs.dim() != xx_matrix.dimR())
+        throw std::domain_error("Vector should have the row dimension of the matrix");
+    if (xx_matrix.dimR() >= 4 * xx_matrix.dimC())
+        return tsqr_factorization<tpDataType, tpPolicyType, tpAllocatorType>(std::move(xx_matrix)).least_squares(std::move(xx_rhs));
+    return qr_factorization<tpDataType, tpPolicyType, tpAllocatorType>(std::move(xx_matrix)).least_squares(std::move(xx_rhs));
+}
+
+}
+#endif /* qr_h */
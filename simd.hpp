@@ -0,0 +1,526 @@
+/*
+ //  simd.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the flat element-wise kernels used by the matrix and vector operators.
+ On x86 the widest instruction set supported by the running CPU (SSE2, AVX2 or AVX-512) is picked at runtime, so one binary
+ runs at full width on every hardware generation. Other element types and platforms use a plain loop.
+ */
+#ifndef simd_h
+#define simd_h
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ASSIGNMENT_SIMD_X86 1
+#include <immintrin.h>
+#define ASSIGNMENT_TARGET(xx_isa) __attribute__((target(xx_isa)))
+#else
+#define ASSIGNMENT_SIMD_X86 0
+#endif
+
+namespace assignment {
+namespace detail {
+namespace simd {
+
+/*! element-wise operation computed by a kernel
+ */
+enum class op {
+    add, sub, mul
+};
+
+/*! instruction set levels, ordered by width
+ */
+enum class isa {
+    scalar, sse2, avx2, avx512
+};
+
+/*! widest instruction set supported by the running CPU
+ */
+inline isa detect()
+{
+#if ASSIGNMENT_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return isa::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return isa::avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return isa::sse2;
+#endif
+    return isa::scalar;
+}
+
+/*! instruction set used by the kernels; detected once per process
+ */
+inline isa active()
+{
+    static isa const level = detect();
+    return level;
+}
+
+/*! scalar form of the operation; used for the tails and as fallback
+ */
+template<op tpOp, typename tpDataType>
+inline tpDataType apply(tpDataType const & xx_left, tpDataType const & xx_right)
+{
+    if constexpr (tpOp == op::add)
+        return xx_left + xx_right;
+    else if constexpr (tpOp == op::sub)
+        return xx_left - xx_right;
+    else
+        return xx_left * xx_right;
+}
+
+/*! element types with hand-written kernels
+ */
+template<typename tpDataType>
+struct has_kernels : std::integral_constant<bool,
+                std::is_same<tpDataType, float>::value || std::is_same<tpDataType, double>::value || std::is_same<tpDataType, std::int32_t>::value> {
+};
+
+template<op tpOp, typename tpDataType>
+void binary_scalar(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const * xx_right, std::size_t const xx_n)
+{
+    for (std::size_t i = 0; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right[i]);
+}
+
+template<op tpOp, typename tpDataType>
+void broadcast_scalar(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const xx_right, std::size_t const xx_n)
+{
+    for (std::size_t i = 0; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right);
+}
+
+template<std::size_t tpRows, typename tpDataType>
+void dot_scalar(tpDataType * xx_out, tpDataType const * const * xx_rows, tpDataType const * xx_x, std::size_t const xx_n)
+{
+    tpDataType sum[tpRows];
+    for (std::size_t r = 0; r < tpRows; ++r)
+        sum[r] = static_cast<tpDataType>(0);
+    for (std::size_t i = 0; i < xx_n; ++i) {
+        for (std::size_t r = 0; r < tpRows; ++r)
+            sum[r] += xx_rows[r][i] * xx_x[i];
+    }
+    for (std::size_t r = 0; r < tpRows; ++r)
+        xx_out[r] = sum[r];
+}
+
+#if ASSIGNMENT_SIMD_X86
+
+/* ==== l  a  n  e  s ==== */
+
+/*! register type and primitive operations of one instruction set for one element type
+ */
+template<typename tpDataType> struct sse2_lanes;
+template<typename tpDataType> struct avx2_lanes;
+template<typename tpDataType> struct avx512_lanes;
+
+template<>
+struct sse2_lanes<float> {
+    using reg = __m128;
+    static constexpr std::size_t width = 4;
+    ASSIGNMENT_TARGET("sse2") static inline reg load(float const * p) { return _mm_loadu_ps(p); }
+    ASSIGNMENT_TARGET("sse2") static inline void store(float * p, reg x) { _mm_storeu_ps(p, x); }
+    ASSIGNMENT_TARGET("sse2") static inline reg set1(float x) { return _mm_set1_ps(x); }
+    ASSIGNMENT_TARGET("sse2") static inline reg add(reg x, reg y) { return _mm_add_ps(x, y); }
+    ASSIGNMENT_TARGET("sse2") static inline reg sub(reg x, reg y) { return _mm_sub_ps(x, y); }
+    ASSIGNMENT_TARGET("sse2") static inline reg mul(reg x, reg y) { return _mm_mul_ps(x, y); }
+};
+
+template<>
+struct sse2_lanes<double> {
+    using reg = __m128d;
+    static constexpr std::size_t width = 2;
+    ASSIGNMENT_TARGET("sse2") static inline reg load(double const * p) { return _mm_loadu_pd(p); }
+    ASSIGNMENT_TARGET("sse2") static inline void store(double * p, reg x) { _mm_storeu_pd(p, x); }
+    ASSIGNMENT_TARGET("sse2") static inline reg set1(double x) { return _mm_set1_pd(x); }
+    ASSIGNMENT_TARGET("sse2") static inline reg add(reg x, reg y) { return _mm_add_pd(x, y); }
+    ASSIGNMENT_TARGET("sse2") static inline reg sub(reg x, reg y) { return _mm_sub_pd(x, y); }
+    ASSIGNMENT_TARGET("sse2") static inline reg mul(reg x, reg y) { return _mm_mul_pd(x, y); }
+};
+
+template<>
+struct sse2_lanes<std::int32_t> {
+    using reg = __m128i;
+    static constexpr std::size_t width = 4;
+    ASSIGNMENT_TARGET("sse2") static inline reg load(std::int32_t const * p) { return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)); }
+    ASSIGNMENT_TARGET("sse2") static inline void store(std::int32_t * p, reg x) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), x); }
+    ASSIGNMENT_TARGET("sse2") static inline reg set1(std::int32_t x) { return _mm_set1_epi32(x); }
+    ASSIGNMENT_TARGET("sse2") static inline reg add(reg x, reg y) { return _mm_add_epi32(x, y); }
+    ASSIGNMENT_TARGET("sse2") static inline reg sub(reg x, reg y) { return _mm_sub_epi32(x, y); }
+    // SSE2 has no 32 bit low multiply; multiply even and odd lanes as 64 bit and interleave the low halves
+    ASSIGNMENT_TARGET("sse2") static inline reg mul(reg x, reg y)
+    {
+        reg const even = _mm_mul_epu32(x, y);
+        reg const odd = _mm_mul_epu32(_mm_srli_si128(x, 4), _mm_srli_si128(y, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+};
+
+template<>
+struct avx2_lanes<float> {
+    using reg = __m256;
+    static constexpr std::size_t width = 8;
+    ASSIGNMENT_TARGET("avx2") static inline reg load(float const * p) { return _mm256_loadu_ps(p); }
+    ASSIGNMENT_TARGET("avx2") static inline void store(float * p, reg x) { _mm256_storeu_ps(p, x); }
+    ASSIGNMENT_TARGET("avx2") static inline reg set1(float x) { return _mm256_set1_ps(x); }
+    ASSIGNMENT_TARGET("avx2") static inline reg add(reg x, reg y) { return _mm256_add_ps(x, y); }
+    ASSIGNMENT_TARGET("avx2") static inline reg sub(reg x, reg y) { return _mm256_sub_ps(x, y); }
+    ASSIGNMENT_TARGET("avx2") static inline reg mul(reg x, reg y) { return _mm256_mul_ps(x, y); }
+};
+
+template<>
+struct avx2_lanes<double> {
+    using reg = __m256d;
+    static constexpr std::size_t width = 4;
+    ASSIGNMENT_TARGET("avx2") static inline reg load(double const * p) { return _mm256_loadu_pd(p); }
+    ASSIGNMENT_TARGET("avx2") static inline void store(double * p, reg x) { _mm256_storeu_pd(p, x); }
+    ASSIGNMENT_TARGET("avx2") static inline reg set1(double x) { return _mm256_set1_pd(x); }
+    ASSIGNMENT_TARGET("avx2") static inline reg add(reg x, reg y) { return _mm256_add_pd(x, y); }
+    ASSIGNMENT_TARGET("avx2") static inline reg sub(reg x, reg y) { return _mm256_sub_pd(x, y); }
+    ASSIGNMENT_TARGET("avx2") static inline reg mul(reg x, reg y) { return _mm256_mul_pd(x, y); }
+};
+
+template<>
+struct avx2_lanes<std::int32_t> {
+    using reg = __m256i;
+    static constexpr std::size_t width = 8;
+    ASSIGNMENT_TARGET("avx2") static inline reg load(std::int32_t const * p) { return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)); }
+    ASSIGNMENT_TARGET("avx2") static inline void store(std::int32_t * p, reg x) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), x); }
+    ASSIGNMENT_TARGET("avx2") static inline reg set1(std::int32_t x) { return _mm256_set1_epi32(x); }
+    ASSIGNMENT_TARGET("avx2") static inline reg add(reg x, reg y) { return _mm256_add_epi32(x, y); }
+    ASSIGNMENT_TARGET("avx2") static inline reg sub(reg x, reg y) { return _mm256_sub_epi32(x, y); }
+    ASSIGNMENT_TARGET("avx2") static inline reg mul(reg x, reg y) { return _mm256_mullo_epi32(x, y); }
+};
+
+template<>
+struct avx512_lanes<float> {
+    using reg = __m512;
+    static constexpr std::size_t width = 16;
+    ASSIGNMENT_TARGET("avx512f") static inline reg load(float const * p) { return _mm512_loadu_ps(p); }
+    ASSIGNMENT_TARGET("avx512f") static inline void store(float * p, reg x) { _mm512_storeu_ps(p, x); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg set1(float x) { return _mm512_set1_ps(x); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg add(reg x, reg y) { return _mm512_add_ps(x, y); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg sub(reg x, reg y) { return _mm512_sub_ps(x, y); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg mul(reg x, reg y) { return _mm512_mul_ps(x, y); }
+};
+
+template<>
+struct avx512_lanes<double> {
+    using reg = __m512d;
+    static constexpr std::size_t width = 8;
+    ASSIGNMENT_TARGET("avx512f") static inline reg load(double const * p) { return _mm512_loadu_pd(p); }
+    ASSIGNMENT_TARGET("avx512f") static inline void store(double * p, reg x) { _mm512_storeu_pd(p, x); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg set1(double x) { return _mm512_set1_pd(x); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg add(reg x, reg y) { return _mm512_add_pd(x, y); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg sub(reg x, reg y) { return _mm512_sub_pd(x, y); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg mul(reg x, reg y) { return _mm512_mul_pd(x, y); }
+};
+
+template<>
+struct avx512_lanes<std::int32_t> {
+    using reg = __m512i;
+    static constexpr std::size_t width = 16;
+    ASSIGNMENT_TARGET("avx512f") static inline reg load(std::int32_t const * p) { return _mm512_loadu_si512(p); }
+    ASSIGNMENT_TARGET("avx512f") static inline void store(std::int32_t * p, reg x) { _mm512_storeu_si512(p, x); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg set1(std::int32_t x) { return _mm512_set1_epi32(x); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg add(reg x, reg y) { return _mm512_add_epi32(x, y); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg sub(reg x, reg y) { return _mm512_sub_epi32(x, y); }
+    ASSIGNMENT_TARGET("avx512f") static inline reg mul(reg x, reg y) { return _mm512_mullo_epi32(x, y); }
+};
+
+/* ==== k  e  r  n  e  l  s ==== */
+
+/*! the loops are spelled out once per instruction set, as the target attribute has to sit on the function doing the work
+ */
+#define ASSIGNMENT_SIMD_APPLY(xx_lanes, xx_x, xx_y) \
+    (tpOp == op::add ? xx_lanes::add(xx_x, xx_y) : tpOp == op::sub ? xx_lanes::sub(xx_x, xx_y) : xx_lanes::mul(xx_x, xx_y))
+
+template<op tpOp, typename tpDataType>
+ASSIGNMENT_TARGET("sse2")
+void binary_sse2(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const * xx_right, std::size_t const xx_n)
+{
+    using lanes = sse2_lanes<tpDataType>;
+    std::size_t i = 0;
+    for (; i + lanes::width <= xx_n; i += lanes::width)
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), lanes::load(xx_right + i)));
+    for (; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right[i]);
+}
+
+template<op tpOp, typename tpDataType>
+ASSIGNMENT_TARGET("sse2")
+void broadcast_sse2(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const xx_right, std::size_t const xx_n)
+{
+    using lanes = sse2_lanes<tpDataType>;
+    auto const right = lanes::set1(xx_right);
+    std::size_t i = 0;
+    for (; i + lanes::width <= xx_n; i += lanes::width)
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), right));
+    for (; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right);
+}
+
+template<op tpOp, typename tpDataType>
+ASSIGNMENT_TARGET("avx2")
+void binary_avx2(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const * xx_right, std::size_t const xx_n)
+{
+    using lanes = avx2_lanes<tpDataType>;
+    std::size_t i = 0;
+    for (; i + 2 * lanes::width <= xx_n; i += 2 * lanes::width) {
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), lanes::load(xx_right + i)));
+        lanes::store(xx_out + i + lanes::width,
+                     ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i + lanes::width), lanes::load(xx_right + i + lanes::width)));
+    }
+    for (; i + lanes::width <= xx_n; i += lanes::width)
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), lanes::load(xx_right + i)));
+    for (; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right[i]);
+}
+
+template<op tpOp, typename tpDataType>
+ASSIGNMENT_TARGET("avx2")
+void broadcast_avx2(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const xx_right, std::size_t const xx_n)
+{
+    using lanes = avx2_lanes<tpDataType>;
+    auto const right = lanes::set1(xx_right);
+    std::size_t i = 0;
+    for (; i + 2 * lanes::width <= xx_n; i += 2 * lanes::width) {
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), right));
+        lanes::store(xx_out + i + lanes::width, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i + lanes::width), right));
+    }
+    for (; i + lanes::width <= xx_n; i += lanes::width)
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), right));
+    for (; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right);
+}
+
+template<op tpOp, typename tpDataType>
+ASSIGNMENT_TARGET("avx512f")
+void binary_avx512(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const * xx_right, std::size_t const xx_n)
+{
+    using lanes = avx512_lanes<tpDataType>;
+    std::size_t i = 0;
+    for (; i + lanes::width <= xx_n; i += lanes::width)
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), lanes::load(xx_right + i)));
+    for (; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right[i]);
+}
+
+template<op tpOp, typename tpDataType>
+ASSIGNMENT_TARGET("avx512f")
+void broadcast_avx512(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const xx_right, std::size_t const xx_n)
+{
+    using lanes = avx512_lanes<tpDataType>;
+    auto const right = lanes::set1(xx_right);
+    std::size_t i = 0;
+    for (; i + lanes::width <= xx_n; i += lanes::width)
+        lanes::store(xx_out + i, ASSIGNMENT_SIMD_APPLY(lanes, lanes::load(xx_left + i), right));
+    for (; i < xx_n; ++i)
+        xx_out[i] = apply<tpOp>(xx_left[i], xx_right);
+}
+
+#undef ASSIGNMENT_SIMD_APPLY
+
+/*! the dot kernels keep one partial sum per lane and row; the lanes are added up in order once the rows are done
+ */
+template<std::size_t tpRows, typename tpDataType>
+ASSIGNMENT_TARGET("sse2")
+void dot_sse2(tpDataType * xx_out, tpDataType const * const * xx_rows, tpDataType const * xx_x, std::size_t const xx_n)
+{
+    using lanes = sse2_lanes<tpDataType>;
+    typename lanes::reg sum[tpRows];
+    for (std::size_t r = 0; r < tpRows; ++r)
+        sum[r] = lanes::set1(static_cast<tpDataType>(0));
+    std::size_t i = 0;
+    for (; i + lanes::width <= xx_n; i += lanes::width) {
+        auto const x = lanes::load(xx_x + i);
+        for (std::size_t r = 0; r < tpRows; ++r)
+            sum[r] = lanes::add(sum[r], lanes::mul(lanes::load(xx_rows[r] + i), x));
+    }
+    alignas(64) tpDataType lane[lanes::width];
+    for (std::size_t r = 0; r < tpRows; ++r) {
+        lanes::store(lane, sum[r]);
+        tpDataType total = lane[0];
+        for (std::size_t w = 1; w < lanes::width; ++w)
+            total += lane[w];
+        for (std::size_t j = i; j < xx_n; ++j)
+            total += xx_rows[r][j] * xx_x[j];
+        xx_out[r] = total;
+    }
+}
+
+template<std::size_t tpRows, typename tpDataType>
+ASSIGNMENT_TARGET("avx2")
+void dot_avx2(tpDataType * xx_out, tpDataType const * const * xx_rows, tpDataType const * xx_x, std::size_t const xx_n)
+{
+    using lanes = avx2_lanes<tpDataType>;
+    typename lanes::reg sum[tpRows];
+    for (std::size_t r = 0; r < tpRows; ++r)
+        sum[r] = lanes::set1(static_cast<tpDataType>(0));
+    std::size_t i = 0;
+    for (; i + lanes::width <= xx_n; i += lanes::width) {
+        auto const x = lanes::load(xx_x + i);
+        for (std::size_t r = 0; r < tpRows; ++r)
+            sum[r] = lanes::add(sum[r], lanes::mul(lanes::load(xx_rows[r] + i), x));
+    }
+    alignas(64) tpDataType lane[lanes::width];
+    for (std::size_t r = 0; r < tpRows; ++r) {
+        lanes::store(lane, sum[r]);
+        tpDataType total = lane[0];
+        for (std::size_t w = 1; w < lanes::width; ++w)
+            total += lane[w];
+        for (std::size_t j = i; j < xx_n; ++j)
+            total += xx_rows[r][j] * xx_x[j];
+        xx_out[r] = total;
+    }
+}
+
+template<std::size_t tpRows, typename tpDataType>
+ASSIGNMENT_TARGET("avx512f")
+void dot_avx512(tpDataType * xx_out, tpDataType const * const * xx_rows, tpDataType const * xx_x, std::size_t const xx_n)
+{
+    using lanes = avx512_lanes<tpDataType>;
+    typename lanes::reg sum[tpRows];
+    for (std::size_t r = 0; r < tpRows; ++r)
+        sum[r] = lanes::set1(static_cast<tpDataType>(0));
+    std::size_t i = 0;
+    for (; i + lanes::width <= xx_n; i += lanes::width) {
+        auto const x = lanes::load(xx_x + i);
+        for (std::size_t r = 0; r < tpRows; ++r)
+            sum[r] = lanes::add(sum[r], lanes::mul(lanes::load(xx_rows[r] + i), x));
+    }
+    alignas(64) tpDataType lane[lanes::width];
+    for (std::size_t r = 0; r < tpRows; ++r) {
+        lanes::store(lane, sum[r]);
+        tpDataType total = lane[0];
+        for (std::size_t w = 1; w < lanes::width; ++w)
+            total += lane[w];
+        for (std::size_t j = i; j < xx_n; ++j)
+            total += xx_rows[r][j] * xx_x[j];
+        xx_out[r] = total;
+    }
+}
+
+#endif
+
+/* ==== d  i  s  p  a  t  c  h ==== */
+
+template<op tpOp, typename tpDataType>
+using binary_kernel = void (*)(tpDataType *, tpDataType const *, tpDataType const *, std::size_t);
+
+template<op tpOp, typename tpDataType>
+using broadcast_kernel = void (*)(tpDataType *, tpDataType const *, tpDataType, std::size_t);
+
+template<op tpOp, typename tpDataType>
+binary_kernel<tpOp, tpDataType> select_binary()
+{
+#if ASSIGNMENT_SIMD_X86
+    switch (active()) {
+    case isa::avx512:
+        return &binary_avx512<tpOp, tpDataType>;
+    case isa::avx2:
+        return &binary_avx2<tpOp, tpDataType>;
+    case isa::sse2:
+        return &binary_sse2<tpOp, tpDataType>;
+    default:
+        break;
+    }
+#endif
+    return &binary_scalar<tpOp, tpDataType>;
+}
+
+template<op tpOp, typename tpDataType>
+broadcast_kernel<tpOp, tpDataType> select_broadcast()
+{
+#if ASSIGNMENT_SIMD_X86
+    switch (active()) {
+    case isa::avx512:
+        return &broadcast_avx512<tpOp, tpDataType>;
+    case isa::avx2:
+        return &broadcast_avx2<tpOp, tpDataType>;
+    case isa::sse2:
+        return &broadcast_sse2<tpOp, tpDataType>;
+    default:
+        break;
+    }
+#endif
+    return &broadcast_scalar<tpOp, tpDataType>;
+}
+
+template<std::size_t tpRows, typename tpDataType>
+using dot_kernel = void (*)(tpDataType *, tpDataType const * const *, tpDataType const *, std::size_t);
+
+template<std::size_t tpRows, typename tpDataType>
+dot_kernel<tpRows, tpDataType> select_dot()
+{
+#if ASSIGNMENT_SIMD_X86
+    switch (active()) {
+    case isa::avx512:
+        return &dot_avx512<tpRows, tpDataType>;
+    case isa::avx2:
+        return &dot_avx2<tpRows, tpDataType>;
+    case isa::sse2:
+        return &dot_sse2<tpRows, tpDataType>;
+    default:
+        break;
+    }
+#endif
+    return &dot_scalar<tpRows, tpDataType>;
+}
+
+/*! xx_out[i] = xx_left[i] (op) xx_right[i] for i in [0, xx_n)
+ \note xx_out may be the same array as either operand.
+ */
+template<op tpOp, typename tpDataType>
+void binary(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const * xx_right, std::size_t const xx_n)
+{
+    if constexpr (has_kernels<tpDataType>::value) {
+        static binary_kernel<tpOp, tpDataType> const kernel = select_binary<tpOp, tpDataType>();
+        kernel(xx_out, xx_left, xx_right, xx_n);
+    } else {
+        binary_scalar<tpOp>(xx_out, xx_left, xx_right, xx_n);
+    }
+}
+
+/*! xx_out[i] = xx_left[i] (op) xx_right for i in [0, xx_n)
+ \note xx_out may be the same array as xx_left.
+ */
+template<op tpOp, typename tpDataType>
+void broadcast(tpDataType * xx_out, tpDataType const * xx_left, tpDataType const & xx_right, std::size_t const xx_n)
+{
+    if constexpr (has_kernels<tpDataType>::value) {
+        static broadcast_kernel<tpOp, tpDataType> const kernel = select_broadcast<tpOp, tpDataType>();
+        kernel(xx_out, xx_left, xx_right, xx_n);
+    } else {
+        broadcast_scalar<tpOp>(xx_out, xx_left, xx_right, xx_n);
+    }
+}
+
+/*! xx_out[r] = sum of xx_rows[r][i] * xx_x[i] over i in [0, xx_n), for the tpRows rows at once
+ \note the rows share every load of xx_x. The hand-written kernels sum each lane separately, so float and double results
+ may differ from a sequential loop in the last bits.
+ */
+template<std::size_t tpRows, typename tpDataType>
+void dot(tpDataType * xx_out, tpDataType const * const * xx_rows, tpDataType const * xx_x, std::size_t const xx_n)
+{
+    if constexpr (has_kernels<tpDataType>::value) {
+        static dot_kernel<tpRows, tpDataType> const kernel = select_dot<tpRows, tpDataType>();
+        kernel(xx_out, xx_rows, xx_x, xx_n);
+    } else {
+        dot_scalar<tpRows>(xx_out, xx_rows, xx_x, xx_n);
+    }
+}
+
+}
+}
+}
+
+#endif /* simd_h */
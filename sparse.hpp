@@ -0,0 +1,492 @@
+/*
+ //  sparse.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the template for sparse matrices in compressed sparse row (CSR) or column (CSC) format: only the
+ nonzeros are stored, with their column (row) index, grouped by row (column). They are built from a dense
+ assignment::matrix or from (row, column, value) triplets and multiply dense vectors and matrices in O(nonzeros).
+ */
+#ifndef sparse_h
+#define sparse_h
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+
+/*! storage order of a sparse matrix
+ */
+enum class sparse_format {
+    csr, //!< nonzeros grouped by row, each with its column index
+    csc  //!< nonzeros grouped by column, each with its row index
+};
+
+/*! one element of a sparse matrix given by position
+ */
+template<typename tpDataType>
+struct triplet {
+    std::size_t row;
+    std::size_t col;
+    tpDataType value;
+};
+
+namespace detail {
+
+/*! fewest nonzeros a thread works on in a sparse product; below this the threading overhead dominates
+ */
+constexpr std::size_t sparse_min_panel = std::size_t(1) << 15;
+
+/*! xx_out[first:last] += xx_value * xx_in[first:last]
+ */
+template<typename tpDataType>
+void sparse_axpy(tpDataType * xx_out, tpDataType const * xx_in, tpDataType const xx_value, std::size_t const xx_first,
+                 std::size_t const xx_last)
+{
+    for (std::size_t j = xx_first; j < xx_last; ++j)
+        xx_out[j] += xx_value * xx_in[j];
+}
+
+/*! splits the xx_dim segments described by xx_offsets into panels holding about the same number of nonzeros, and calls
+ xx_function(first, last) for each panel, on all threads of the pool if tpParallel
+ \param xx_width operations per nonzero (Ex: the columns of the dense operand)
+ \note rows rather than nonzeros would leave a thread with all the work on graphs with a few dense rows.
+ */
+template<bool tpParallel, typename tpFunction>
+void for_each_panel(std::vector<std::size_t> const & xx_offsets, std::size_t const xx_dim, std::size_t const xx_width,
+                    tpFunction const & xx_function)
+{
+    std::size_t const nonzeros = xx_offsets[xx_dim];
+    std::size_t panels = 1;
+    if (tpParallel && nonzeros * xx_width >= 2 * sparse_min_panel)
+        panels = std::min(4 * pool_threads(), nonzeros * xx_width / sparse_min_panel);
+    if (panels == 1) {
+        xx_function(std::size_t(0), xx_dim);
+        return;
+    }
+
+    auto const boundary = [&](std::size_t const xx_panel) -> std::size_t {
+        if (xx_panel >= panels)
+            return xx_dim;
+        auto const first = std::lower_bound(xx_offsets.begin(), xx_offsets.begin() + xx_dim, nonzeros / panels * xx_panel);
+        return static_cast<std::size_t>(first - xx_offsets.begin());
+    };
+    parallel_for(panels, [&](std::size_t const xx_panel) {
+        std::size_t const first = boundary(xx_panel);
+        std::size_t const last = boundary(xx_panel + 1);
+        if (first < last)
+            xx_function(first, last);
+    });
+}
+
+}
+
+/*! sparse matrix in compressed row or column storage
+ \tparam tpDataType element type
+ \tparam tpFormat sparse_format::csr or sparse_format::csc
+ \tparam tpPolicyType policy of the products; under Parallel they are split over the thread pool
+ \note rows and columns are limited to 2^32 so each nonzero costs sizeof(tpDataType) + 4 bytes (12 for double);
+ within a row (column) the indices are strictly increasing.
+ */
+template<typename tpDataType, sparse_format tpFormat = sparse_format::csr, template<typename > class tpPolicyType = NonParallel>
+class sparse_matrix {
+public:
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = tpDataType;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /*! type of the stored row or column indices
+     */
+    using index_type = std::uint32_t;
+
+    static constexpr sparse_format format = tpFormat;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor of an all-zero matrix
+     \param xx_dimR row dimension of the matrix
+     \param xx_dimC column dimension of the matrix
+     \throw std::domain_error if a dimension exceeds the index type
+     */
+    explicit sparse_matrix(size_type const xx_dimR, size_type const xx_dimC) :
+                    m_dimR(xx_dimR),
+                    m_dimC(xx_dimC),
+                    m_offsets(major(xx_dimR, xx_dimC) + 1, 0)
+    {
+        if (xx_dimR > std::numeric_limits<index_type>::max() || xx_dimC > std::numeric_limits<index_type>::max())
+            throw std::domain_error("Sparse matrix dimension exceeds the index type");
+    }
+
+    /*! constructor from a dense matrix; elements equal to zero are not stored
+     */
+    template<template<typename > class tpOtherPolicyType, typename tpAllocatorType>
+    explicit sparse_matrix(matrix<tpDataType, tpOtherPolicyType, tpAllocatorType> const & xx_matrix) :
+                    sparse_matrix(xx_matrix.dimR(), xx_matrix.dimC())
+    {
+        size_type const majors = major(m_dimR, m_dimC);
+        size_type const minors = minor(m_dimR, m_dimC);
+        for (size_type i = 0; i < majors; ++i) {
+            for (size_type j = 0; j < minors; ++j) {
+                tpDataType const & value = tpFormat == sparse_format::csr ? xx_matrix(i, j) : xx_matrix(j, i);
+                if (value != static_cast<tpDataType>(0)) {
+                    m_indices.push_back(static_cast<index_type>(j));
+                    m_values.push_back(value);
+                }
+            }
+            m_offsets[i + 1] = m_values.size();
+        }
+    }
+
+    /*! constructor from (row, column, value) triplets in any order; values at the same position are summed
+     \throw std::domain_error if a triplet lies outside the matrix
+     */
+    explicit sparse_matrix(size_type const xx_dimR, size_type const xx_dimC, std::vector<triplet<tpDataType>> const & xx_triplets) :
+                    sparse_matrix(xx_dimR, xx_dimC)
+    {
+        size_type const majors = major(m_dimR, m_dimC);
+
+        // bucket by row (column), then sort and merge each bucket by column (row)
+        std::vector<size_type> starts(majors + 1, 0);
+        for (auto const & entry : xx_triplets) {
+            if (entry.row >= m_dimR || entry.col >= m_dimC)
+                throw std::domain_error("Triplet outside the matrix");
+            ++starts[major(entry.row, entry.col) + 1];
+        }
+        for (size_type i = 0; i < majors; ++i)
+            starts[i + 1] += starts[i];
+
+        std::vector<std::pair<index_type, tpDataType>> entries(xx_triplets.size());
+        std::vector<size_type> next(starts.begin(), starts.end() - 1);
+        for (auto const & entry : xx_triplets)
+            entries[next[major(entry.row, entry.col)]++] = {static_cast<index_type>(minor(entry.row, entry.col)), entry.value};
+
+        m_indices.reserve(entries.size());
+        m_values.reserve(entries.size());
+        for (size_type i = 0; i < majors; ++i) {
+            auto const first = entries.begin() + static_cast<std::ptrdiff_t>(starts[i]);
+            auto const last = entries.begin() + static_cast<std::ptrdiff_t>(starts[i + 1]);
+            std::stable_sort(first, last, [](auto const & xx_left, auto const & xx_right) {
+                return xx_left.first < xx_right.first;
+            });
+            for (auto entry = first; entry != last; ++entry) {
+                if (m_values.size() > m_offsets[i] && m_indices.back() == entry->first) {
+                    m_values.back() += entry->second;
+                } else {
+                    m_indices.push_back(entry->first);
+                    m_values.push_back(entry->second);
+                }
+            }
+            m_offsets[i + 1] = m_values.size();
+        }
+    }
+
+    /*! constructor from the other format, with the same policy
+     */
+    template<sparse_format tpOtherFormat, typename std::enable_if<tpOtherFormat != tpFormat>::type* = nullptr>
+    explicit sparse_matrix(sparse_matrix<tpDataType, tpOtherFormat, tpPolicyType> const & xx_matrix) :
+                    sparse_matrix(xx_matrix.dimR(), xx_matrix.dimC())
+    {
+        size_type const majors = major(m_dimR, m_dimC);
+        size_type const minors = minor(m_dimR, m_dimC);
+        auto const & offsets = xx_matrix.offsets();
+        auto const & indices = xx_matrix.indices();
+        auto const & values = xx_matrix.values();
+
+        // walking the other format in order fills every row (column) here in increasing index order
+        for (index_type const index : indices)
+            ++m_offsets[index + 1];
+        for (size_type i = 0; i < majors; ++i)
+            m_offsets[i + 1] += m_offsets[i];
+
+        m_indices.resize(values.size());
+        m_values.resize(values.size());
+        std::vector<size_type> next(m_offsets.begin(), m_offsets.end() - 1);
+        for (size_type j = 0; j < minors; ++j) {
+            for (size_type k = offsets[j]; k < offsets[j + 1]; ++k) {
+                size_type const target = next[indices[k]]++;
+                m_indices[target] = static_cast<index_type>(j);
+                m_values[target] = values[k];
+            }
+        }
+    }
+
+    /*! conversion to a dense matrix
+     */
+    template<template<typename > class tpOtherPolicyType, typename tpAllocatorType>
+    operator matrix<tpDataType, tpOtherPolicyType, tpAllocatorType>() const
+    {
+        matrix<tpDataType, tpOtherPolicyType, tpAllocatorType> result(m_dimR, m_dimC, static_cast<tpDataType>(0));
+        for (size_type i = 0; i < major(m_dimR, m_dimC); ++i) {
+            for (size_type k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+                if (tpFormat == sparse_format::csr)
+                    result(i, m_indices[k]) = m_values[k];
+                else
+                    result(m_indices[k], i) = m_values[k];
+            }
+        }
+        return result;
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    sparse_matrix & operator*=(tpDataType const & xx_scalar)
+    {
+        detail::simd::broadcast<detail::simd::op::mul>(m_values.data(), m_values.data(), xx_scalar, m_values.size());
+        return *this;
+    }
+
+    /*! element (R, C), zero if not stored
+     \note binary search within the row (column)
+     */
+    tpDataType operator()(size_type const xx_R, size_type const xx_C) const
+    {
+        size_type const i = major(xx_R, xx_C);
+        auto const first = m_indices.begin() + static_cast<std::ptrdiff_t>(m_offsets[i]);
+        auto const last = m_indices.begin() + static_cast<std::ptrdiff_t>(m_offsets[i + 1]);
+        auto const found = std::lower_bound(first, last, static_cast<index_type>(minor(xx_R, xx_C)));
+        return found != last && *found == minor(xx_R, xx_C) ? m_values[static_cast<size_type>(found - m_indices.begin())] : static_cast<tpDataType>(0);
+    }
+
+    /*! the transposed matrix in the other format; the stored arrays are the same, so this only copies them
+     */
+    sparse_matrix<tpDataType, tpFormat == sparse_format::csr ? sparse_format::csc : sparse_format::csr, tpPolicyType> transpose() const
+    {
+        sparse_matrix<tpDataType, tpFormat == sparse_format::csr ? sparse_format::csc : sparse_format::csr, tpPolicyType> result(m_dimC, m_dimR);
+        result.assign(std::vector<size_type>(m_offsets), std::vector<index_type>(m_indices), std::vector<tpDataType>(m_values));
+        return result;
+    }
+
+    /* ==== g  e  t  t  e  r  s ==== */
+
+    size_type dimR() const
+    {
+        return m_dimR;
+    }
+
+    size_type dimC() const
+    {
+        return m_dimC;
+    }
+
+    /*! number of stored elements
+     */
+    size_type nonzeros() const
+    {
+        return m_values.size();
+    }
+
+    /*! start of each row (column) in indices() and values(), followed by nonzeros()
+     */
+    std::vector<size_type> const & offsets() const
+    {
+        return m_offsets;
+    }
+
+    /*! column (row) index of each stored element
+     */
+    std::vector<index_type> const & indices() const
+    {
+        return m_indices;
+    }
+
+    std::vector<tpDataType> const & values() const
+    {
+        return m_values;
+    }
+
+    /*! replaces the stored arrays, which must describe a valid matrix of the current dimensions
+     \throw std::domain_error if the array sizes do not fit together
+     */
+    void assign(std::vector<size_type> && xx_offsets, std::vector<index_type> && xx_indices, std::vector<tpDataType> && xx_values)
+    {
+        if (xx_offsets.size() != major(m_dimR, m_dimC) + 1 || xx_indices.size() != xx_values.size() || xx_offsets.back() != xx_values.size())
+            throw std::domain_error("Sparse arrays do not fit the matrix");
+        m_offsets = std::move(xx_offsets);
+        m_indices = std::move(xx_indices);
+        m_values = std::move(xx_values);
+    }
+
+private:
+
+    /*! index of the row (column) and of the element within it
+     */
+    static size_type major(size_type const xx_R, size_type const xx_C)
+    {
+        return tpFormat == sparse_format::csr ? xx_R : xx_C;
+    }
+
+    static size_type minor(size_type const xx_R, size_type const xx_C)
+    {
+        return tpFormat == sparse_format::csr ? xx_C : xx_R;
+    }
+
+    size_type m_dimR;
+    size_type m_dimC;
+    std::vector<size_type> m_offsets;
+    std::vector<index_type> m_indices;
+    std::vector<tpDataType> m_values;
+};
+
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+using csr_matrix = sparse_matrix<tpDataType, sparse_format::csr, tpPolicyType>;
+
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+using csc_matrix = sparse_matrix<tpDataType, sparse_format::csc, tpPolicyType>;
+
+/* ==== f  r  e  e     o  p  e  r  a  t  o  r  s ==== */
+
+template<typename tpDataType, sparse_format tpFormat, template<typename > class tpPolicyType>
+sparse_matrix<tpDataType, tpFormat, tpPolicyType> operator*(sparse_matrix<tpDataType, tpFormat, tpPolicyType> xx_matrix, tpDataType const & xx_scalar)
+{
+    xx_matrix *= xx_scalar;
+    return xx_matrix;
+}
+
+template<typename tpDataType, sparse_format tpFormat, template<typename > class tpPolicyType>
+sparse_matrix<tpDataType, tpFormat, tpPolicyType> operator*(tpDataType const & xx_scalar, sparse_matrix<tpDataType, tpFormat, tpPolicyType> xx_matrix)
+{
+    xx_matrix *= xx_scalar;
+    return xx_matrix;
+}
+
+namespace detail {
+
+/*! y = A * x for the dimC() elements of xx_x and the dimR() elements of xx_y, see the SpMV operator*
+ \note writes into storage of the caller, so repeated products (Ex: the iterations of a solver) do not allocate.
+ */
+template<typename tpDataType, sparse_format tpFormat, template<typename > class tpPolicyType>
+void sparse_vector_multiply(sparse_matrix<tpDataType, tpFormat, tpPolicyType> const & xx_matrix, tpDataType const * xx_x, tpDataType * xx_y)
+{
+    auto const & offsets = xx_matrix.offsets();
+    auto const * const indices = xx_matrix.indices().data();
+    auto const * const values = xx_matrix.values().data();
+
+    if constexpr (tpFormat == sparse_format::csr) {
+        constexpr bool parallel = tpPolicyType<matrix<tpDataType, tpPolicyType>>::is_parallel;
+        for_each_panel<parallel>(offsets, xx_matrix.dimR(), 1, [&](std::size_t const xx_first, std::size_t const xx_last) {
+            for (std::size_t R = xx_first; R < xx_last; ++R) {
+                tpDataType sum = static_cast<tpDataType>(0);
+                for (std::size_t k = offsets[R]; k < offsets[R + 1]; ++k)
+                    sum += values[k] * xx_x[indices[k]];
+                xx_y[R] = sum;
+            }
+        });
+    } else {
+        std::fill(xx_y, xx_y + xx_matrix.dimR(), static_cast<tpDataType>(0));
+        for (std::size_t C = 0; C < xx_matrix.dimC(); ++C) {
+            tpDataType const xC = xx_x[C];
+            for (std::size_t k = offsets[C]; k < offsets[C + 1]; ++k)
+                xx_y[indices[k]] += values[k] * xC;
+        }
+    }
+}
+
+}
+
+/*! sparse matrix-vector multiplication (SpMV)
+ \note CSR computes one dot product per row, split over the threads by nonzeros under Parallel. CSC scatters every column into
+ the result and runs on one thread; use the CSR form for large multithreaded products.
+ \throw std::domain_error if Number of columns_A != dimension of vector
+ */
+template<typename tpDataType, sparse_format tpFormat, template<typename > class tpPolicyType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType> operator*(sparse_matrix<tpDataType, tpFormat, tpPolicyType> const & xx_matrix,
+                                                          assignment::vector<tpDataType, tpAllocatorType> const & xx_vector)
+{
+    if (xx_matrix.dimC() != xx_vector.dim())
+        throw std::domain_error("Number of columns_A != dimension of vector");
+
+    assignment::vector<tpDataType, tpAllocatorType> result(xx_matrix.dimR());
+    detail::sparse_vector_multiply(xx_matrix, xx_vector.data(), result.data());
+    return result;
+}
+
+/*! sparse-dense matrix multiplication (SpMM); the result has the type of the dense operand
+ \note every nonzero A(R, K) adds A(R, K) * B(K, :) to C(R, :), so the dense rows are streamed with unit stride. Under Parallel,
+ CSR splits the rows of C by nonzeros and CSC splits the columns of C.
+ \throw std::domain_error if Number of columns_A != Number of rows_B
+ */
+template<typename tpDataType, sparse_format tpFormat, template<typename > class tpPolicyType,
+                template<typename > class tpOtherPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpOtherPolicyType, tpAllocatorType> operator*(sparse_matrix<tpDataType, tpFormat, tpPolicyType> const & xx_left,
+                                                                 matrix<tpDataType, tpOtherPolicyType, tpAllocatorType> const & xx_right)
+{
+    if (xx_left.dimC() != xx_right.dimR())
+        throw std::domain_error("Number of columns_A != Number of rows_B");
+
+    constexpr bool parallel = tpPolicyType<matrix<tpDataType, tpPolicyType>>::is_parallel;
+    auto const & offsets = xx_left.offsets();
+    auto const * const indices = xx_left.indices().data();
+    auto const * const values = xx_left.values().data();
+    std::size_t const dimN = xx_right.dimC();
+    tpDataType const * const B = xx_right.data();
+
+    matrix<tpDataType, tpOtherPolicyType, tpAllocatorType> result(xx_left.dimR(), dimN, static_cast<tpDataType>(0));
+    tpDataType * const C = result.data();
+
+    if constexpr (tpFormat == sparse_format::csr) {
+        detail::for_each_panel<parallel>(offsets, xx_left.dimR(), dimN, [&](std::size_t const xx_first, std::size_t const xx_last) {
+            for (std::size_t R = xx_first; R < xx_last; ++R) {
+                for (std::size_t k = offsets[R]; k < offsets[R + 1]; ++k)
+                    detail::sparse_axpy(C + R * dimN, B + indices[k] * dimN, values[k], 0, dimN);
+            }
+        });
+    } else {
+        // column panels of whole cache lines, so no two threads write to the same line of C
+        constexpr std::size_t line = 64 / sizeof(tpDataType) > 0 ? 64 / sizeof(tpDataType) : 1;
+        std::size_t panels = 1;
+        if (parallel && xx_left.nonzeros() * dimN >= 2 * detail::sparse_min_panel)
+            panels = std::max<std::size_t>(1, std::min(detail::pool_threads(), (dimN + line - 1) / line));
+        std::size_t const width = ((dimN + panels - 1) / panels + line - 1) / line * line;
+        auto const columns = [&](std::size_t const xx_panel) {
+            std::size_t const first = std::min(dimN, xx_panel * width);
+            std::size_t const last = std::min(dimN, first + width);
+            for (std::size_t K = 0; K < xx_left.dimC(); ++K) {
+                for (std::size_t k = offsets[K]; k < offsets[K + 1]; ++k)
+                    detail::sparse_axpy(C + indices[k] * dimN, B + K * dimN, values[k], first, last);
+            }
+        };
+        if (panels == 1)
+            columns(0);
+        else
+            detail::parallel_for(panels, columns);
+    }
+    return result;
+}
+
+/*! output matrix to std::cout
+ */
+template<typename tpDataType, sparse_format tpFormat, template<typename > class tpPolicyType>
+std::ostream& operator<<(std::ostream& os, sparse_matrix<tpDataType, tpFormat, tpPolicyType> const & xx_matrix)
+{
+    os << '[';
+    for (std::size_t R = 0; R < xx_matrix.dimR(); ++R) {
+        if (R > 0)
+            os << ",\n ";
+
+        for (std::size_t C = 0; C < xx_matrix.dimC(); ++C)
+            os << xx_matrix(R, C) << " ";
+    }
+    os << ']';
+    return os;
+}
+
+}
+
+#endif /* sparse_h */
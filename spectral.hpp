@@ -0,0 +1,660 @@
+/*
+ //  spectral.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the solvers for a few dominant eigenpairs and singular triplets of large matrices.
+ lanczos_solver finds the top k eigenpairs of a symmetric operator with the thick-restart Lanczos method: it only applies
+ the operator to vectors, through apply_operator (see iterative.hpp), and keeps its basis as the rows of one matrix, so
+ the orthogonalization and the restarts are matrix-vector and matrix products of the multiply policy.
+ randomized_svd finds the top k singular triplets of a dense matrix from its products with a random block of vectors
+ (Halko, Martinsson and Tropp, 2011), all of which are blocked GEMMs of the policy, refined by power iterations until the
+ estimates settle.
+ */
+#ifndef spectral_h
+#define spectral_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "iterative.hpp"
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "qr.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+
+/*! the end of the spectrum lanczos_solver looks for
+ */
+enum class spectrum_end {
+    largest_magnitude,
+    largest_algebraic,
+    smallest_algebraic
+};
+
+/*! tolerance, iteration limits and thread use of the spectral solvers
+ */
+struct spectral_options {
+
+    /*! Lanczos: a Ritz pair is converged once ||A * x - theta * x|| <= tolerance * ||A||, with ||A|| estimated by the
+     largest Ritz value. randomized SVD: power iterations stop once no estimated singular value moves by more than
+     tolerance relative to the largest
+     */
+    double tolerance = 1e-8;
+
+    /*! Lanczos: most restarts; randomized SVD: most power iterations
+     */
+    std::size_t max_iterations = 300;
+
+    /*! Lanczos: basis vectors kept between restarts; 0 for max(2 * k + 1, k + 20), at most the dimension
+     */
+    std::size_t subspace = 0;
+
+    /*! randomized SVD: random vectors beyond k; the error decays faster with a few more
+     */
+    std::size_t oversampling = 10;
+
+    /*! seed of the random start vectors, so results are reproducible
+     */
+    std::uint64_t seed = 42;
+
+    /*! threads of the parallel products; 0 runs them on thread_pool::current(), otherwise on a pool of this many
+     threads started for the solve
+     */
+    std::size_t threads = 0;
+};
+
+/*! eigenpairs found by lanczos_solver
+ */
+template<typename tpMatrixType>
+struct eigen_result {
+
+    /*! eigenvalues, in the order of the requested end of the spectrum
+     */
+    vector<typename tpMatrixType::value_type, typename tpMatrixType::allocator_type> values;
+
+    /*! dimension x k; column i is the unit eigenvector of values[i]
+     */
+    tpMatrixType vectors;
+
+    /*! restarts done
+     */
+    std::size_t iterations;
+
+    /*! whether all k pairs reached the tolerance
+     */
+    bool converged;
+};
+
+/*! singular triplets found by randomized_svd, A ~ U * diag(values) * V^T
+ */
+template<typename tpMatrixType>
+struct svd_result {
+
+    /*! singular values, largest first
+     */
+    vector<typename tpMatrixType::value_type, typename tpMatrixType::allocator_type> values;
+
+    /*! dimR() x k left singular vectors
+     */
+    tpMatrixType U;
+
+    /*! dimC() x k right singular vectors
+     */
+    tpMatrixType V;
+
+    /*! power iterations done
+     */
+    std::size_t iterations;
+
+    /*! whether the estimates settled within the tolerance before max_iterations
+     */
+    bool converged;
+};
+
+namespace detail {
+
+/*! runs the parallel kernels of the calling thread on a pool of xx_threads threads while it lives; does nothing for 0
+ */
+class pool_override {
+public:
+
+    explicit pool_override(std::size_t const xx_threads)
+    {
+        if (xx_threads == 0)
+            return;
+        m_pool.reset(new thread_pool(xx_threads));
+        m_scope.reset(new thread_pool::scope(*m_pool));
+    }
+
+    pool_override(pool_override const &) = delete;
+    pool_override & operator=(pool_override const &) = delete;
+
+    ~pool_override()
+    {
+        m_scope.reset();
+        m_pool.reset();
+    }
+
+private:
+
+    std::unique_ptr<thread_pool> m_pool;
+    std::unique_ptr<thread_pool::scope> m_scope;
+};
+
+/*! applies the rotation (xx_cos, xx_sin) to columns xx_p and xx_q of the row-major xx_n x xx_cols matrix xx_a
+ */
+template<typename tpDataType>
+void rotate_columns(std::size_t const xx_n, std::size_t const xx_cols, tpDataType * xx_a, std::size_t const xx_p, std::size_t const xx_q,
+                    tpDataType const xx_cos, tpDataType const xx_sin)
+{
+    for (std::size_t i = 0; i < xx_n; ++i) {
+        tpDataType * const row = xx_a + i * xx_cols;
+        tpDataType const p = row[xx_p];
+        tpDataType const q = row[xx_q];
+        row[xx_p] = xx_cos * p - xx_sin * q;
+        row[xx_q] = xx_sin * p + xx_cos * q;
+    }
+}
+
+/*! eigenvalues and eigenvectors of the small symmetric row-major xx_n x xx_n matrix xx_a by cyclic Jacobi rotations
+ \param xx_a destroyed; its diagonal holds the eigenvalues on return
+ \param xx_vectors receives the orthonormal eigenvectors as its columns, xx_n x xx_n
+ \note quadratic convergence and accurate for the small projected matrices of the solvers; O(xx_n^3) per sweep.
+ */
+template<typename tpDataType>
+void symmetric_eigen(std::size_t const xx_n, tpDataType * xx_a, tpDataType * xx_vectors)
+{
+    std::fill(xx_vectors, xx_vectors + xx_n * xx_n, tpDataType(0));
+    for (std::size_t i = 0; i < xx_n; ++i)
+        xx_vectors[i * xx_n + i] = tpDataType(1);
+
+    tpDataType const eps = std::numeric_limits<tpDataType>::epsilon();
+    for (std::size_t sweep = 0; sweep < 64; ++sweep) {
+        bool rotated = false;
+        for (std::size_t p = 0; p + 1 < xx_n; ++p) {
+            for (std::size_t q = p + 1; q < xx_n; ++q) {
+                tpDataType const apq = xx_a[p * xx_n + q];
+                tpDataType const app = xx_a[p * xx_n + p];
+                tpDataType const aqq = xx_a[q * xx_n + q];
+                if (std::abs(apq) <= eps * std::sqrt(std::abs(app * aqq)) || apq == tpDataType(0))
+                    continue;
+                rotated = true;
+                tpDataType const theta = (aqq - app) / (2 * apq);
+                tpDataType const t = (theta >= 0 ? tpDataType(1) : tpDataType(-1)) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                tpDataType const c = tpDataType(1) / std::sqrt(t * t + 1);
+                tpDataType const s = t * c;
+
+                // A := J^T * A * J on rows and columns p and q
+                rotate_columns(xx_n, xx_n, xx_a, p, q, c, s);
+                for (std::size_t j = 0; j < xx_n; ++j) {
+                    tpDataType const ap = xx_a[p * xx_n + j];
+                    tpDataType const aq = xx_a[q * xx_n + j];
+                    xx_a[p * xx_n + j] = c * ap - s * aq;
+                    xx_a[q * xx_n + j] = s * ap + c * aq;
+                }
+                xx_a[p * xx_n + q] = xx_a[q * xx_n + p] = tpDataType(0);
+                rotate_columns(xx_n, xx_n, xx_vectors, p, q, c, s);
+            }
+        }
+        if (!rotated)
+            break;
+    }
+}
+
+/*! singular value decomposition G = U * diag(sigma) * W^T of the small row-major xx_n x xx_n matrix G by one-sided
+ Jacobi rotations, largest singular value first
+ \param xx_g destroyed; receives U as its columns
+ \param xx_sigma receives the xx_n singular values
+ \param xx_w receives W as its columns, xx_n x xx_n
+ \note rotates pairs of columns of G until all are orthogonal; the singular values are then the column norms, and small
+ ones keep their relative accuracy, unlike an eigendecomposition of G^T * G.
+ */
+template<typename tpDataType>
+void jacobi_svd(std::size_t const xx_n, tpDataType * xx_g, tpDataType * xx_sigma, tpDataType * xx_w)
+{
+    std::fill(xx_w, xx_w + xx_n * xx_n, tpDataType(0));
+    for (std::size_t i = 0; i < xx_n; ++i)
+        xx_w[i * xx_n + i] = tpDataType(1);
+
+    tpDataType const eps = std::numeric_limits<tpDataType>::epsilon();
+    for (std::size_t sweep = 0; sweep < 64; ++sweep) {
+        bool rotated = false;
+        for (std::size_t p = 0; p + 1 < xx_n; ++p) {
+            for (std::size_t q = p + 1; q < xx_n; ++q) {
+                tpDataType alpha = tpDataType(0), beta = tpDataType(0), gamma = tpDataType(0);
+                for (std::size_t i = 0; i < xx_n; ++i) {
+                    tpDataType const gp = xx_g[i * xx_n + p];
+                    tpDataType const gq = xx_g[i * xx_n + q];
+                    alpha += gp * gp;
+                    beta += gq * gq;
+                    gamma += gp * gq;
+                }
+                if (std::abs(gamma) <= eps * std::sqrt(alpha * beta) || gamma == tpDataType(0))
+                    continue;
+                rotated = true;
+                tpDataType const zeta = (beta - alpha) / (2 * gamma);
+                tpDataType const t = (zeta >= 0 ? tpDataType(1) : tpDataType(-1)) / (std::abs(zeta) + std::sqrt(zeta * zeta + 1));
+                tpDataType const c = tpDataType(1) / std::sqrt(t * t + 1);
+                tpDataType const s = t * c;
+                rotate_columns(xx_n, xx_n, xx_g, p, q, c, s);
+                rotate_columns(xx_n, xx_n, xx_w, p, q, c, s);
+            }
+        }
+        if (!rotated)
+            break;
+    }
+
+    // column norms, then columns sorted by them
+    std::vector<tpDataType> norms(xx_n, tpDataType(0));
+    for (std::size_t i = 0; i < xx_n; ++i) {
+        for (std::size_t j = 0; j < xx_n; ++j)
+            norms[j] += xx_g[i * xx_n + j] * xx_g[i * xx_n + j];
+    }
+    std::vector<std::size_t> order(xx_n);
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t const xx_l, std::size_t const xx_r) { return norms[xx_l] > norms[xx_r]; });
+
+    std::vector<tpDataType> g(xx_g, xx_g + xx_n * xx_n), w(xx_w, xx_w + xx_n * xx_n);
+    for (std::size_t j = 0; j < xx_n; ++j) {
+        std::size_t const from = order[j];
+        tpDataType const sigma = std::sqrt(norms[from]);
+        xx_sigma[j] = sigma;
+        for (std::size_t i = 0; i < xx_n; ++i) {
+            xx_g[i * xx_n + j] = sigma > tpDataType(0) ? g[i * xx_n + from] / sigma : tpDataType(i == j);
+            xx_w[i * xx_n + j] = w[i * xx_n + from];
+        }
+    }
+}
+
+/*! fills xx_out with independent standard normal numbers
+ */
+template<typename tpDataType>
+void fill_normal(tpDataType * xx_out, std::size_t const xx_n, std::mt19937_64 & xx_engine)
+{
+    std::normal_distribution<tpDataType> normal;
+    for (std::size_t i = 0; i < xx_n; ++i)
+        xx_out[i] = normal(xx_engine);
+}
+
+} // namespace detail
+
+/*! thick-restart Lanczos for the top k eigenpairs of a symmetric operator
+ \tparam tpDataType element type; floating point
+ \tparam tpPolicyType multiply policy of the orthogonalization and the restarts
+ \note every new basis vector is orthogonalized against the whole basis twice (classical Gram-Schmidt with
+ reorthogonalization), so the basis stays orthonormal to working precision and no spurious copies of eigenvalues appear.
+ At a restart the basis is contracted, with one matrix product, to the Ritz vectors of the wanted end of the spectrum and
+ the residual vector, and extended again from there. The workspace is allocated once by the constructor, so the restarts do
+ not allocate.
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpAllocatorType = aligned_allocator<tpDataType>>
+class lanczos_solver {
+public:
+
+    static_assert(std::is_floating_point<tpDataType>::value, "Spectral solvers need a floating point element type");
+
+    /*! type of the returned eigenvectors and of the basis
+     */
+    using matrix_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    /*! type of the vectors the operator is applied to
+     */
+    using vector_type = vector<tpDataType, tpAllocatorType>;
+
+    /*! type for the size of the vectors
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! allocates the workspace for xx_k eigenpairs of an operator of dimension xx_dim
+     \throw std::domain_error if xx_k is zero or exceeds xx_dim
+     */
+    explicit lanczos_solver(size_type const xx_dim, size_type const xx_k, spectral_options const & xx_options = spectral_options()) :
+                    m_options(xx_options),
+                    m_dim(xx_dim),
+                    m_k(xx_k),
+                    m_m(subspace(xx_dim, xx_k, xx_options.subspace)),
+                    m_basis(m_m + 1, xx_dim, tpDataType(0)),
+                    m_restarted(m_m, xx_dim),
+                    m_x(xx_dim),
+                    m_w(xx_dim),
+                    m_temp(xx_dim),
+                    m_h(m_m + 1),
+                    m_T(m_m * m_m),
+                    m_projection(m_m * m_m),
+                    m_ritz(m_m * m_m),
+                    m_theta(m_m),
+                    m_order(m_m)
+    {
+        m_temp_h.reserve(m_m * m_m);
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! the tolerance, restart limit, seed and threads of the next solves; the subspace stays the one of the constructor
+     */
+    spectral_options & options()
+    {
+        return m_options;
+    }
+
+    /*! the k eigenpairs of the symmetric xx_operator at xx_end of the spectrum
+     \note the operator is applied with apply_operator(xx_operator, x, y); see iterative.hpp.
+     */
+    template<typename tpOperator>
+    eigen_result<matrix_type> solve(tpOperator const & xx_operator, spectrum_end const xx_end = spectrum_end::largest_magnitude)
+    {
+        detail::pool_override const pool(m_options.threads);
+        std::mt19937_64 engine(m_options.seed);
+        tpDataType * const V = m_basis.data();
+        std::fill(m_T.begin(), m_T.end(), tpDataType(0));
+        detail::fill_normal(V, m_dim, engine);
+        scale_row(0, tpDataType(1) / row_norm(0));
+
+        size_type kept = 0;
+        size_type restarts = 0;
+        std::vector<tpDataType> & theta = m_theta;
+        std::vector<size_type> & order = m_order;
+        while (true) {
+            tpDataType const beta = extend(xx_operator, kept, engine);
+
+            // Ritz pairs of T, ordered by the wanted end of the spectrum; the residual of pair i is |beta * y_i(m - 1)|
+            std::copy(m_T.begin(), m_T.end(), m_projection.begin());
+            detail::symmetric_eigen(m_m, m_projection.data(), m_ritz.data());
+            for (size_type i = 0; i < m_m; ++i)
+                theta[i] = m_projection[i * m_m + i];
+            std::iota(order.begin(), order.end(), size_type(0));
+            std::stable_sort(order.begin(), order.end(), [&](size_type const xx_l, size_type const xx_r) {
+                if (xx_end == spectrum_end::largest_algebraic)
+                    return theta[xx_l] > theta[xx_r];
+                if (xx_end == spectrum_end::smallest_algebraic)
+                    return theta[xx_l] < theta[xx_r];
+                return std::abs(theta[xx_l]) > std::abs(theta[xx_r]);
+            });
+
+            tpDataType scale = tpDataType(0);
+            for (size_type i = 0; i < m_m; ++i)
+                scale = std::max(scale, std::abs(theta[i]));
+            bool converged = true;
+            for (size_type i = 0; i < m_k; ++i)
+                converged = converged && std::abs(beta * m_ritz[(m_m - 1) * m_m + order[i]]) <= m_options.tolerance * scale;
+
+            if (converged || restarts >= m_options.max_iterations || m_m == m_dim)
+                return result(restarts, converged);
+
+            kept = std::min(m_k + (m_m - m_k) / 2, m_m - 1);
+            restart(kept, beta);
+            ++restarts;
+        }
+    }
+
+private:
+
+    using policy = typename matrix_type::policy_type;
+
+    static size_type subspace(size_type const xx_dim, size_type const xx_k, size_type const xx_subspace)
+    {
+        if (xx_k == 0 || xx_k > xx_dim)
+            throw std::domain_error("Number of eigenpairs should be between 1 and the dimension");
+        size_type const wanted = xx_subspace != 0 ? xx_subspace : std::max(2 * xx_k + 1, xx_k + 20);
+        return std::min(std::max(wanted, xx_k + 1), xx_dim);
+    }
+
+    tpDataType * row(size_type const xx_i)
+    {
+        return m_basis.data() + xx_i * m_dim;
+    }
+
+    tpDataType row_norm(size_type const xx_i)
+    {
+        tpDataType result = tpDataType(0);
+        tpDataType const * const r = row(xx_i);
+        detail::simd::dot<1>(&result, &r, r, m_dim);
+        return std::sqrt(result);
+    }
+
+    void scale_row(size_type const xx_i, tpDataType const xx_scale)
+    {
+        detail::simd::broadcast<detail::simd::op::mul>(row(xx_i), row(xx_i), xx_scale, m_dim);
+    }
+
+    /*! w -= V(0:xx_count)^T * (V(0:xx_count) * w) twice; adds the coefficients to xx_h
+     */
+    void orthogonalize(size_type const xx_count, tpDataType * xx_w, tpDataType * xx_h)
+    {
+        std::ptrdiff_t const rs = static_cast<std::ptrdiff_t>(m_dim);
+        std::fill(xx_h, xx_h + xx_count, tpDataType(0));
+        std::vector<tpDataType> & h = m_temp_h;
+        h.resize(xx_count);
+        for (int pass = 0; pass < 2; ++pass) {
+            policy::vector_multiply(xx_count, m_dim, m_basis.data(), rs, 1, xx_w, 1, h.data());
+            policy::vector_multiply(m_dim, xx_count, m_basis.data(), 1, rs, h.data(), 1, m_temp.data());
+            detail::simd::binary<detail::simd::op::sub>(xx_w, xx_w, m_temp.data(), m_dim);
+            detail::simd::binary<detail::simd::op::add>(xx_h, xx_h, h.data(), xx_count);
+        }
+    }
+
+    /*! extends the basis from row xx_kept to m, filling T; returns the coupling beta of the residual vector, row m
+     */
+    template<typename tpOperator>
+    tpDataType extend(tpOperator const & xx_operator, size_type const xx_kept, std::mt19937_64 & xx_engine)
+    {
+        tpDataType beta = tpDataType(0);
+        tpDataType anorm = tpDataType(0);
+        for (size_type j = xx_kept; j < m_m; ++j) {
+            std::copy(row(j), row(j) + m_dim, m_x.data());
+            apply_operator(xx_operator, m_x, m_w);
+            orthogonalize(j + 1, m_w.data(), m_h.data());
+            for (size_type i = 0; i <= j; ++i) {
+                m_T[i * m_m + j] = m_h[i];
+                m_T[j * m_m + i] = m_h[i];
+                anorm = std::max(anorm, std::abs(m_h[i]));
+            }
+
+            std::copy(m_w.data(), m_w.data() + m_dim, row(j + 1));
+            beta = row_norm(j + 1);
+            if (beta > std::sqrt(std::numeric_limits<tpDataType>::epsilon()) * anorm) {
+                scale_row(j + 1, tpDataType(1) / beta);
+                continue;
+            }
+
+            // the basis spans an invariant subspace: continue with a random vector orthogonal to it, uncoupled from T
+            beta = tpDataType(0);
+            if (j + 1 == m_m)
+                break;
+            detail::fill_normal(row(j + 1), m_dim, xx_engine);
+            orthogonalize(j + 1, row(j + 1), m_h.data());
+            scale_row(j + 1, tpDataType(1) / row_norm(j + 1));
+        }
+        return beta;
+    }
+
+    /*! contracts the basis to the xx_kept wanted Ritz vectors followed by the residual vector, and T to their arrowhead
+     */
+    void restart(size_type const xx_kept, tpDataType const xx_beta)
+    {
+        // Y(:, order(0:kept))^T, kept x m
+        std::vector<tpDataType> & Y = m_temp_h;
+        Y.resize(xx_kept * m_m);
+        for (size_type i = 0; i < xx_kept; ++i) {
+            for (size_type j = 0; j < m_m; ++j)
+                Y[i * m_m + j] = m_ritz[j * m_m + m_order[i]];
+        }
+        policy::multiply(xx_kept, m_dim, m_m, Y.data(), static_cast<std::ptrdiff_t>(m_m), 1, m_basis.data(), static_cast<std::ptrdiff_t>(m_dim), 1,
+                         m_restarted.data(), static_cast<std::ptrdiff_t>(m_dim));
+        std::copy(row(m_m), row(m_m) + m_dim, row(xx_kept));
+        std::copy(m_restarted.data(), m_restarted.data() + xx_kept * m_dim, m_basis.data());
+
+        std::fill(m_T.begin(), m_T.end(), tpDataType(0));
+        for (size_type i = 0; i < xx_kept; ++i) {
+            m_T[i * m_m + i] = m_theta[m_order[i]];
+            tpDataType const coupling = xx_beta * Y[i * m_m + m_m - 1];
+            m_T[i * m_m + xx_kept] = coupling;
+            m_T[xx_kept * m_m + i] = coupling;
+        }
+    }
+
+    /*! the k wanted Ritz pairs; the vectors as the columns of a dimension x k matrix
+     */
+    eigen_result<matrix_type> result(size_type const xx_restarts, bool const xx_converged)
+    {
+        vector_type values(m_k);
+        std::vector<tpDataType> & Y = m_temp_h;
+        Y.resize(m_m * m_k);
+        for (size_type i = 0; i < m_k; ++i) {
+            values[i] = m_theta[m_order[i]];
+            for (size_type j = 0; j < m_m; ++j)
+                Y[j * m_k + i] = m_ritz[j * m_m + m_order[i]];
+        }
+        matrix_type vectors(m_dim, m_k);
+        policy::multiply(m_dim, m_k, m_m, m_basis.data(), 1, static_cast<std::ptrdiff_t>(m_dim), Y.data(), static_cast<std::ptrdiff_t>(m_k), 1,
+                         vectors.data(), static_cast<std::ptrdiff_t>(m_k));
+        return eigen_result<matrix_type>{std::move(values), std::move(vectors), xx_restarts, xx_converged};
+    }
+
+    spectral_options m_options;
+    size_type m_dim, m_k, m_m;
+
+    /*! the m + 1 basis vectors as rows
+     */
+    matrix_type m_basis;
+
+    /*! the kept Ritz vectors while a restart forms them
+     */
+    matrix_type m_restarted;
+
+    vector_type m_x, m_w;
+    std::vector<tpDataType> m_temp, m_h, m_temp_h;
+
+    /*! projection V^T * A * V, the copy of it the eigensolver destroys, and its eigenvectors, all m x m and row-major
+     */
+    std::vector<tpDataType> m_T, m_projection, m_ritz;
+
+    /*! the Ritz values, and their indices ordered by the wanted end of the spectrum
+     */
+    std::vector<tpDataType> m_theta;
+    std::vector<size_type> m_order;
+};
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! the xx_k eigenpairs of the symmetric xx_operator of dimension xx_dim at xx_end of the spectrum, by thick-restart Lanczos
+ \note the operator is applied with apply_operator(xx_operator, x, y), see iterative.hpp; the basis operations use tpPolicyType.
+ \throw std::domain_error if xx_k is zero or exceeds xx_dim
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel, typename tpOperator>
+eigen_result<matrix<tpDataType, tpPolicyType>> eigs(tpOperator const & xx_operator, std::size_t const xx_dim, std::size_t const xx_k,
+                                                    spectral_options const & xx_options = spectral_options(),
+                                                    spectrum_end const xx_end = spectrum_end::largest_magnitude)
+{
+    return lanczos_solver<tpDataType, tpPolicyType>(xx_dim, xx_k, xx_options).solve(xx_operator, xx_end);
+}
+
+/*! the xx_k eigenpairs of the symmetric square xx_matrix at xx_end of the spectrum, by thick-restart Lanczos
+ \throw std::domain_error if the matrix is not square, or xx_k is zero or exceeds its dimension
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+eigen_result<matrix<tpDataType, tpPolicyType, tpAllocatorType>> eigs(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix, std::size_t const xx_k,
+                                                                     spectral_options const & xx_options = spectral_options(),
+                                                                     spectrum_end const xx_end = spectrum_end::largest_magnitude)
+{
+    if (xx_matrix.dimR() != xx_matrix.dimC())
+        throw std::domain_error("Matrix should be square");
+    return lanczos_solver<tpDataType, tpPolicyType, tpAllocatorType>(xx_matrix.dimR(), xx_k, xx_options).solve(xx_matrix, xx_end);
+}
+
+/*! the top xx_k singular triplets of xx_matrix by the randomized range finder with power iterations
+ \note the range of A is sampled with k + oversampling random vectors, Y = A * Omega, and refined by power iterations
+ Y = A * (A^T * Q), each followed by a QR orthonormalization, until the singular values of its R factor settle within
+ the tolerance. With an orthonormal basis Q of the range, A^T * Q = Q2 * R2 gives A ~ Q * R2^T * Q2^T, and the SVD of the
+ small R2^T gives the triplets. All products with A are blocked GEMMs of the policy.
+ \throw std::domain_error if xx_k is zero or exceeds the smaller dimension of the matrix
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+svd_result<matrix<tpDataType, tpPolicyType, tpAllocatorType>> randomized_svd(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix,
+                                                                             std::size_t const xx_k,
+                                                                             spectral_options const & xx_options = spectral_options())
+{
+    static_assert(std::is_floating_point<tpDataType>::value, "Spectral solvers need a floating point element type");
+    using matrix_type = matrix<tpDataType, tpPolicyType, tpAllocatorType>;
+    using policy = typename matrix_type::policy_type;
+    using qr_type = qr_factorization<tpDataType, tpPolicyType, tpAllocatorType>;
+
+    std::size_t const m = xx_matrix.dimR();
+    std::size_t const n = xx_matrix.dimC();
+    if (xx_k == 0 || xx_k > std::min(m, n))
+        throw std::domain_error("Number of singular values should be between 1 and the smaller dimension");
+    std::size_t const l = std::min(xx_k + xx_options.oversampling, std::min(m, n));
+    std::ptrdiff_t const rsA = static_cast<std::ptrdiff_t>(n);
+    std::ptrdiff_t const rsL = static_cast<std::ptrdiff_t>(l);
+
+    detail::pool_override const pool(xx_options.threads);
+    std::mt19937_64 engine(xx_options.seed);
+
+    // singular values of the l x l R factor, the estimates of the power iterations
+    std::vector<tpDataType> sigma(l), estimate(l), W(l * l);
+    auto const estimates = [&](matrix_type const & xx_R) {
+        std::vector<tpDataType> G(xx_R.data(), xx_R.data() + l * l);
+        detail::jacobi_svd(l, G.data(), estimate.data(), W.data());
+    };
+
+    matrix_type omega(n, l);
+    detail::fill_normal(omega.data(), n * l, engine);
+    matrix_type Y(m, l), Z(n, l);
+    policy::multiply(m, l, n, xx_matrix.data(), rsA, 1, omega.data(), rsL, 1, Y.data(), rsL);
+    qr_type range(std::move(Y));
+    matrix_type Q = range.Q();
+    estimates(range.R());
+
+    std::size_t iterations = 0;
+    bool converged = false;
+    while (!converged && iterations < xx_options.max_iterations) {
+        ++iterations;
+        std::copy(estimate.begin(), estimate.end(), sigma.begin());
+        policy::multiply(n, l, m, xx_matrix.data(), 1, rsA, Q.data(), rsL, 1, Z.data(), rsL);
+        matrix_type const Q2 = qr_type(Z).Q();
+        matrix_type Yp(m, l);
+        policy::multiply(m, l, n, xx_matrix.data(), rsA, 1, Q2.data(), rsL, 1, Yp.data(), rsL);
+        qr_type refined(std::move(Yp));
+        Q = refined.Q();
+        estimates(refined.R());
+
+        converged = true;
+        for (std::size_t i = 0; i < xx_k; ++i)
+            converged = converged && std::abs(estimate[i] - sigma[i]) <= xx_options.tolerance * estimate[0];
+    }
+
+    // A^T * Q = Q2 * R2, so A ~ Q * R2^T * Q2^T; R2^T = Us * S * Ws^T gives U = Q * Us and V = Q2 * Ws
+    policy::multiply(n, l, m, xx_matrix.data(), 1, rsA, Q.data(), rsL, 1, Z.data(), rsL);
+    qr_type projected(std::move(Z));
+    matrix_type const R2 = projected.R();
+    std::vector<tpDataType> G(l * l);
+    for (std::size_t i = 0; i < l; ++i) {
+        for (std::size_t j = 0; j < l; ++j)
+            G[i * l + j] = R2(j, i);
+    }
+    detail::jacobi_svd(l, G.data(), sigma.data(), W.data());
+
+    matrix_type U(m, xx_k), V(n, xx_k);
+    std::ptrdiff_t const rsK = static_cast<std::ptrdiff_t>(xx_k);
+    policy::multiply(m, xx_k, l, Q.data(), rsL, 1, G.data(), rsL, 1, U.data(), rsK);
+    policy::multiply(n, xx_k, l, projected.Q().data(), rsL, 1, W.data(), rsL, 1, V.data(), rsK);
+    vector<tpDataType, tpAllocatorType> values(xx_k, sigma.data());
+    return svd_result<matrix_type>{std::move(values), std::move(U), std::move(V), iterations, converged};
+}
+
+}
+#endif /* spectral_h */
@@ -0,0 +1,181 @@
+/*
+ //  strassen.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the Strassen-Winograd recursion behind the Strassen multiply policy: 7 half-size products and 15
+ additions per level instead of 8 products, down to a cutoff below which the regular kernel is faster
+ */
+#ifndef strassen_h
+#define strassen_h
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "gemm.hpp"
+#include "simd.hpp"
+
+namespace assignment {
+namespace detail {
+
+/*! smallest edge that is still split; below it the 7/8 saving no longer pays for the additions and their memory traffic
+ */
+constexpr std::size_t strassen_cutoff = 256;
+
+/*! strided view on a block of a matrix, element (i, j) at data[i * rs + j * cs]
+ */
+template<typename tpDataType>
+struct strided_block {
+    tpDataType * data;
+    std::ptrdiff_t rs;
+    std::ptrdiff_t cs;
+
+    tpDataType & operator()(std::size_t const xx_i, std::size_t const xx_j) const
+    {
+        return data[static_cast<std::ptrdiff_t>(xx_i) * rs + static_cast<std::ptrdiff_t>(xx_j) * cs];
+    }
+
+    /*! block starting at (xx_i, xx_j)
+     */
+    strided_block at(std::size_t const xx_i, std::size_t const xx_j) const
+    {
+        return {&(*this)(xx_i, xx_j), rs, cs};
+    }
+};
+
+/*! xx_out = xx_left (op) xx_right for xx_M x xx_N blocks; rows with unit column stride go through the SIMD kernels
+ \note xx_out may be the same block as either operand.
+ */
+template<simd::op tpOp, typename tpDataType>
+void strided_binary(std::size_t const xx_M, std::size_t const xx_N, strided_block<tpDataType> const & xx_out,
+                    strided_block<tpDataType const> const & xx_left, strided_block<tpDataType const> const & xx_right)
+{
+    for (std::size_t i = 0; i < xx_M; ++i) {
+        if (xx_out.cs == 1 && xx_left.cs == 1 && xx_right.cs == 1) {
+            simd::binary<tpOp>(&xx_out(i, 0), &xx_left(i, 0), &xx_right(i, 0), xx_N);
+        } else {
+            for (std::size_t j = 0; j < xx_N; ++j)
+                xx_out(i, j) = simd::apply<tpOp>(xx_left(i, j), xx_right(i, j));
+        }
+    }
+}
+
+template<typename tpDataType>
+strided_block<tpDataType const> as_const(strided_block<tpDataType> const & xx_block)
+{
+    return {xx_block.data, xx_block.rs, xx_block.cs};
+}
+
+/*! elements of workspace the recursion needs for an xx_M x xx_N x xx_K product
+ */
+inline std::size_t strassen_workspace(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K)
+{
+    if (std::min(xx_M, std::min(xx_N, xx_K)) < 2 * strassen_cutoff)
+        return 0;
+    std::size_t const m = xx_M / 2;
+    std::size_t const n = xx_N / 2;
+    std::size_t const k = xx_K / 2;
+    return m * std::max(k, n) + k * n + strassen_workspace(m, n, k);
+}
+
+/*! C = A * B on one level of the recursion; see strassen
+ \param xx_workspace at least strassen_workspace(xx_M, xx_N, xx_K) elements
+ */
+template<typename tpDataType>
+void strassen_level(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+                    strided_block<tpDataType const> const & A, strided_block<tpDataType const> const & B,
+                    strided_block<tpDataType> const & C, tpDataType * xx_workspace)
+{
+    if (std::min(xx_M, std::min(xx_N, xx_K)) < 2 * strassen_cutoff) {
+        gemm(xx_M, xx_N, xx_K, A.data, A.rs, A.cs, B.data, B.rs, B.cs, C.data, C.rs);
+        return;
+    }
+
+    constexpr simd::op add = simd::op::add;
+    constexpr simd::op sub = simd::op::sub;
+
+    std::size_t const m = xx_M / 2;
+    std::size_t const n = xx_N / 2;
+    std::size_t const k = xx_K / 2;
+
+    auto const A11 = A, A12 = A.at(0, k), A21 = A.at(m, 0), A22 = A.at(m, k);
+    auto const B11 = B, B12 = B.at(0, n), B21 = B.at(k, 0), B22 = B.at(k, n);
+    auto const C11 = C, C12 = C.at(0, n), C21 = C.at(m, 0), C22 = C.at(m, n);
+    auto const c11 = as_const(C11), c12 = as_const(C12), c21 = as_const(C21), c22 = as_const(C22);
+
+    // X holds the sums of A (m x k) and later P1 (m x n), Y the sums of B (k x n); the quadrants of C hold the other products
+    std::ptrdiff_t const ldX = static_cast<std::ptrdiff_t>(std::max(k, n));
+    strided_block<tpDataType> const X = {xx_workspace, ldX, 1};
+    strided_block<tpDataType> const Y = {xx_workspace + m * std::max(k, n), static_cast<std::ptrdiff_t>(n), 1};
+    auto const x = as_const(X), y = as_const(Y);
+    tpDataType * const workspace = xx_workspace + m * std::max(k, n) + k * n;
+
+    strided_binary<sub>(m, k, X, A11, A21);                 // S3 = A11 - A21
+    strided_binary<sub>(k, n, Y, B22, B12);                 // T3 = B22 - B12
+    strassen_level(m, n, k, x, y, C21, workspace);          // P7 = S3 * T3
+    strided_binary<add>(m, k, X, A21, A22);                 // S1 = A21 + A22
+    strided_binary<sub>(k, n, Y, B12, B11);                 // T1 = B12 - B11
+    strassen_level(m, n, k, x, y, C22, workspace);          // P5 = S1 * T1
+    strided_binary<sub>(m, k, X, x, A11);                   // S2 = S1 - A11
+    strided_binary<sub>(k, n, Y, B22, y);                   // T2 = B22 - T1
+    strassen_level(m, n, k, x, y, C12, workspace);          // P6 = S2 * T2
+    strided_binary<sub>(m, k, X, A12, x);                   // S4 = A12 - S2
+    strassen_level(m, n, k, x, B22, C11, workspace);        // P3 = S4 * B22
+    strassen_level(m, n, k, A11, B11, X, workspace);        // P1 = A11 * B11
+    strided_binary<add>(m, n, C12, x, c12);                 // U2 = P1 + P6
+    strided_binary<add>(m, n, C21, c12, c21);               // U3 = U2 + P7
+    strided_binary<add>(m, n, C12, c12, c22);               // U4 = U2 + P5
+    strided_binary<add>(m, n, C22, c21, c22);               // C22 = U3 + P5
+    strided_binary<add>(m, n, C12, c12, c11);               // C12 = U4 + P3
+    strided_binary<sub>(k, n, Y, y, B21);                   // T4 = T2 - B21
+    strassen_level(m, n, k, A22, y, C11, workspace);        // P4 = A22 * T4
+    strided_binary<sub>(m, n, C21, c21, c11);               // C21 = U3 - P4
+    strassen_level(m, n, k, A12, B21, C11, workspace);      // P2 = A12 * B21
+    strided_binary<add>(m, n, C11, x, c11);                 // C11 = P1 + P2
+
+    // odd edges are peeled off: the last column of A against the last row of B, then the last column and row of C
+    if (xx_K % 2 != 0) {
+        std::size_t const last = xx_K - 1;
+        for (std::size_t i = 0; i < 2 * m; ++i) {
+            tpDataType const left = A(i, last);
+            for (std::size_t j = 0; j < 2 * n; ++j)
+                C(i, j) += left * B(last, j);
+        }
+    }
+    if (xx_N % 2 != 0)
+        gemm(2 * m, std::size_t(1), xx_K, A.data, A.rs, A.cs, &B(0, xx_N - 1), B.rs, B.cs, &C(0, xx_N - 1), C.rs);
+    if (xx_M % 2 != 0)
+        gemm(std::size_t(1), xx_N, xx_K, &A(xx_M - 1, 0), A.rs, A.cs, B.data, B.rs, B.cs, &C(xx_M - 1, 0), C.rs);
+}
+
+/*! C = A * B for strided operands with the Strassen-Winograd recursion
+ \param xx_M rows of A and C
+ \param xx_N columns of B and C
+ \param xx_K columns of A and rows of B
+ \param xx_left A, element (i, k) at xx_left[i * xx_rsA + k * xx_csA]
+ \param xx_right B, element (k, j) at xx_right[k * xx_rsB + j * xx_csB]
+ \param xx_result C, element (i, j) at xx_result[i * xx_rsC + j]; must not alias A or B
+ \note every level splits all three dimensions in half while the smallest one is at least 2 * strassen_cutoff, and needs
+ two temporaries of a quarter of the operands; the temporaries of all levels come from one buffer of the calling thread,
+ sized before the recursion starts and reused across calls.
+ */
+template<typename tpDataType>
+void strassen(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+              tpDataType const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+              tpDataType const * xx_right, std::ptrdiff_t const xx_rsB, std::ptrdiff_t const xx_csB,
+              tpDataType * xx_result, std::ptrdiff_t const xx_rsC)
+{
+    thread_local std::vector<tpDataType> workspace;
+    workspace.resize(std::max(workspace.size(), strassen_workspace(xx_M, xx_N, xx_K)));
+
+    strassen_level<tpDataType>(xx_M, xx_N, xx_K, {xx_left, xx_rsA, xx_csA}, {xx_right, xx_rsB, xx_csB}, {xx_result, xx_rsC, 1},
+                               workspace.data());
+}
+
+}
+}
+
+#endif /* strassen_h */
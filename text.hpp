@@ -0,0 +1,392 @@
+/*
+ //  text.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the bulk text format of matrices and vectors: one row per line with the elements separated by a
+ delimiter (CSV with the default ','), a vector being a single column. Elements are formatted by std::to_chars into a
+ reusable buffer and parsed by std::from_chars, both without locales or streams. Large matrices are cut into chunks of
+ rows, which the Parallel policy formats and parses on all threads of the pool.
+ \note floating point elements are written in their shortest form that reads back to the same value; complex elements
+       are written as (re,im).
+ */
+#ifndef text_h
+#define text_h
+
+#include <algorithm>
+#include <charconv>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "expression.hpp"
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+namespace detail {
+
+/*! elements formatted per chunk of rows; a chunk is the unit of work of the threads
+ */
+constexpr std::size_t text_chunk_elements = std::size_t(1) << 16;
+
+/*! bytes of text parsed per chunk
+ */
+constexpr std::size_t text_chunk_bytes = std::size_t(1) << 20;
+
+/*! upper bound of the characters std::to_chars writes for one element
+ */
+template<typename tpDataType>
+struct text_width : std::integral_constant<std::size_t, 32> {
+};
+
+template<typename tpDataType>
+struct text_width<std::complex<tpDataType>> : std::integral_constant<std::size_t, 2 * 32 + 3> {
+};
+
+template<typename tpDataType>
+char * format_value(char * xx_first, char * xx_last, tpDataType const & xx_value)
+{
+    return std::to_chars(xx_first, xx_last, xx_value).ptr;
+}
+
+template<typename tpDataType>
+char * format_value(char * xx_first, char * xx_last, std::complex<tpDataType> const & xx_value)
+{
+    *xx_first++ = '(';
+    xx_first = std::to_chars(xx_first, xx_last, xx_value.real()).ptr;
+    *xx_first++ = ',';
+    xx_first = std::to_chars(xx_first, xx_last, xx_value.imag()).ptr;
+    *xx_first++ = ')';
+    return xx_first;
+}
+
+inline bool is_blank(char const xx_char)
+{
+    return xx_char == ' ' || xx_char == '\t' || xx_char == '\r';
+}
+
+inline char const * skip_blanks(char const * xx_first, char const * xx_last)
+{
+    while (xx_first != xx_last && is_blank(*xx_first))
+        ++xx_first;
+    return xx_first;
+}
+
+/*! parses one element at xx_first into xx_value
+ \return the character after the element, nullptr if there is no valid element
+ */
+template<typename tpDataType>
+char const * parse_value(char const * xx_first, char const * xx_last, tpDataType & xx_value)
+{
+    auto const result = std::from_chars(xx_first, xx_last, xx_value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+/*! parses (re,im), or a real number as the real part
+ */
+template<typename tpDataType>
+char const * parse_value(char const * xx_first, char const * xx_last, std::complex<tpDataType> & xx_value)
+{
+    tpDataType re = 0;
+    tpDataType im = 0;
+    if (xx_first == xx_last || *xx_first != '(') {
+        xx_first = parse_value(xx_first, xx_last, re);
+    } else {
+        xx_first = parse_value(skip_blanks(xx_first + 1, xx_last), xx_last, re);
+        if (xx_first != nullptr)
+            xx_first = skip_blanks(xx_first, xx_last);
+        if (xx_first != nullptr && xx_first != xx_last && *xx_first == ',')
+            xx_first = parse_value(skip_blanks(xx_first + 1, xx_last), xx_last, im);
+        if (xx_first != nullptr)
+            xx_first = skip_blanks(xx_first, xx_last);
+        xx_first = (xx_first != nullptr && xx_first != xx_last && *xx_first == ')') ? xx_first + 1 : nullptr;
+    }
+    xx_value = std::complex<tpDataType>(re, im);
+    return xx_first;
+}
+
+/*! appends the xx_n elements at xx_values to xx_out, a line break after every xx_width elements and xx_delimiter
+ between the others
+ */
+template<typename tpDataType>
+void format_values(std::string & xx_out, tpDataType const * xx_values, std::size_t const xx_n, std::size_t const xx_width, char const xx_delimiter)
+{
+    std::size_t const used = xx_out.size();
+    xx_out.resize(used + xx_n * (text_width<tpDataType>::value + 1));
+    char * p = &xx_out[0] + used;
+    char * const last = &xx_out[0] + xx_out.size();
+    for (std::size_t i = 0, C = 1; i < xx_n; ++i, ++C) {
+        p = format_value(p, last, xx_values[i]);
+        if (C == xx_width) {
+            *p++ = '\n';
+            C = 0;
+        } else {
+            *p++ = xx_delimiter;
+        }
+    }
+    xx_out.resize(static_cast<std::size_t>(p - &xx_out[0]));
+}
+
+/*! rows of the text form of a matrix or vector expression: the rows of a matrix, the elements of a vector
+ */
+template<typename tpExpression>
+std::size_t text_rows(tpExpression const & xx_expression)
+{
+    if constexpr (is_kind<tpExpression, matrix_kind>::value)
+        return xx_expression.dimR();
+    else
+        return size(xx_expression);
+}
+
+/*! appends the lines xx_first ... xx_last - 1 of the text form of xx_expression to xx_out
+ */
+template<typename tpExpression>
+void format_rows(std::string & xx_out, tpExpression const & xx_expression, std::size_t const xx_first, std::size_t const xx_last, char const xx_delimiter)
+{
+    using value_type = typename traits<tpExpression>::value_type;
+
+    // a range of a matrix expression with views must not cross a row, so matrices are evaluated row by row
+    std::size_t const width = is_kind<tpExpression, matrix_kind>::value ? size(xx_expression) / std::max<std::size_t>(text_rows(xx_expression), 1) : 1;
+    std::size_t const step = is_kind<tpExpression, matrix_kind>::value ? 1 : text_chunk_elements;
+    thread_local std::vector<value_type> values;
+    for (std::size_t R = xx_first; R < xx_last; R += step) {
+        std::size_t const n = std::min(step, xx_last - R) * width;
+        values.resize(n);
+        evaluate_range(values.data(), xx_expression, R * width, n);
+        format_values(xx_out, values.data(), n, width, xx_delimiter);
+    }
+}
+
+/*! parses the line at xx_first into xx_out, storing at most xx_limit elements
+ \return number of elements on the line; xx_first is moved past its line break
+ \throw std::runtime_error if the line holds anything but elements separated by xx_delimiter
+ */
+template<typename tpDataType>
+std::size_t parse_line(char const * & xx_first, char const * xx_last, tpDataType * xx_out, std::size_t const xx_limit, char const xx_delimiter)
+{
+    std::size_t count = 0;
+    char const * p = xx_first;
+    for (;;) {
+        tpDataType value;
+        p = parse_value(skip_blanks(p, xx_last), xx_last, value);
+        if (p == nullptr)
+            throw std::runtime_error("Malformed element in text row");
+        if (count < xx_limit)
+            xx_out[count] = value;
+        ++count;
+
+        p = skip_blanks(p, xx_last);
+        if (p == xx_last || *p == '\n')
+            break;
+        if (is_blank(xx_delimiter))
+            continue;
+        if (*p != xx_delimiter)
+            throw std::runtime_error("Malformed element in text row");
+        ++p;
+    }
+    xx_first = p == xx_last ? p : p + 1;
+    return count;
+}
+
+/*! start of the first line at or after xx_first that holds anything but blanks; xx_last if there is none
+ */
+inline char const * next_row(char const * xx_first, char const * const xx_last)
+{
+    while (xx_first != xx_last) {
+        char const * const p = skip_blanks(xx_first, xx_last);
+        if (p == xx_last || *p != '\n')
+            return p == xx_last ? xx_last : xx_first;
+        xx_first = p + 1;
+    }
+    return xx_last;
+}
+
+/*! line starts splitting [xx_first, xx_last) into chunks of about text_chunk_bytes, more than one only for tpParallel
+ */
+template<bool tpParallel>
+std::vector<char const *> text_chunks(char const * const xx_first, char const * const xx_last)
+{
+    std::size_t const bytes = static_cast<std::size_t>(xx_last - xx_first);
+    std::size_t chunks = 1;
+    if (tpParallel && bytes >= 2 * text_chunk_bytes)
+        chunks = std::min(4 * pool_threads(), bytes / text_chunk_bytes);
+
+    std::vector<char const *> bounds(chunks + 1, xx_last);
+    bounds[0] = xx_first;
+    for (std::size_t i = 1; i < chunks; ++i) {
+        char const * const p = std::max(bounds[i - 1], xx_first + bytes / chunks * i);
+        void const * const end_of_line = p == xx_last ? nullptr : std::memchr(p, '\n', static_cast<std::size_t>(xx_last - p));
+        bounds[i] = end_of_line == nullptr ? xx_last : static_cast<char const *>(end_of_line) + 1;
+    }
+    return bounds;
+}
+
+/*! parses the rows of xx_text into a matrix
+ */
+template<typename tpDataType, template<typename > class tpPolicyType>
+matrix<tpDataType, tpPolicyType> parse_text(std::string_view const xx_text, char const xx_delimiter)
+{
+    char const * const first = xx_text.data();
+    char const * const last = first + xx_text.size();
+
+    // the first row gives the column dimension
+    char const * p = next_row(first, last);
+    if (p == last)
+        return matrix<tpDataType, tpPolicyType>(0, 0);
+    std::size_t const dimC = parse_line<tpDataType>(p, last, nullptr, 0, xx_delimiter);
+
+    std::vector<char const *> const bounds = text_chunks<tpPolicyType<matrix<tpDataType, tpPolicyType>>::is_parallel>(first, last);
+    std::size_t const chunks = bounds.size() - 1;
+    std::vector<std::size_t> rows(chunks + 1, 0);
+    parallel_for(chunks, [&](std::size_t const i) {
+        for (char const * q = next_row(bounds[i], bounds[i + 1]); q != bounds[i + 1]; ) {
+            ++rows[i + 1];
+            void const * const end_of_line = std::memchr(q, '\n', static_cast<std::size_t>(bounds[i + 1] - q));
+            q = next_row(end_of_line == nullptr ? bounds[i + 1] : static_cast<char const *>(end_of_line) + 1, bounds[i + 1]);
+        }
+    });
+    for (std::size_t i = 0; i < chunks; ++i)
+        rows[i + 1] += rows[i];
+
+    matrix<tpDataType, tpPolicyType> result(rows[chunks], dimC);
+    parallel_for(chunks, [&](std::size_t const i) {
+        char const * q = bounds[i];
+        for (std::size_t R = rows[i]; R < rows[i + 1]; ++R) {
+            q = next_row(q, bounds[i + 1]);
+            if (parse_line(q, bounds[i + 1], result.data() + R * dimC, dimC, xx_delimiter) != dimC)
+                throw std::runtime_error("Text row " + std::to_string(R) + " should have " + std::to_string(dimC) + " elements");
+        }
+    });
+    return result;
+}
+
+/*! contents of the file xx_path
+ \throw std::runtime_error if the file cannot be read
+ */
+inline std::string read_file(std::string const & xx_path)
+{
+    std::ifstream file(xx_path, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw std::runtime_error("Cannot open " + xx_path);
+    std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    if (!file.read(&text[0], static_cast<std::streamsize>(text.size())))
+        throw std::runtime_error("Cannot read " + xx_path);
+    return text;
+}
+
+} // namespace detail
+
+/*! appends the text form of a matrix or vector expression to xx_out: a line per row, a vector as a single column
+ \param xx_out buffer that may be reused across calls; it is only grown
+ \param xx_delimiter separates the elements of a row
+ */
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value
+                || detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+void format(std::string & xx_out, tpExpression const & xx_expression, char const xx_delimiter = ',')
+{
+    detail::format_rows(xx_out, xx_expression, 0, detail::text_rows(xx_expression), xx_delimiter);
+}
+
+/*! writes the text form of a matrix or vector expression to xx_stream, see format()
+ \tparam tpPolicyType Parallel formats the chunks of rows on all threads of the pool; they are written in order
+ \note the text goes to the stream in a few large writes, without flushing it.
+ */
+template<template<typename > class tpPolicyType = NonParallel, typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value
+                || detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+void write_text(std::ostream & xx_stream, tpExpression const & xx_expression, char const xx_delimiter = ',')
+{
+    using value_type = typename detail::traits<tpExpression>::value_type;
+    constexpr bool parallel = tpPolicyType<matrix<value_type, tpPolicyType>>::is_parallel;
+
+    std::size_t const rows = detail::text_rows(xx_expression);
+    std::size_t const width = std::max<std::size_t>(detail::size(xx_expression) / std::max<std::size_t>(rows, 1), 1);
+    std::size_t const step = std::max<std::size_t>(detail::text_chunk_elements / width, 1);
+    std::size_t const chunks = (rows + step - 1) / step;
+    std::size_t const group = parallel && chunks > 1 ? std::min(chunks, detail::pool_threads()) : 1;
+
+    std::vector<std::string> buffers(group);
+    for (std::size_t first = 0; first < chunks; first += group) {
+        std::size_t const count = std::min(group, chunks - first);
+        auto const format_chunk = [&](std::size_t const i) {
+            std::size_t const R = (first + i) * step;
+            buffers[i].clear();
+            detail::format_rows(buffers[i], xx_expression, R, std::min(R + step, rows), xx_delimiter);
+        };
+        if (count > 1) {
+            detail::parallel_for(count, format_chunk);
+        } else {
+            format_chunk(0);
+        }
+        for (std::size_t i = 0; i < count; ++i)
+            xx_stream.write(buffers[i].data(), static_cast<std::streamsize>(buffers[i].size()));
+    }
+}
+
+/*! writes the text form of a matrix or vector expression to the file xx_path, see write_text()
+ \throw std::runtime_error if the file cannot be written
+ */
+template<template<typename > class tpPolicyType = NonParallel, typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value
+                || detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+void write_text(std::string const & xx_path, tpExpression const & xx_expression, char const xx_delimiter = ',')
+{
+    std::ofstream file(xx_path, std::ios::binary | std::ios::trunc);
+    write_text<tpPolicyType>(file, xx_expression, xx_delimiter);
+    file.close();
+    if (!file)
+        throw std::runtime_error("Cannot write " + xx_path);
+}
+
+/*! parses a matrix from text: a line per row, the elements separated by xx_delimiter and optional blanks
+ \note blank lines are skipped. With a blank xx_delimiter (' ' or '\t') any run of blanks separates the elements.
+ \throw std::runtime_error if an element is malformed or the rows have different numbers of elements
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+matrix<tpDataType, tpPolicyType> parse_matrix(std::string_view const xx_text, char const xx_delimiter = ',')
+{
+    return detail::parse_text<tpDataType, tpPolicyType>(xx_text, xx_delimiter);
+}
+
+/*! parses a vector from text holding a single column or a single row, see parse_matrix()
+ \throw std::domain_error if the text holds more than one row and column; std::runtime_error as parse_matrix()
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+vector<tpDataType> parse_vector(std::string_view const xx_text, char const xx_delimiter = ',')
+{
+    matrix<tpDataType, tpPolicyType> const values = detail::parse_text<tpDataType, tpPolicyType>(xx_text, xx_delimiter);
+    if (values.dimR() > 1 && values.dimC() > 1)
+        throw std::domain_error("Text should hold a single row or column");
+    return vector<tpDataType>(values.dimR() * values.dimC(), values.data());
+}
+
+/*! reads a matrix from the text file xx_path, see parse_matrix()
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+matrix<tpDataType, tpPolicyType> read_matrix(std::string const & xx_path, char const xx_delimiter = ',')
+{
+    return parse_matrix<tpDataType, tpPolicyType>(detail::read_file(xx_path), xx_delimiter);
+}
+
+/*! reads a vector from the text file xx_path, see parse_vector()
+ */
+template<typename tpDataType, template<typename > class tpPolicyType = NonParallel>
+vector<tpDataType> read_vector(std::string const & xx_path, char const xx_delimiter = ',')
+{
+    return parse_vector<tpDataType, tpPolicyType>(detail::read_file(xx_path), xx_delimiter);
+}
+
+}
+#endif /* text_h */
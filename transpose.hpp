@@ -0,0 +1,92 @@
+/*
+ //  transpose.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the kernels behind transposition: a cache-oblivious strided copy, which transposes when the strides of
+ source and destination are swapped, and a blocked in-place transpose of square storage
+ */
+#ifndef transpose_h
+#define transpose_h
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+
+namespace assignment {
+namespace detail {
+
+/*! edge below which a block is copied or swapped with plain loops; a pair of such blocks fits into L1
+ */
+constexpr std::size_t transpose_block = 32;
+
+/*! out(R, C) = in(R, C) for an xx_dimR x xx_dimC block with arbitrary strides on both sides
+ \note the block is halved along its longer edge until it fits into cache, so the reads and the writes both touch few lines
+ whatever the strides; with swapped strides on one side this is an out-of-place transpose.
+ */
+template<typename tpDataType>
+void strided_copy(std::size_t const xx_dimR, std::size_t const xx_dimC,
+                  tpDataType const * xx_in, std::ptrdiff_t const xx_rsI, std::ptrdiff_t const xx_csI,
+                  tpDataType * xx_out, std::ptrdiff_t const xx_rsO, std::ptrdiff_t const xx_csO)
+{
+    if (xx_dimR <= transpose_block && xx_dimC <= transpose_block) {
+        std::ptrdiff_t const dimR = static_cast<std::ptrdiff_t>(xx_dimR);
+        std::ptrdiff_t const dimC = static_cast<std::ptrdiff_t>(xx_dimC);
+        // walk along the unit stride of the destination, if any
+        if (xx_csO == 1 || std::abs(xx_rsO) > std::abs(xx_csO)) {
+            for (std::ptrdiff_t R = 0; R < dimR; ++R) {
+                for (std::ptrdiff_t C = 0; C < dimC; ++C) {
+                    xx_out[R * xx_rsO + C * xx_csO] = xx_in[R * xx_rsI + C * xx_csI];
+                }
+            }
+        } else {
+            for (std::ptrdiff_t C = 0; C < dimC; ++C) {
+                for (std::ptrdiff_t R = 0; R < dimR; ++R) {
+                    xx_out[R * xx_rsO + C * xx_csO] = xx_in[R * xx_rsI + C * xx_csI];
+                }
+            }
+        }
+        return;
+    }
+
+    if (xx_dimR >= xx_dimC) {
+        std::size_t const half = xx_dimR / 2;
+        strided_copy(half, xx_dimC, xx_in, xx_rsI, xx_csI, xx_out, xx_rsO, xx_csO);
+        strided_copy(xx_dimR - half, xx_dimC, xx_in + static_cast<std::ptrdiff_t>(half) * xx_rsI, xx_rsI, xx_csI,
+                     xx_out + static_cast<std::ptrdiff_t>(half) * xx_rsO, xx_rsO, xx_csO);
+    } else {
+        std::size_t const half = xx_dimC / 2;
+        strided_copy(xx_dimR, half, xx_in, xx_rsI, xx_csI, xx_out, xx_rsO, xx_csO);
+        strided_copy(xx_dimR, xx_dimC - half, xx_in + static_cast<std::ptrdiff_t>(half) * xx_csI, xx_rsI, xx_csI,
+                     xx_out + static_cast<std::ptrdiff_t>(half) * xx_csO, xx_rsO, xx_csO);
+    }
+}
+
+/*! transposes the xx_dim x xx_dim block at xx_data (row stride xx_rs) in place
+ \note blocks (I, J) and (J, I) are swapped pairwise, so both are read and written while they are in cache.
+ */
+template<typename tpDataType>
+void transpose_square(std::size_t const xx_dim, tpDataType * xx_data, std::ptrdiff_t const xx_rs)
+{
+    std::ptrdiff_t const dim = static_cast<std::ptrdiff_t>(xx_dim);
+    std::ptrdiff_t const block = static_cast<std::ptrdiff_t>(transpose_block);
+    for (std::ptrdiff_t I = 0; I < dim; I += block) {
+        std::ptrdiff_t const endI = std::min(dim, I + block);
+        for (std::ptrdiff_t J = I; J < dim; J += block) {
+            std::ptrdiff_t const endJ = std::min(dim, J + block);
+            for (std::ptrdiff_t R = I; R < endI; ++R) {
+                for (std::ptrdiff_t C = (I == J ? R + 1 : J); C < endJ; ++C) {
+                    std::swap(xx_data[R * xx_rs + C], xx_data[C * xx_rs + R]);
+                }
+            }
+        }
+    }
+}
+
+}
+}
+
+#endif /* transpose_h */
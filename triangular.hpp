@@ -0,0 +1,237 @@
+/*
+ //  triangular.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the blocked triangular solves T * x = b and T * X = B for a lower or upper triangle T of an
+ assignment::matrix, and the kernels the factorizations (lu.hpp, cholesky.hpp) share with them. A solve substitutes
+ through a narrow diagonal block and then updates the rows below it (above it, for an upper triangle) with one product of
+ the multiply policy, which does almost all of the work.
+ */
+#ifndef triangular_h
+#define triangular_h
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+
+/*! the triangle of a matrix a triangular solve reads; the elements of the other triangle are ignored
+ */
+enum class triangle {
+    lower,
+    upper
+};
+
+namespace detail {
+
+/*! block sizes of the factorizations and triangular solves
+ \note NB columns are factored, or substituted through, as a block before the update of the rest; updates are computed in
+ strips of NC columns, so their temporary holds NC columns of the updated rows.
+ */
+struct factor_blocking {
+    static constexpr std::size_t NB = 64;
+    static constexpr std::size_t NC = 256;
+};
+
+/*! fewest elements a thread subtracts in an update; below this the threading overhead dominates
+ */
+constexpr std::size_t factor_min_chunk = std::size_t(1) << 15;
+
+/*! C -= A * B through the multiply policy: A is xx_M x xx_K, B is xx_K x xx_N, C is xx_M x xx_N and row-major
+ \param xx_temp workspace reused across calls; grows to xx_M * factor_blocking::NC elements
+ \note the product is formed a strip of columns at a time and subtracted from C; C must not alias A or B.
+ */
+template<typename tpPolicy, typename tpDataType>
+void subtract_product(std::size_t const xx_M, std::size_t const xx_N, std::size_t const xx_K,
+                      tpDataType const * xx_left, std::ptrdiff_t const xx_rsA, std::ptrdiff_t const xx_csA,
+                      tpDataType const * xx_right, std::ptrdiff_t const xx_rsB, std::ptrdiff_t const xx_csB,
+                      tpDataType * xx_result, std::ptrdiff_t const xx_rsC, std::vector<tpDataType> & xx_temp)
+{
+    if (xx_M == 0 || xx_N == 0 || xx_K == 0)
+        return;
+    std::size_t const width = std::min(xx_N, factor_blocking::NC);
+    xx_temp.resize(xx_M * width);
+    for (std::size_t C = 0; C < xx_N; C += width) {
+        std::size_t const n = std::min(width, xx_N - C);
+        tpPolicy::multiply(xx_M, n, xx_K, xx_left, xx_rsA, xx_csA, xx_right + static_cast<std::ptrdiff_t>(C) * xx_csB, xx_rsB, xx_csB,
+                           xx_temp.data(), static_cast<std::ptrdiff_t>(n));
+        auto const subtract = [&](std::size_t const xx_first, std::size_t const xx_last) {
+            for (std::size_t R = xx_first; R < xx_last; ++R) {
+                tpDataType * const row = xx_result + static_cast<std::ptrdiff_t>(R) * xx_rsC + C;
+                simd::binary<simd::op::sub>(row, row, xx_temp.data() + R * n, n);
+            }
+        };
+        if (tpPolicy::is_parallel && xx_M * n >= 2 * factor_min_chunk)
+            thread_pool::current().parallel_for(0, xx_M, std::max<std::size_t>(1, factor_min_chunk / n), subtract);
+        else
+            subtract(0, xx_M);
+    }
+}
+
+/*! xx_out[i] -= xx_scalar * xx_in[i] for i in [0, xx_n)
+ \note the loop has no branches, so the compiler vectorizes it.
+ */
+template<typename tpDataType>
+void subtract_scaled(tpDataType * xx_out, tpDataType const * xx_in, tpDataType const xx_scalar, std::size_t const xx_n)
+{
+    for (std::size_t i = 0; i < xx_n; ++i)
+        xx_out[i] -= xx_scalar * xx_in[i];
+}
+
+/*! solves T * X = B in place by substitution, for the triangle T of an xx_n x xx_n block and xx_n rows of xx_cols columns of B
+ \param xx_unit whether T has an implied unit diagonal
+ \note row-oriented: every row of X is its row of B minus multiples of rows already solved, so B is read contiguously.
+ */
+template<typename tpDataType>
+void substitute(std::size_t const xx_n, std::size_t const xx_cols, tpDataType const * xx_triangle, std::ptrdiff_t const xx_rsT,
+                std::ptrdiff_t const xx_csT, triangle const xx_part, bool const xx_unit, tpDataType * xx_rhs, std::ptrdiff_t const xx_rsB)
+{
+    for (std::size_t s = 0; s < xx_n; ++s) {
+        std::size_t const i = xx_part == triangle::lower ? s : xx_n - 1 - s;
+        std::size_t const first = xx_part == triangle::lower ? 0 : i + 1;
+        std::size_t const last = xx_part == triangle::lower ? i : xx_n;
+        tpDataType const * const row_T = xx_triangle + static_cast<std::ptrdiff_t>(i) * xx_rsT;
+        tpDataType * const row = xx_rhs + static_cast<std::ptrdiff_t>(i) * xx_rsB;
+        for (std::size_t k = first; k < last; ++k)
+            subtract_scaled(row, xx_rhs + static_cast<std::ptrdiff_t>(k) * xx_rsB, row_T[static_cast<std::ptrdiff_t>(k) * xx_csT], xx_cols);
+        if (!xx_unit) {
+            tpDataType const inverse = tpDataType(1) / row_T[static_cast<std::ptrdiff_t>(i) * xx_csT];
+            for (std::size_t C = 0; C < xx_cols; ++C)
+                row[C] *= inverse;
+        }
+    }
+}
+
+/*! solves T * X = B in place for the triangle T of an xx_n x xx_n strided matrix and xx_cols columns of the row-major B
+ \param xx_temp workspace of the updates, see subtract_product
+ \note blocked: substitution through NB rows of X, then the rows still to solve are updated with one product.
+ */
+template<typename tpPolicy, typename tpDataType>
+void solve_blocked(std::size_t const xx_n, std::size_t const xx_cols, tpDataType const * xx_triangle, std::ptrdiff_t const xx_rsT,
+                   std::ptrdiff_t const xx_csT, triangle const xx_part, bool const xx_unit, tpDataType * xx_rhs, std::ptrdiff_t const xx_rsB,
+                   std::vector<tpDataType> & xx_temp)
+{
+    constexpr std::size_t NB = factor_blocking::NB;
+    auto const at = [&](std::size_t const xx_r, std::size_t const xx_c) {
+        return xx_triangle + static_cast<std::ptrdiff_t>(xx_r) * xx_rsT + static_cast<std::ptrdiff_t>(xx_c) * xx_csT;
+    };
+    auto const row = [&](std::size_t const xx_r) { return xx_rhs + static_cast<std::ptrdiff_t>(xx_r) * xx_rsB; };
+
+    if (xx_part == triangle::lower) {
+        for (std::size_t k = 0; k < xx_n; k += NB) {
+            std::size_t const b = std::min(NB, xx_n - k);
+            substitute(b, xx_cols, at(k, k), xx_rsT, xx_csT, xx_part, xx_unit, row(k), xx_rsB);
+            subtract_product<tpPolicy>(xx_n - k - b, xx_cols, b, at(k + b, k), xx_rsT, xx_csT, row(k), xx_rsB, 1, row(k + b), xx_rsB, xx_temp);
+        }
+    } else {
+        for (std::size_t end = xx_n; end > 0; ) {
+            std::size_t const k = end > NB ? end - NB : 0;
+            substitute(end - k, xx_cols, at(k, k), xx_rsT, xx_csT, xx_part, xx_unit, row(k), xx_rsB);
+            subtract_product<tpPolicy>(k, xx_cols, end - k, at(0, k), xx_rsT, xx_csT, row(k), xx_rsB, 1, row(0), xx_rsB, xx_temp);
+            end = k;
+        }
+    }
+}
+
+/*! solves T * x = b in place for the triangle T of an xx_n x xx_n strided matrix and a contiguous vector x
+ \param xx_temp workspace of the updates; grows to xx_n elements
+ \note blocked like solve_blocked, with the updates as matrix-vector products of the policy.
+ */
+template<typename tpPolicy, typename tpDataType>
+void solve_vector(std::size_t const xx_n, tpDataType const * xx_triangle, std::ptrdiff_t const xx_rsT, std::ptrdiff_t const xx_csT,
+                  triangle const xx_part, bool const xx_unit, tpDataType * xx_x, std::vector<tpDataType> & xx_temp)
+{
+    constexpr std::size_t NB = factor_blocking::NB;
+    auto const at = [&](std::size_t const xx_r, std::size_t const xx_c) {
+        return xx_triangle + static_cast<std::ptrdiff_t>(xx_r) * xx_rsT + static_cast<std::ptrdiff_t>(xx_c) * xx_csT;
+    };
+    auto const update = [&](std::size_t const xx_M, std::size_t const xx_K, tpDataType const * xx_block, tpDataType const * xx_solved, tpDataType * xx_out) {
+        if (xx_M == 0)
+            return;
+        xx_temp.resize(xx_n);
+        tpPolicy::vector_multiply(xx_M, xx_K, xx_block, xx_rsT, xx_csT, xx_solved, 1, xx_temp.data());
+        simd::binary<simd::op::sub>(xx_out, xx_out, xx_temp.data(), xx_M);
+    };
+
+    if (xx_part == triangle::lower) {
+        for (std::size_t k = 0; k < xx_n; k += NB) {
+            std::size_t const b = std::min(NB, xx_n - k);
+            substitute(b, 1, at(k, k), xx_rsT, xx_csT, xx_part, xx_unit, xx_x + k, 1);
+            update(xx_n - k - b, b, at(k + b, k), xx_x + k, xx_x + k + b);
+        }
+    } else {
+        for (std::size_t end = xx_n; end > 0; ) {
+            std::size_t const k = end > NB ? end - NB : 0;
+            substitute(end - k, 1, at(k, k), xx_rsT, xx_csT, xx_part, xx_unit, xx_x + k, 1);
+            update(k, end - k, at(0, k), xx_x + k, xx_x);
+            end = k;
+        }
+    }
+}
+
+/*! checks the operands of a triangular solve
+ \throw std::domain_error if the matrix is not square, xx_rows differs from its dimension or, unless xx_unit, the diagonal has a zero
+ */
+template<typename tpMatrixType>
+void check_triangular(tpMatrixType const & xx_matrix, std::size_t const xx_rows, bool const xx_unit)
+{
+    if (xx_matrix.dimR() != xx_matrix.dimC())
+        throw std::domain_error("Matrix should be square");
+    if (xx_rows != xx_matrix.dimR())
+        throw std::domain_error("Right-hand side should have the dimension of the matrix");
+    for (std::size_t i = 0; !xx_unit && i < xx_matrix.dimR(); ++i) {
+        if (xx_matrix(i, i) == typename tpMatrixType::value_type(0))
+            throw std::domain_error("Matrix is singular");
+    }
+}
+
+} // namespace detail
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! solves T * x = xx_rhs for the triangle xx_part of xx_matrix
+ \param xx_unit whether to take the diagonal of T as ones instead of reading it
+ \throw std::domain_error if the matrix is not square, the dimensions differ or the diagonal has a zero
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType, typename tpVectorAllocator>
+vector<tpDataType, tpVectorAllocator> solve_triangular(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix,
+                                                       vector<tpDataType, tpVectorAllocator> xx_rhs, triangle const xx_part, bool const xx_unit = false)
+{
+    using policy = typename matrix<tpDataType, tpPolicyType, tpAllocatorType>::policy_type;
+    detail::check_triangular(xx_matrix, xx_rhs.dim(), xx_unit);
+    std::vector<tpDataType> temp;
+    detail::solve_vector<policy>(xx_matrix.dimR(), xx_matrix.data(), static_cast<std::ptrdiff_t>(xx_matrix.dimC()), 1,
+                                 xx_part, xx_unit, xx_rhs.data(), temp);
+    return xx_rhs;
+}
+
+/*! solves T * X = xx_rhs for the triangle xx_part of xx_matrix and all columns of xx_rhs at once
+ \param xx_unit whether to take the diagonal of T as ones instead of reading it
+ \throw std::domain_error if the matrix is not square, the dimensions differ or the diagonal has a zero
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix<tpDataType, tpPolicyType, tpAllocatorType> solve_triangular(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix,
+                                                                   matrix<tpDataType, tpPolicyType, tpAllocatorType> xx_rhs,
+                                                                   triangle const xx_part, bool const xx_unit = false)
+{
+    using policy = typename matrix<tpDataType, tpPolicyType, tpAllocatorType>::policy_type;
+    detail::check_triangular(xx_matrix, xx_rhs.dimR(), xx_unit);
+    std::vector<tpDataType> temp;
+    detail::solve_blocked<policy>(xx_matrix.dimR(), xx_rhs.dimC(), xx_matrix.data(), static_cast<std::ptrdiff_t>(xx_matrix.dimC()), 1,
+                                  xx_part, xx_unit, xx_rhs.data(), static_cast<std::ptrdiff_t>(xx_rhs.dimC()), temp);
+    return xx_rhs;
+}
+
+}
+#endif /* triangular_h */
@@ -11,14 +11,24 @@
 #define vector_h
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <initializer_list>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
 
+#include "allocator.hpp"
+#include "expression.hpp"
+#include "simd.hpp"
+
 namespace assignment {
-template<typename tpDataType>
+
+/*! mathematical vector
+ \tparam tpDataType element type
+ \tparam tpAllocatorType allocator of the storage; 64 byte aligned by default, pool_allocator recycles same-sized buffers
+ */
+template<typename tpDataType, typename tpAllocatorType = aligned_allocator<tpDataType>>
 class vector {
 public:
 
@@ -30,6 +40,10 @@ public:
      */
     using size_type = std::size_t;
 
+    /*! allocator of the storage
+     */
+    using allocator_type = tpAllocatorType;
+
     /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
 
     /*! constructor
@@ -61,8 +75,16 @@ public:
     vector(vector const & xx_vector);
 
     /*! move constructor
+     \note takes over the storage of xx_vector, which is left empty
+     */
+    vector(vector && xx_vector) noexcept;
+
+    /*! constructor from an expression (Ex: v1 + v2 * 3)
+     \note all elements are computed in a single pass without intermediate vectors; a temporary vector inside a temporary
+     expression lends its storage to the result
      */
-    vector(vector && xx_vector);
+    template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, vector_kind, tpDataType>::value>::type* = nullptr>
+    vector(tpExpression && xx_expression);
 
     /* ==== a  s  s  i  g  n  m  e  n  t     o  p  e  r  a  t  o  r  s  ==== */
 
@@ -71,8 +93,15 @@ public:
     vector & operator=(vector const & xx_vector);
 
     /*! move assignment operator
+     \note takes over the storage of xx_vector, which is left empty
      */
-    vector & operator=(vector && xx_vector);
+    vector & operator=(vector && xx_vector) noexcept;
+
+    /*! assignment from an expression
+     \note evaluated in place, without allocation, if the dimension does not change
+     */
+    template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, vector_kind, tpDataType>::value>::type* = nullptr>
+    vector & operator=(tpExpression && xx_expression);
 
     /* ==== d  e  s  t  r  u  c  t  o  r ==== */
 
@@ -82,48 +111,22 @@ public:
 
     /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
 
-    /*! + operator overload
-     */
-    vector operator+(vector const & xx_vector);
-
-    /*! - operator overload
-     */
-    vector operator-(vector const & xx_vector);
-
-    /*!  *operator overload => element-wise multiplication
-     \note xx_vector is clipped if its dim > (*this) vector's dim and appended with 1 otherwise
-     */
-    vector operator*(vector const & xx_vector);
-
-    /*! + operator overload with scalar
-     */
-    vector operator+(tpDataType const & xx_scalar);
-
-    /*! - operator overload with scalar
-     */
-    vector operator-(tpDataType const & xx_scalar);
-
-    /*! * operator overload with scalar
-     */
-    vector operator*(tpDataType const xx_scalar);
+    /* element-wise +, -, * and the scalar forms are free operators building lazy expressions, see expression.hpp */
 
-    /*! * operator overload with scalar
-     \note only enabled if the datatype is not integral (Ex: when std::complex)
+    /*! +=operator overload with a vector or vector expression
      */
-    template<typename TDummy = tpDataType, typename std::enable_if<!std::is_integral<TDummy>::value>::type* = nullptr>
-    vector<tpDataType> operator *(size_type const xx_scalar);
+    template<typename tpExpression, typename std::enable_if<detail::are_compatible<vector, tpExpression>::value>::type* = nullptr>
+    vector & operator+=(tpExpression const & xx_expression);
 
-    /*! +=operator overload
+    /*! -=operator overload with a vector or vector expression
      */
-    vector & operator+=(vector const & xx_vector);
+    template<typename tpExpression, typename std::enable_if<detail::are_compatible<vector, tpExpression>::value>::type* = nullptr>
+    vector & operator-=(tpExpression const & xx_expression);
 
-    /*! -=operator overload
+    /*! * =operator overload with a vector or vector expression => element-wise multiplication
      */
-    vector & operator-=(vector const & xx_vector);
-
-    /*! * =operator overload
-     */
-    vector & operator*=(vector const & xx_vector);
+    template<typename tpExpression, typename std::enable_if<detail::are_compatible<vector, tpExpression>::value>::type* = nullptr>
+    vector & operator*=(tpExpression const & xx_expression);
 
     /*! [ ]operator overload for indexing
      */
@@ -143,6 +146,14 @@ public:
      */
     void set(tpDataType const & xx_value);
 
+    /*! get the pointer to the contiguous vector data
+     */
+    tpDataType const * data() const;
+
+    /*! get the pointer to the contiguous vector data
+     */
+    tpDataType * data();
+
 private:
     /*! dimension of the matrix
      */
@@ -150,231 +161,266 @@ private:
 
     /*! unique pointer to the data
      */
-    std::unique_ptr<value_type[]> m_data;
+    buffer<value_type, tpAllocatorType> m_data;
 
 };
 
+/*! vectors are the leaves of vector expressions
+ */
+template<typename tpDataType, typename tpAllocatorType>
+struct expression_traits<vector<tpDataType, tpAllocatorType>> {
+    static constexpr bool is_expression = true;
+    static constexpr bool is_leaf = true;
+    using kind = vector_kind;
+    using value_type = tpDataType;
+    using result_type = vector<tpDataType, tpAllocatorType>;
+
+    static std::size_t size(vector<tpDataType, tpAllocatorType> const & xx_vector)
+    {
+        return xx_vector.dim();
+    }
+};
+
 /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
 
-template<typename tpDataType>
-assignment::vector<tpDataType>::vector(size_type const xx_dim) :
+template<typename tpDataType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType>::vector(size_type const xx_dim) :
                 m_dim(xx_dim),
-                m_data(new tpDataType[m_dim])
+                m_data(m_dim)
 {
 }
 
-template<typename tpDataType>
-assignment::vector<tpDataType>::vector(size_type const xx_dim, tpDataType const xx_value) :
+template<typename tpDataType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType>::vector(size_type const xx_dim, tpDataType const xx_value) :
                 m_dim(xx_dim),
-                m_data(new tpDataType[m_dim])
+                m_data(m_dim)
 {
     for (size_type i = 0; i < m_dim; ++i) {
         m_data[i] = xx_value;
     }
 }
 
-template<typename tpDataType>
-assignment::vector<tpDataType>::vector(size_type xx_dim, tpDataType const* xx_ptr_array) :
+template<typename tpDataType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType>::vector(size_type xx_dim, tpDataType const* xx_ptr_array) :
                 m_dim(xx_dim),
-                m_data(new tpDataType[m_dim])
+                m_data(m_dim)
 {
     for (size_type i = 0; i < xx_dim; ++i) {
         m_data[i] = *xx_ptr_array++;
     }
 }
 
-template<typename tpDataType>
-assignment::vector<tpDataType>::vector(std::initializer_list<tpDataType>&& xx_list) :
-                m_dim(0),
-                m_data(new tpDataType[m_dim])
+template<typename tpDataType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType>::vector(std::initializer_list<tpDataType>&& xx_list) :
+                m_dim(xx_list.size()),
+                m_data(m_dim)
 {
-    m_dim = xx_list.size();
-    int i = 0;
-    for (auto&& x : xx_list) {
-        m_data[i] = x;
-        ++i;
-    }
+    std::copy(xx_list.begin(), xx_list.end(), m_data.get());
 }
 
-template<typename tpDataType>
-assignment::vector<tpDataType>::vector(vector const & xx_vector) :
+template<typename tpDataType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType>::vector(vector const & xx_vector) :
                 m_dim(xx_vector.m_dim),
-                m_data(new tpDataType[m_dim])
+                m_data(m_dim)
 {
-    for (size_type i = 0; i < m_dim; ++i) {
-        m_data[i] = xx_vector[i];
-    }
+    std::copy(xx_vector.data(), xx_vector.data() + m_dim, m_data.get());
 }
 
-template<typename tpDataType>
-assignment::vector<tpDataType>::vector(vector && xx_vector) :
-                m_dim(std::move(xx_vector.m_dim)),
-                m_data(new tpDataType[m_dim])
+template<typename tpDataType, typename tpAllocatorType>
+assignment::vector<tpDataType, tpAllocatorType>::vector(vector && xx_vector) noexcept :
+                m_dim(xx_vector.m_dim),
+                m_data(std::move(xx_vector.m_data))
 {
-    m_data = std::move(xx_vector.m_data);
+    xx_vector.m_dim = 0;
 }
 
-/* ==== a  s  s  i  g  n  m  e  n  t     o  p  e  r  a  t  o  r  s ==== */
-
-template<typename tpDataType>
-vector<tpDataType> &
-assignment::vector<tpDataType>::operator=(vector const & xx_vector)
+template<typename tpDataType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, vector_kind, tpDataType>::value>::type*>
+assignment::vector<tpDataType, tpAllocatorType>::vector(tpExpression && xx_expression) :
+                vector(detail::materialize<vector>(std::forward<tpExpression>(xx_expression)))
 {
-    if (this == &xx_vector)
-        return *this;
-    
-    m_dim = xx_vector.m_dim;
-    m_data(new tpDataType[m_dim]);
-    std::copy(&xx_vector.m_data[0], &xx_vector.m_data[0] + m_dim, &m_data[0]);
 }
 
-template<typename tpDataType>
-vector<tpDataType> &
-assignment::vector<tpDataType>::operator=(vector && xx_vector)
+/* ==== a  s  s  i  g  n  m  e  n  t     o  p  e  r  a  t  o  r  s ==== */
+
+template<typename tpDataType, typename tpAllocatorType>
+vector<tpDataType, tpAllocatorType> &
+assignment::vector<tpDataType, tpAllocatorType>::operator=(vector const & xx_vector)
 {
     if (this == &xx_vector)
         return *this;
-    
-    m_dim = std::move(xx_vector.m_dim);
-    m_data(new tpDataType[m_dim]);
-    m_data = std::move(xx_vector.m_data);
-}
-
-/* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
-
-//variation
-template<typename tpDataType>
-vector<tpDataType> assignment::vector<tpDataType>::operator+(vector const & xx_vector)
-{
-    auto temp = *this;
-    for (size_type i = 0; i < xx_vector.m_dim; ++i)
-        temp.m_data[i] += xx_vector[i];
-
-    return temp;
-}
 
-template<typename tpDataType>
-vector<tpDataType> assignment::vector<tpDataType>::operator-(vector const & xx_vector)
-{
-    auto temp = *this;
-    for (size_type i = 0; i < xx_vector.m_dim; ++i)
-        temp.m_data[i] -= xx_vector[i];
-
-    return temp;
-}
-
-template<typename tpDataType>
-vector<tpDataType> assignment::vector<tpDataType>::operator*(vector const & xx_vector)
-{
-    auto temp = *this;
-    for (size_type i = 0; i < xx_vector.m_dim; ++i)
-        temp.m_data[i] *= xx_vector[i];
-    return temp;
+    // the storage is only replaced if the dimension changes
+    if (m_dim != xx_vector.m_dim) {
+        m_data = buffer<value_type, tpAllocatorType>(xx_vector.m_dim);
+        m_dim = xx_vector.m_dim;
+    }
+    std::copy(xx_vector.data(), xx_vector.data() + m_dim, m_data.get());
+    return *this;
 }
 
-template<typename tpDataType>
-vector<tpDataType> assignment::vector<tpDataType>::operator+(tpDataType const & xx_scalar)
+template<typename tpDataType, typename tpAllocatorType>
+vector<tpDataType, tpAllocatorType> &
+assignment::vector<tpDataType, tpAllocatorType>::operator=(vector && xx_vector) noexcept
 {
-    auto result = *this;
-    for (size_type i = 0; i < this->m_dim; ++i)
-        result.m_data[i] += xx_scalar;
+    if (this == &xx_vector)
+        return *this;
 
-    return result;
+    m_dim = xx_vector.m_dim;
+    m_data = std::move(xx_vector.m_data);
+    xx_vector.m_dim = 0;
+    return *this;
 }
 
-template<typename tpDataType>
-vector<tpDataType> assignment::vector<tpDataType>::operator-(tpDataType const & xx_scalar)
+template<typename tpDataType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::is_node_of<tpExpression, vector_kind, tpDataType>::value>::type*>
+vector<tpDataType, tpAllocatorType> &
+assignment::vector<tpDataType, tpAllocatorType>::operator=(tpExpression && xx_expression)
 {
-    auto result = *this;
-    for (size_type i = 0; i < this->m_dim; ++i)
-        result.m_data[i] -= xx_scalar;
+    if (detail::size(xx_expression) == m_dim && !detail::aliases(xx_expression, detail::layout_of(*this))) {
+        detail::evaluate(m_data.get(), xx_expression);
+        return *this;
+    }
 
-    return result;
+    // the expression may refer to this vector (Ex: a strided slice of it); evaluate before releasing the old storage
+    return (*this) = detail::materialize<vector>(std::forward<tpExpression>(xx_expression));
 }
 
-template<typename tpDataType>
-vector<tpDataType> assignment::vector<tpDataType>::operator*(tpDataType const xx_scalar)
-{
-    auto result = *this;
-    for (size_type i = 0; i < this->m_dim; ++i)
-        result.m_data[i] *= xx_scalar;
-    return result;
-}
+/* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
 
-template<typename tpDataType>
-vector<tpDataType> &
-assignment::vector<tpDataType>::operator+=(vector const & xx_vector)
+template<typename tpDataType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::are_compatible<vector<tpDataType, tpAllocatorType>, tpExpression>::value>::type*>
+vector<tpDataType, tpAllocatorType> &
+assignment::vector<tpDataType, tpAllocatorType>::operator+=(tpExpression const & xx_expression)
 {
-    for (size_type i = 0; i < m_dim; ++i) {
-        m_data[i] += xx_vector.m_data[i];
+    // a view on this vector in another layout is evaluated first
+    if constexpr (detail::has_view<tpExpression>::value) {
+        if (detail::aliases(xx_expression, detail::layout_of(*this))) {
+            vector const temp = xx_expression;
+            detail::evaluate(m_data.get(), (*this) + temp);
+            return (*this);
+        }
     }
-
+    detail::evaluate(m_data.get(), (*this) + xx_expression);
     return (*this);
 }
 
-template<typename tpDataType>
-vector<tpDataType> &
-assignment::vector<tpDataType>::operator-=(vector const & xx_vector)
+template<typename tpDataType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::are_compatible<vector<tpDataType, tpAllocatorType>, tpExpression>::value>::type*>
+vector<tpDataType, tpAllocatorType> &
+assignment::vector<tpDataType, tpAllocatorType>::operator-=(tpExpression const & xx_expression)
 {
-    for (size_type i = 0; i < m_dim; ++i) {
-        m_data[i] -= xx_vector.m_data[i];
+    // a view on this vector in another layout is evaluated first
+    if constexpr (detail::has_view<tpExpression>::value) {
+        if (detail::aliases(xx_expression, detail::layout_of(*this))) {
+            vector const temp = xx_expression;
+            detail::evaluate(m_data.get(), (*this) - temp);
+            return (*this);
+        }
     }
-
+    detail::evaluate(m_data.get(), (*this) - xx_expression);
     return (*this);
 }
 
-template<typename tpDataType>
-vector<tpDataType> &
-assignment::vector<tpDataType>::operator*=(vector const & xx_vector)
+template<typename tpDataType, typename tpAllocatorType>
+template<typename tpExpression, typename std::enable_if<detail::are_compatible<vector<tpDataType, tpAllocatorType>, tpExpression>::value>::type*>
+vector<tpDataType, tpAllocatorType> &
+assignment::vector<tpDataType, tpAllocatorType>::operator*=(tpExpression const & xx_expression)
 {
-    for (size_type i = 0; i < m_dim; ++i) {
-        m_data[i] *= xx_vector.m_data[i];
+    // a view on this vector in another layout is evaluated first
+    if constexpr (detail::has_view<tpExpression>::value) {
+        if (detail::aliases(xx_expression, detail::layout_of(*this))) {
+            vector const temp = xx_expression;
+            detail::evaluate(m_data.get(), (*this) * temp);
+            return (*this);
+        }
     }
-
+    detail::evaluate(m_data.get(), (*this) * xx_expression);
     return (*this);
 }
 
-template<typename tpDataType>
-template<typename T, typename std::enable_if<!std::is_integral<T>::value>::type*>
-vector<tpDataType> assignment::vector<tpDataType>::operator *(size_type const xx_scalar)
-{
-    auto result = *this;
-    for (size_type i = 0; i < m_dim; ++i) {
-        result.m_data[i] *= xx_scalar;
-    }
-
-    return result;
-}
-
-template<typename tpDataType>
+template<typename tpDataType, typename tpAllocatorType>
 tpDataType const &
-assignment::vector<tpDataType>::operator[](size_type const idx) const
+assignment::vector<tpDataType, tpAllocatorType>::operator[](size_type const idx) const
 {
     return m_data[idx];
 }
 
-template<typename tpDataType>
+template<typename tpDataType, typename tpAllocatorType>
 tpDataType &
-assignment::vector<tpDataType>::operator[](size_type const idx)
+assignment::vector<tpDataType, tpAllocatorType>::operator[](size_type const idx)
 {
     return m_data[idx];
 }
 
 /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s==== */
 
-template<typename tpDataType>
-size_t const assignment::vector<tpDataType>::dim() const
+template<typename tpDataType, typename tpAllocatorType>
+size_t const assignment::vector<tpDataType, tpAllocatorType>::dim() const
 {
     return m_dim;
 }
 
-template<typename tpDataType>
-void assignment::vector<tpDataType>::set(tpDataType const & xx_scalar)
+template<typename tpDataType, typename tpAllocatorType>
+void assignment::vector<tpDataType, tpAllocatorType>::set(tpDataType const & xx_scalar)
 {
     for (size_t i = 0; i < m_dim; ++i) {
         (*this)[i] = xx_scalar;
     }
-    return (*this);
+}
+
+template<typename tpDataType, typename tpAllocatorType>
+tpDataType const *
+assignment::vector<tpDataType, tpAllocatorType>::data() const
+{
+    return m_data.get();
+}
+
+template<typename tpDataType, typename tpAllocatorType>
+tpDataType *
+assignment::vector<tpDataType, tpAllocatorType>::data()
+{
+    return m_data.get();
+}
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! sum of xx_left[i] * xx_right[i]; not conjugated for complex elements
+ \throw std::domain_error if the dimensions differ
+ */
+template<typename tpDataType, typename tpLeftAllocator, typename tpRightAllocator>
+tpDataType dot(vector<tpDataType, tpLeftAllocator> const & xx_left, vector<tpDataType, tpRightAllocator> const & xx_right)
+{
+    if (xx_left.dim() != xx_right.dim())
+        throw std::domain_error("Vectors should have the same dimension");
+    tpDataType result = tpDataType(0);
+    tpDataType const * const left = xx_left.data();
+    detail::simd::dot<1>(&result, &left, xx_right.data(), xx_left.dim());
+    return result;
+}
+
+/*! xx_y += xx_alpha * xx_x in place
+ \note the loop has no branches, so the compiler vectorizes it.
+ \throw std::domain_error if the dimensions differ
+ */
+template<typename tpDataType, typename tpLeftAllocator, typename tpRightAllocator>
+void axpy(tpDataType const xx_alpha, vector<tpDataType, tpLeftAllocator> const & xx_x, vector<tpDataType, tpRightAllocator> & xx_y)
+{
+    if (xx_x.dim() != xx_y.dim())
+        throw std::domain_error("Vectors should have the same dimension");
+    tpDataType const * const x = xx_x.data();
+    tpDataType * const y = xx_y.data();
+    for (std::size_t i = 0; i < xx_y.dim(); ++i)
+        y[i] += xx_alpha * x[i];
+}
+
+/*! Euclidean norm of a vector of floating point elements
+ */
+template<typename tpDataType, typename tpAllocatorType>
+tpDataType norm(vector<tpDataType, tpAllocatorType> const & xx_vector)
+{
+    static_assert(std::is_floating_point<tpDataType>::value, "norm needs a floating point element type");
+    return std::sqrt(dot(xx_vector, xx_vector));
 }
 
 }
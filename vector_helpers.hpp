@@ -12,53 +12,41 @@ namespace assignment {
 
 /* ==== f  r  e  e     f  u  n  c  t  i  o  n  s==== */
 
-/*! left scalar multiply operator
+/*! left scalar multiply operator => lazy element-wise multiplication
 */
-template<typename tpDataType>
-vector<tpDataType> operator *(tpDataType const xx_scalar, vector<tpDataType> const & xx_vector)
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+scalar_expression<detail::simd::op::mul, detail::operand_t<tpExpression>> operator *(typename detail::traits<tpExpression>::value_type const & xx_scalar, tpExpression && xx_vector)
 {
-    auto result = xx_vector;
-    for (size_t i = 0; i < xx_vector.dim(); ++i) {
-        result[i] *= xx_scalar;
-    }
-    return result;
+    return {std::forward<tpExpression>(xx_vector), xx_scalar};
 }
 
 /*! left scalar multiply operator => disabled for integral-types
 */
-template<typename tpDataType, typename std::enable_if<!std::is_integral<tpDataType>::value>::type* = nullptr>
-vector<tpDataType> operator *(size_t const xx_scalar, vector<tpDataType> const & xx_vector)
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value
+                && !std::is_integral<typename detail::traits<tpExpression>::value_type>::value>::type* = nullptr>
+scalar_expression<detail::simd::op::mul, detail::operand_t<tpExpression>> operator *(size_t const xx_scalar, tpExpression && xx_vector)
 {
-    auto result = xx_vector;
-    for (size_t i = 0; i < xx_vector.dim(); ++i) {
-        result[i] *= xx_scalar;
-    }
-    return result;
+    return {std::forward<tpExpression>(xx_vector), static_cast<typename detail::traits<tpExpression>::value_type>(xx_scalar)};
 }
 
-/*! negation operator
+/*! negation operator => lazy
 */
-template<typename tpDataType>
-vector<tpDataType> operator -(vector<tpDataType> const & xx_vector)
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+negate_expression<detail::operand_t<tpExpression>> operator -(tpExpression && xx_vector)
 {
-    auto result = xx_vector;
-    for (size_t i = 0; i < result.dim(); ++i) {
-        result[i] = -xx_vector[i];
-    }
-
-    return result;
+    return negate_expression<detail::operand_t<tpExpression>>(std::forward<tpExpression>(xx_vector));
 }
 
-/*! output vector to std::cout
+/*! output vector or vector expression to std::cout
 */
-template<typename tpDataType>
-std::ostream& operator<<(std::ostream& os, assignment::vector<tpDataType> const & xx_vector)
+template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+std::ostream& operator<<(std::ostream& os, tpExpression const & xx_vector)
 {
     os << '[';
-    for (int i = 0; i < xx_vector.dim(); ++i) {
+    for (std::size_t i = 0; i < detail::size(xx_vector); ++i) {
         if (i > 0)
             os << " ,";
-        os << xx_vector[i];
+        os << detail::element_at(xx_vector, i);
     }
     os << ']';
     return os;
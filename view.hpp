@@ -0,0 +1,781 @@
+/*
+ //  view.hpp
+ //  Assignment
+ //
+ //  Created by Mohammed Afroze on 23.02.20.
+ */
+
+/*! This files contains the non-owning views on matrix and vector storage: submatrix blocks, rows, columns, diagonals and
+ strided slices. A view is described by a pointer to its first element and a stride per dimension, so taking one never
+ allocates nor copies. Views are leaves of the element-wise expressions and operands of the multiply policies.
+ \note a view does not keep its matrix or vector alive; it must not outlive the storage it refers to.
+ */
+#ifndef view_h
+#define view_h
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "expression.hpp"
+#include "matrix.hpp"
+#include "transpose.hpp"
+#include "vector.hpp"
+
+namespace assignment {
+
+template<typename tpDataType>
+class vector_view;
+
+template<typename tpDataType>
+class matrix_view;
+
+/*! non-owning view on xx_dim elements xx_stride apart
+ \tparam tpDataType element type; const for a read-only view
+ */
+template<typename tpDataType>
+class vector_view : public view_node {
+public:
+
+    /*! type for the elements of the vector
+     */
+    using value_type = typename std::remove_const<tpDataType>::type;
+
+    /*! type for the size of the vector
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor
+     \param xx_data first element
+     \param xx_dim number of elements
+     \param xx_stride distance between two consecutive elements
+     */
+    vector_view(tpDataType * xx_data, size_type const xx_dim, std::ptrdiff_t const xx_stride = 1) :
+                    m_data(xx_data),
+                    m_dim(xx_dim),
+                    m_stride(xx_stride)
+    {
+    }
+
+    vector_view(vector_view const &) = default;
+
+    /*! a mutable view converts to a read-only one
+     */
+    template<typename tpOther, typename std::enable_if<std::is_same<tpOther const, tpDataType>::value && !std::is_const<tpOther>::value>::type* = nullptr>
+    vector_view(vector_view<tpOther> const & xx_view) :
+                    m_data(xx_view.data()),
+                    m_dim(xx_view.dim()),
+                    m_stride(xx_view.stride())
+    {
+    }
+
+    /* ==== a  s  s  i  g  n  m  e  n  t     o  p  e  r  a  t  o  r  s ==== */
+
+    /*! copies the elements of xx_view into the viewed elements
+     \throw std::domain_error if the dimensions differ
+     */
+    vector_view & operator=(vector_view const & xx_view)
+    {
+        return assign(xx_view);
+    }
+
+    /*! evaluates a vector, view or vector expression into the viewed elements
+     \throw std::domain_error if the dimensions differ
+     */
+    template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+    vector_view & operator=(tpExpression const & xx_expression)
+    {
+        return assign(xx_expression);
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+    vector_view & operator+=(tpExpression const & xx_expression)
+    {
+        return assign((*this) + xx_expression);
+    }
+
+    template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, vector_kind>::value>::type* = nullptr>
+    vector_view & operator-=(tpExpression const & xx_expression)
+    {
+        return assign((*this) - xx_expression);
+    }
+
+    vector_view & operator*=(value_type const & xx_scalar)
+    {
+        return assign((*this) * xx_scalar);
+    }
+
+    tpDataType & operator[](size_type const xx_idx) const
+    {
+        return m_data[static_cast<std::ptrdiff_t>(xx_idx) * m_stride];
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! get dimension of the vector
+     */
+    size_type dim() const
+    {
+        return m_dim;
+    }
+
+    std::ptrdiff_t stride() const
+    {
+        return m_stride;
+    }
+
+    /*! pointer to the first element
+     */
+    tpDataType * data() const
+    {
+        return m_data;
+    }
+
+    /*! set all viewed elements to xx_value
+     */
+    void set(value_type const & xx_value) const
+    {
+        for (size_type i = 0; i < m_dim; ++i)
+            (*this)[i] = xx_value;
+    }
+
+    /*! view on xx_count elements, starting at xx_begin and xx_step elements apart
+     \throw std::domain_error if the slice does not fit into the view
+     */
+    vector_view slice(size_type const xx_begin, size_type const xx_count, size_type const xx_step = 1) const
+    {
+        if (xx_step == 0 || (xx_count > 0 && (xx_begin >= m_dim || (xx_count - 1) > (m_dim - 1 - xx_begin) / xx_step)))
+            throw std::domain_error("Slice exceeds the vector dimension");
+        return vector_view(m_data + static_cast<std::ptrdiff_t>(xx_begin) * m_stride, xx_count, m_stride * static_cast<std::ptrdiff_t>(xx_step));
+    }
+
+    /* ==== e  x  p  r  e  s  s  i  o  n     l  e  a  f ==== */
+
+    value_type const & at(size_type const xx_idx) const
+    {
+        return (*this)[xx_idx];
+    }
+
+    /*! pointer to the elements xx_first ... if they are adjacent in memory, nullptr otherwise
+     */
+    value_type const * contiguous(size_type const xx_first, size_type) const
+    {
+        return m_stride == 1 ? m_data + xx_first : nullptr;
+    }
+
+    void gather(value_type * xx_out, size_type const xx_first, size_type const xx_n) const
+    {
+        for (size_type i = 0; i < xx_n; ++i)
+            xx_out[i] = (*this)[xx_first + i];
+    }
+
+    void copy_to(value_type * xx_out) const
+    {
+        gather(xx_out, 0, m_dim);
+    }
+
+    /*! strides and address range of the viewed elements
+     */
+    detail::layout<value_type> layout() const
+    {
+        if (m_dim == 0)
+            return {m_data, m_stride, 0, nullptr, nullptr};
+        value_type const * const last = &(*this)[m_dim - 1];
+        return {m_data, m_stride, 0, m_stride < 0 ? last : m_data, m_stride < 0 ? m_data : last};
+    }
+
+private:
+
+    template<typename tpExpression>
+    vector_view & assign(tpExpression const & xx_expression)
+    {
+        static_assert(!std::is_const<tpDataType>::value, "cannot assign through a read-only view");
+        if (detail::size(xx_expression) != m_dim)
+            throw std::domain_error("Vectors should have same dimension");
+
+        // the operands share storage with the viewed elements in another layout; evaluate them first
+        if (detail::aliases(xx_expression, layout())) {
+            typename detail::traits<tpExpression>::result_type const temp = xx_expression;
+            for (size_type i = 0; i < m_dim; ++i)
+                (*this)[i] = temp[i];
+        } else if (m_stride == 1) {
+            detail::evaluate(m_data, xx_expression);
+        } else {
+            for (size_type i = 0; i < m_dim; ++i)
+                (*this)[i] = detail::element_at(xx_expression, i);
+        }
+        return *this;
+    }
+
+    tpDataType * m_data;
+    size_type m_dim;
+    std::ptrdiff_t m_stride;
+};
+
+/*! non-owning view on an xx_dimR x xx_dimC block of row-major storage
+ \tparam tpDataType element type; const for a read-only view
+ \note element (R, C) is at data()[R * row_stride() + C * col_stride()].
+ */
+template<typename tpDataType>
+class matrix_view : public view_node {
+public:
+
+    /*! type for the elements of the matrix
+     */
+    using value_type = typename std::remove_const<tpDataType>::type;
+
+    /*! type for the size of the matrix
+     */
+    using size_type = std::size_t;
+
+    /* ==== c  o  n  s  t  r  u  c  t  o  r  s ==== */
+
+    /*! constructor
+     \param xx_data element (0, 0)
+     \param xx_dimR row dimension of the view
+     \param xx_dimC column dimension of the view
+     \param xx_rs distance between two consecutive rows
+     \param xx_cs distance between two consecutive columns
+     */
+    matrix_view(tpDataType * xx_data, size_type const xx_dimR, size_type const xx_dimC, std::ptrdiff_t const xx_rs, std::ptrdiff_t const xx_cs = 1) :
+                    m_data(xx_data),
+                    m_dimR(xx_dimR),
+                    m_dimC(xx_dimC),
+                    m_rs(xx_rs),
+                    m_cs(xx_cs)
+    {
+    }
+
+    matrix_view(matrix_view const &) = default;
+
+    /*! a mutable view converts to a read-only one
+     */
+    template<typename tpOther, typename std::enable_if<std::is_same<tpOther const, tpDataType>::value && !std::is_const<tpOther>::value>::type* = nullptr>
+    matrix_view(matrix_view<tpOther> const & xx_view) :
+                    m_data(xx_view.data()),
+                    m_dimR(xx_view.dimR()),
+                    m_dimC(xx_view.dimC()),
+                    m_rs(xx_view.row_stride()),
+                    m_cs(xx_view.col_stride())
+    {
+    }
+
+    /* ==== a  s  s  i  g  n  m  e  n  t     o  p  e  r  a  t  o  r  s ==== */
+
+    /*! copies the elements of xx_view into the viewed elements
+     \throw std::domain_error if the dimensions differ
+     */
+    matrix_view & operator=(matrix_view const & xx_view)
+    {
+        return assign(xx_view);
+    }
+
+    /*! evaluates a matrix, view or matrix expression into the viewed elements
+     \throw std::domain_error if the dimensions differ
+     */
+    template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+    matrix_view & operator=(tpExpression const & xx_expression)
+    {
+        return assign(xx_expression);
+    }
+
+    /* ==== o  p  e  r  a  t  o  r     o  v  e  r  l  o  a  d  i  n  g ==== */
+
+    /*! +=operator overload with a matrix, view or matrix expression
+     * \throw std::domain_error if the dimensions differ from (*this) view
+     */
+    template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+    matrix_view & operator+=(tpExpression const & xx_expression)
+    {
+        return assign((*this) + xx_expression);
+    }
+
+    /*! -=operator overload with a matrix, view or matrix expression
+     * \throw std::domain_error if the dimensions differ from (*this) view
+     */
+    template<typename tpExpression, typename std::enable_if<detail::is_kind<tpExpression, matrix_kind>::value>::type* = nullptr>
+    matrix_view & operator-=(tpExpression const & xx_expression)
+    {
+        return assign((*this) - xx_expression);
+    }
+
+    matrix_view & operator*=(value_type const & xx_scalar)
+    {
+        return assign((*this) * xx_scalar);
+    }
+
+    /*! ()operator overload for indexing
+     * \note No error checking is done; upto the used to use proper indexing
+     */
+    tpDataType & operator()(size_type const dimR, size_type const dimC) const
+    {
+        return m_data[static_cast<std::ptrdiff_t>(dimR) * m_rs + static_cast<std::ptrdiff_t>(dimC) * m_cs];
+    }
+
+    /* ==== h  e  l  p  e  r     f  u  n  c  t  i  o  n  s ==== */
+
+    /*! Get the row dimension of the view
+     */
+    size_type dimR() const
+    {
+        return m_dimR;
+    }
+
+    /*! Get the coloumn dimension of the view
+     */
+    size_type dimC() const
+    {
+        return m_dimC;
+    }
+
+    std::ptrdiff_t row_stride() const
+    {
+        return m_rs;
+    }
+
+    std::ptrdiff_t col_stride() const
+    {
+        return m_cs;
+    }
+
+    /*! pointer to element (0, 0)
+     */
+    tpDataType * data() const
+    {
+        return m_data;
+    }
+
+    /*! set all viewed elements to xx_value
+     */
+    void set(value_type const & xx_value) const
+    {
+        for (size_type R = 0; R < m_dimR; ++R) {
+            for (size_type C = 0; C < m_dimC; ++C) {
+                (*this)(R, C) = xx_value;
+            }
+        }
+    }
+
+    /*! view on the xx_dimR x xx_dimC block starting at element (xx_R, xx_C)
+     \throw std::domain_error if the block does not fit into the view
+     */
+    matrix_view block(size_type const xx_R, size_type const xx_C, size_type const xx_dimR, size_type const xx_dimC) const
+    {
+        return slice(xx_R, xx_C, xx_dimR, xx_dimC, 1, 1);
+    }
+
+    /*! view on xx_dimR x xx_dimC elements starting at (xx_R, xx_C), taking every xx_stepR-th row and every xx_stepC-th column
+     \throw std::domain_error if the slice does not fit into the view
+     */
+    matrix_view slice(size_type const xx_R, size_type const xx_C, size_type const xx_dimR, size_type const xx_dimC,
+                      size_type const xx_stepR, size_type const xx_stepC) const
+    {
+        if (!fits(xx_R, xx_dimR, xx_stepR, m_dimR) || !fits(xx_C, xx_dimC, xx_stepC, m_dimC))
+            throw std::domain_error("Block exceeds the matrix dimensions");
+        return matrix_view(xx_dimR > 0 && xx_dimC > 0 ? &(*this)(xx_R, xx_C) : m_data, xx_dimR, xx_dimC,
+                           m_rs * static_cast<std::ptrdiff_t>(xx_stepR), m_cs * static_cast<std::ptrdiff_t>(xx_stepC));
+    }
+
+    /*! view on row xx_R
+     \throw std::domain_error if xx_R is out of range
+     */
+    vector_view<tpDataType> row(size_type const xx_R) const
+    {
+        if (xx_R >= m_dimR)
+            throw std::domain_error("Row index exceeds the matrix dimensions");
+        return vector_view<tpDataType>(m_data + static_cast<std::ptrdiff_t>(xx_R) * m_rs, m_dimC, m_cs);
+    }
+
+    /*! view on column xx_C
+     \throw std::domain_error if xx_C is out of range
+     */
+    vector_view<tpDataType> col(size_type const xx_C) const
+    {
+        if (xx_C >= m_dimC)
+            throw std::domain_error("Column index exceeds the matrix dimensions");
+        return vector_view<tpDataType>(m_data + static_cast<std::ptrdiff_t>(xx_C) * m_cs, m_dimR, m_rs);
+    }
+
+    /*! transposed view: element (R, C) of the result is element (C, R) of (*this)
+     \note nothing is copied; the multiply policies pack a transposed operand directly from its storage.
+     */
+    matrix_view transpose() const
+    {
+        return matrix_view(m_data, m_dimC, m_dimR, m_cs, m_rs);
+    }
+
+    /*! view on the main diagonal (xx_offset = 0), a super-diagonal (xx_offset > 0) or a sub-diagonal (xx_offset < 0)
+     */
+    vector_view<tpDataType> diagonal(std::ptrdiff_t const xx_offset = 0) const
+    {
+        size_type const R = xx_offset < 0 ? static_cast<size_type>(-xx_offset) : 0;
+        size_type const C = xx_offset > 0 ? static_cast<size_type>(xx_offset) : 0;
+        size_type const dim = (R < m_dimR && C < m_dimC) ? std::min(m_dimR - R, m_dimC - C) : 0;
+        return vector_view<tpDataType>(dim > 0 ? &(*this)(R, C) : m_data, dim, m_rs + m_cs);
+    }
+
+    /* ==== e  x  p  r  e  s  s  i  o  n     l  e  a  f ==== */
+
+    /*! element xx_idx in row-major order
+     */
+    value_type const & at(size_type const xx_idx) const
+    {
+        return (*this)(xx_idx / m_dimC, xx_idx % m_dimC);
+    }
+
+    /*! pointer to the elements xx_first ... xx_first + xx_n - 1 in row-major order if they are adjacent in memory, nullptr otherwise
+     */
+    value_type const * contiguous(size_type const xx_first, size_type const xx_n) const
+    {
+        if (m_cs != 1 || xx_n == 0)
+            return m_cs == 1 ? m_data : nullptr;
+        size_type const R = xx_first / m_dimC;
+        size_type const C = xx_first % m_dimC;
+        if (C + xx_n <= m_dimC || m_rs == static_cast<std::ptrdiff_t>(m_dimC))
+            return &(*this)(R, C);
+        return nullptr;
+    }
+
+    /*! writes all elements in row-major order to xx_out
+     \note a cache-oblivious copy, so a transposed or column view is copied out without striding through memory row by row.
+     */
+    void copy_to(value_type * xx_out) const
+    {
+        detail::strided_copy(m_dimR, m_dimC, static_cast<value_type const *>(m_data), m_rs, m_cs, xx_out, static_cast<std::ptrdiff_t>(m_dimC), 1);
+    }
+
+    /*! writes the elements xx_first ... xx_first + xx_n - 1 in row-major order to xx_out
+     */
+    void gather(value_type * xx_out, size_type const xx_first, size_type const xx_n) const
+    {
+        size_type R = xx_n > 0 ? xx_first / m_dimC : 0;
+        size_type C = xx_n > 0 ? xx_first % m_dimC : 0;
+        for (size_type i = 0; i < xx_n; ++i) {
+            xx_out[i] = (*this)(R, C);
+            if (++C == m_dimC) {
+                C = 0;
+                ++R;
+            }
+        }
+    }
+
+    /*! strides and address range of the viewed elements
+     */
+    detail::layout<value_type> layout() const
+    {
+        if (m_dimR == 0 || m_dimC == 0)
+            return {m_data, m_rs, m_cs, nullptr, nullptr};
+        std::ptrdiff_t const spanR = static_cast<std::ptrdiff_t>(m_dimR - 1) * m_rs;
+        std::ptrdiff_t const spanC = static_cast<std::ptrdiff_t>(m_dimC - 1) * m_cs;
+        return {m_data, m_rs, m_cs, m_data + std::min<std::ptrdiff_t>(spanR, 0) + std::min<std::ptrdiff_t>(spanC, 0),
+                m_data + std::max<std::ptrdiff_t>(spanR, 0) + std::max<std::ptrdiff_t>(spanC, 0)};
+    }
+
+private:
+
+    static bool fits(size_type const xx_begin, size_type const xx_count, size_type const xx_step, size_type const xx_dim)
+    {
+        if (xx_step == 0)
+            return false;
+        return xx_count == 0 || (xx_begin < xx_dim && (xx_count - 1) <= (xx_dim - 1 - xx_begin) / xx_step);
+    }
+
+    template<typename tpExpression>
+    matrix_view & assign(tpExpression const & xx_expression)
+    {
+        static_assert(!std::is_const<tpDataType>::value, "cannot assign through a read-only view");
+        if (xx_expression.dimR() != m_dimR || xx_expression.dimC() != m_dimC)
+            throw std::domain_error("Matrices should have same dimension");
+
+        // the operands share storage with the viewed elements in another layout; evaluate them first
+        if (detail::aliases(xx_expression, layout())) {
+            typename detail::traits<tpExpression>::result_type const temp = xx_expression;
+            for (size_type R = 0; R < m_dimR; ++R) {
+                for (size_type C = 0; C < m_dimC; ++C) {
+                    (*this)(R, C) = temp(R, C);
+                }
+            }
+        } else if (m_cs == 1) {
+            for (size_type R = 0; R < m_dimR; ++R)
+                detail::evaluate_range(&(*this)(R, 0), xx_expression, R * m_dimC, m_dimC);
+        } else {
+            buffer<value_type> row(m_dimC);
+            for (size_type R = 0; R < m_dimR; ++R) {
+                detail::evaluate_range(row.get(), xx_expression, R * m_dimC, m_dimC);
+                for (size_type C = 0; C < m_dimC; ++C)
+                    (*this)(R, C) = row[C];
+            }
+        }
+        return *this;
+    }
+
+    tpDataType * m_data;
+    size_type m_dimR;
+    size_type m_dimC;
+    std::ptrdiff_t m_rs;
+    std::ptrdiff_t m_cs;
+};
+
+/*! matrix views are leaves of matrix expressions
+ */
+template<typename tpDataType>
+struct expression_traits<matrix_view<tpDataType>> {
+    static constexpr bool is_expression = true;
+    static constexpr bool is_leaf = true;
+    using kind = matrix_kind;
+    using value_type = typename std::remove_const<tpDataType>::type;
+    using result_type = matrix<value_type>;
+
+    static std::size_t size(matrix_view<tpDataType> const & xx_view)
+    {
+        return xx_view.dimR() * xx_view.dimC();
+    }
+};
+
+/*! vector views are leaves of vector expressions
+ */
+template<typename tpDataType>
+struct expression_traits<vector_view<tpDataType>> {
+    static constexpr bool is_expression = true;
+    static constexpr bool is_leaf = true;
+    using kind = vector_kind;
+    using value_type = typename std::remove_const<tpDataType>::type;
+    using result_type = vector<value_type>;
+
+    static std::size_t size(vector_view<tpDataType> const & xx_view)
+    {
+        return xx_view.dim();
+    }
+};
+
+/* ==== f  r  e  e     f  u  n  c  t  i  o  n  s ==== */
+
+/*! view on the whole matrix
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix_view<tpDataType> view(matrix<tpDataType, tpPolicyType, tpAllocatorType> & xx_matrix)
+{
+    return matrix_view<tpDataType>(xx_matrix.data(), xx_matrix.dimR(), xx_matrix.dimC(), static_cast<std::ptrdiff_t>(xx_matrix.dimC()));
+}
+
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+matrix_view<tpDataType const> view(matrix<tpDataType, tpPolicyType, tpAllocatorType> const & xx_matrix)
+{
+    return matrix_view<tpDataType const>(xx_matrix.data(), xx_matrix.dimR(), xx_matrix.dimC(), static_cast<std::ptrdiff_t>(xx_matrix.dimC()));
+}
+
+/*! view on the whole vector
+ */
+template<typename tpDataType, typename tpAllocatorType>
+vector_view<tpDataType> view(vector<tpDataType, tpAllocatorType> & xx_vector)
+{
+    return vector_view<tpDataType>(xx_vector.data(), xx_vector.dim());
+}
+
+template<typename tpDataType, typename tpAllocatorType>
+vector_view<tpDataType const> view(vector<tpDataType, tpAllocatorType> const & xx_vector)
+{
+    return vector_view<tpDataType const>(xx_vector.data(), xx_vector.dim());
+}
+
+/*! views are views on themselves
+ */
+template<typename tpDataType>
+matrix_view<tpDataType> view(matrix_view<tpDataType> const & xx_view)
+{
+    return xx_view;
+}
+
+template<typename tpDataType>
+vector_view<tpDataType> view(vector_view<tpDataType> const & xx_view)
+{
+    return xx_view;
+}
+
+/*! no views on temporaries; they would dangle
+ */
+template<typename tpDataType, template<typename > class tpPolicyType, typename tpAllocatorType>
+void view(matrix<tpDataType, tpPolicyType, tpAllocatorType> &&) = delete;
+
+template<typename tpDataType, typename tpAllocatorType>
+void view(vector<tpDataType, tpAllocatorType> &&) = delete;
+
+/*! view on the xx_dimR x xx_dimC block of a matrix or view starting at element (xx_R, xx_C)
+ \throw std::domain_error if the block does not fit into the matrix
+ */
+template<typename tpMatrix>
+auto block(tpMatrix && xx_matrix, std::size_t const xx_R, std::size_t const xx_C, std::size_t const xx_dimR, std::size_t const xx_dimC)
+{
+    return view(std::forward<tpMatrix>(xx_matrix)).block(xx_R, xx_C, xx_dimR, xx_dimC);
+}
+
+/*! view on row xx_R of a matrix or view
+ \throw std::domain_error if xx_R is out of range
+ */
+template<typename tpMatrix>
+auto row(tpMatrix && xx_matrix, std::size_t const xx_R)
+{
+    return view(std::forward<tpMatrix>(xx_matrix)).row(xx_R);
+}
+
+/*! view on column xx_C of a matrix or view
+ \throw std::domain_error if xx_C is out of range
+ */
+template<typename tpMatrix>
+auto col(tpMatrix && xx_matrix, std::size_t const xx_C)
+{
+    return view(std::forward<tpMatrix>(xx_matrix)).col(xx_C);
+}
+
+/*! view on a diagonal of a matrix or view; see matrix_view::diagonal
+ */
+template<typename tpMatrix>
+auto diagonal(tpMatrix && xx_matrix, std::ptrdiff_t const xx_offset = 0)
+{
+    return view(std::forward<tpMatrix>(xx_matrix)).diagonal(xx_offset);
+}
+
+/*! lazy transpose of a matrix or view; see matrix_view::transpose
+ \note Ex: matrix<double> gram = transpose(A) * A; multiplies straight from the storage of A without forming its transpose.
+ */
+template<typename tpMatrix>
+auto transpose(tpMatrix && xx_matrix)
+{
+    return view(std::forward<tpMatrix>(xx_matrix)).transpose();
+}
+
+/*! transposes a square matrix or view in place
+ \throw std::domain_error if the matrix is not square
+ */
+template<typename tpMatrix>
+void transpose_in_place(tpMatrix && xx_matrix)
+{
+    auto const target = view(xx_matrix);
+    if (target.dimR() != target.dimC())
+        throw std::domain_error("In-place transpose needs a square matrix");
+
+    if (target.col_stride() == 1) {
+        detail::transpose_square(target.dimR(), target.data(), target.row_stride());
+    } else {
+        for (std::size_t R = 0; R < target.dimR(); ++R) {
+            for (std::size_t C = R + 1; C < target.dimC(); ++C) {
+                std::swap(target(R, C), target(C, R));
+            }
+        }
+    }
+}
+
+/*! strided view on a vector or vector view: xx_count elements starting at xx_begin and xx_step elements apart
+ \throw std::domain_error if the slice does not fit into the vector
+ */
+template<typename tpVector>
+auto slice(tpVector && xx_vector, std::size_t const xx_begin, std::size_t const xx_count, std::size_t const xx_step = 1)
+{
+    return view(std::forward<tpVector>(xx_vector)).slice(xx_begin, xx_count, xx_step);
+}
+
+/*! strided view on a matrix or matrix view, see matrix_view::slice
+ \throw std::domain_error if the slice does not fit into the matrix
+ */
+template<typename tpMatrix>
+auto slice(tpMatrix && xx_matrix, std::size_t const xx_R, std::size_t const xx_C, std::size_t const xx_dimR, std::size_t const xx_dimC,
+           std::size_t const xx_stepR, std::size_t const xx_stepC)
+{
+    return view(std::forward<tpMatrix>(xx_matrix)).slice(xx_R, xx_C, xx_dimR, xx_dimC, xx_stepR, xx_stepC);
+}
+
+/*! policy matrix multiplication on views: xx_result = xx_left * xx_right
+ \tparam tpPolicyType policy used for matrix multiplication
+ \throw std::domain_error if the dimensions do not match
+ \note a result view with unit column stride that shares no storage with the operands is written directly, without any temporary.
+ */
+template<template<typename > class tpPolicyType = NonParallel, typename tpDataType>
+void multiply(matrix_view<tpDataType> xx_result, matrix_view<typename std::add_const<tpDataType>::type> const & xx_left,
+              matrix_view<typename std::add_const<tpDataType>::type> const & xx_right)
+{
+    if (xx_left.dimC() != xx_right.dimR())
+        throw std::domain_error("Number of columns_A != Number of rows_B");
+    if (xx_result.dimR() != xx_left.dimR() || xx_result.dimC() != xx_right.dimC())
+        throw std::domain_error("Result dimensions do not match the product");
+
+    using policy = tpPolicyType<matrix<tpDataType, tpPolicyType>>;
+
+    bool const aliased = detail::overlaps(xx_result.layout(), xx_left.layout()) || detail::overlaps(xx_result.layout(), xx_right.layout());
+
+    if (xx_result.col_stride() == 1 && !aliased) {
+        policy::multiply(xx_left.dimR(), xx_right.dimC(), xx_left.dimC(),
+                         xx_left.data(), xx_left.row_stride(), xx_left.col_stride(),
+                         xx_right.data(), xx_right.row_stride(), xx_right.col_stride(),
+                         xx_result.data(), xx_result.row_stride());
+        return;
+    }
+
+    matrix<tpDataType, tpPolicyType> temp(xx_result.dimR(), xx_result.dimC());
+    policy::multiply(xx_left.dimR(), xx_right.dimC(), xx_left.dimC(),
+                     xx_left.data(), xx_left.row_stride(), xx_left.col_stride(),
+                     xx_right.data(), xx_right.row_stride(), xx_right.col_stride(),
+                     temp.data(), static_cast<std::ptrdiff_t>(temp.dimC()));
+    xx_result = temp;
+}
+
+/*! *operator overload => Policy Matrix multiplication where an operand is a view
+ \note the policy and allocator of a matrix operand are used for the result; two views give a matrix with the default policy.
+ \throw std::domain_error if Number of columns_A != Number of rows_B
+ */
+template<typename tpLeft, typename tpRight, typename std::enable_if<detail::are_compatible<tpLeft, tpRight>::value
+                && detail::is_kind<tpLeft, matrix_kind>::value && (detail::is_view<tpLeft>::value || detail::is_view<tpRight>::value)
+                && !detail::is_node<tpLeft>::value && !detail::is_node<tpRight>::value>::type* = nullptr>
+typename std::conditional<detail::is_view<tpLeft>::value, typename detail::traits<tpRight>::result_type, typename detail::traits<tpLeft>::result_type>::type
+operator*(tpLeft const & xx_left, tpRight const & xx_right)
+{
+    using result_type = typename std::conditional<detail::is_view<tpLeft>::value, typename detail::traits<tpRight>::result_type,
+                    typename detail::traits<tpLeft>::result_type>::type;
+    using value_type = typename result_type::value_type;
+
+    matrix_view<value_type const> const left = view(xx_left);
+    matrix_view<value_type const> const right = view(xx_right);
+    if (left.dimC() != right.dimR())
+        throw std::domain_error("Number of columns_A != Number of rows_B");
+
+    result_type result(left.dimR(), right.dimC());
+    result_type::policy_type::multiply(left.dimR(), right.dimC(), left.dimC(),
+                                       left.data(), left.row_stride(), left.col_stride(),
+                                       right.data(), right.row_stride(), right.col_stride(),
+                                       result.data(), static_cast<std::ptrdiff_t>(result.dimC()));
+    return result;
+}
+
+/*! *operator overload => Policy Matrix-vector multiplication where the matrix or the vector is a view
+ \note nothing is copied; the policy reads both operands through their strides. The policy of a matrix operand is used, the
+ allocator of a vector operand for the result.
+ \throw std::domain_error if Number of columns_A != dimension of the vector
+ */
+template<typename tpLeft, typename tpRight, typename std::enable_if<detail::is_kind<tpLeft, matrix_kind>::value && detail::is_kind<tpRight, vector_kind>::value
+                && std::is_same<typename detail::traits<tpLeft>::value_type, typename detail::traits<tpRight>::value_type>::value
+                && (detail::is_view<tpLeft>::value || detail::is_view<tpRight>::value)
+                && !detail::is_node<tpLeft>::value && !detail::is_node<tpRight>::value>::type* = nullptr>
+typename detail::traits<tpRight>::result_type operator*(tpLeft const & xx_left, tpRight const & xx_right)
+{
+    using result_type = typename detail::traits<tpRight>::result_type;
+    using value_type = typename result_type::value_type;
+
+    matrix_view<value_type const> const left = view(xx_left);
+    vector_view<value_type const> const right = view(xx_right);
+    if (left.dimC() != right.dim())
+        throw std::domain_error("Number of columns_A != dimension of vector");
+
+    result_type result(left.dimR());
+    detail::traits<tpLeft>::result_type::policy_type::vector_multiply(left.dimR(), left.dimC(), left.data(), left.row_stride(), left.col_stride(),
+                                                                       right.data(), right.stride(), result.data());
+    return result;
+}
+
+}
+
+#endif /* view_h */